@@ -3,6 +3,7 @@
 
 #include <vector>
 #include <stdexcept>
+#include <utility>
 
 /// Stack ::= used for running interpreter for storing objects
 template <typename T>
@@ -25,7 +26,7 @@ public:
         if (Empty()) {
             throw std::runtime_error("fatal: stack was empty");
         }
-        auto V = container_.back();
+        auto V = std::move(container_.back());
         container_.pop_back();
         return V;
     }
@@ -52,6 +53,11 @@ public:
         return container_[idx];
     }
 
+    T *data()
+    {
+        return container_.data();
+    }
+
     void push_back(const T &t)
     {
         container_.push_back(t);
@@ -98,6 +104,11 @@ public:
     {
         container_.resize(sz);
     }
+
+    void reserve(size_type sz)
+    {
+        container_.reserve(sz);
+    }
 private:
     base container_;
 };
@@ -3,6 +3,7 @@
 #include "object/jsstring.h"
 #include "object/function.h"
 #include "object/array.h"
+#include "object/typed-array.h"
 #include <memory>
 #include <functional>
 #include <boost/asio.hpp>
@@ -26,6 +27,7 @@ void ContextStatic::Init()
     grok::obj::JSString::Init();
     grok::obj::Function::Init();
     grok::obj::JSArray::Init();
+    grok::obj::TypedArray::Init();
 }
 
 void ContextStatic::Teardown()
@@ -48,6 +50,12 @@ void InitializeContext()
     O->AddOption("file,f", "interprete files",
         BPO::value<std::vector<std::string>>()->composing());
     O->AddOption("profile", "show profiling information while executing");
+    O->AddOption("gc-stats", "print the statistics of garbage collector");
+    O->AddOption("dispatch", "interpreter loop to use (switch|threaded)",
+        BPO::value<std::string>()->default_value("threaded"));
+    O->AddOption("jit-threshold", "calls after which a function is compiled "
+        "to machine code (0 disables the JIT)",
+        BPO::value<size_t>()->default_value(100));
     O->AddPositionalOption("file", -1);
     GetContext()->SetIOServiceObject();
 }
@@ -72,6 +80,16 @@ void Context::ParseCommandLineOptions(int argc, char **argv)
     ast_ = options.HasOption("debug-ast");
     file_ = options.HasOption("file");
     profile_ = options.HasOption("profile");
+    gc_stats_ = options.HasOption("gc-stats");
+
+    auto dispatch = options.GetOptionAs<std::string>("dispatch");
+    if (dispatch != "switch" && dispatch != "threaded") {
+        std::cerr << "unknown dispatch '" << dispatch << "', expected "
+            "switch or threaded. See -h for usage." << std::endl;
+        exit(-1);
+    }
+    threaded_ = dispatch == "threaded";
+    jit_threshold_ = options.GetOptionAs<size_t>("jit-threshold");
 
     if (file_) {
         files_ = options.GetOptionAs<std::vector<std::string>>("file");
@@ -17,7 +17,9 @@ class Context {
 public:
     Context(std::ostream &os) :
         interactive_{ true }, debug_instruction_{ true },
-        debug_execution_{ true }, file_{ false }, ast_{true}, os{ os },
+        debug_execution_{ true }, file_{ false }, ast_{true},
+        gc_stats_{ false }, threaded_{ true }, jit_threshold_{ 100 },
+        os{ os },
         io_ { },
         work_ { }
     { }
@@ -41,6 +43,9 @@ public:
 
     bool ShouldPrintLastInStack() const { return last_in_stack_; }
     bool DoProfile() const { return profile_; }
+    bool PrintGCStats() const { return gc_stats_; }
+    bool ThreadedDispatch() const { return threaded_; }
+    size_t JitThreshold() const { return jit_threshold_; }
     
     decltype(auto) GetFiles() { return files_; }
     void SetInputFiles(std::vector<std::string> files)
@@ -84,6 +89,9 @@ private:
     bool dry_run_;
     bool last_in_stack_;
     bool profile_;
+    bool gc_stats_; // print statistics of garbage collector
+    bool threaded_; // use threaded dispatch if it was built
+    size_t jit_threshold_; // calls before a function is compiled
     std::ostream &os; // output stream used for printing and debugging
     Opts options;
 
@@ -4,10 +4,13 @@
 #include "input/input-stream.h"
 #include "input/readline.h"
 #include "lexer/lexer.h"
+#include "object/gc.h"
 #include "object/jsbasicobject.h"
 #include "parser/parser.h"
 #include "vm/codegen.h"
 #include "vm/context.h"
+#include "vm/inline-cache.h"
+#include "vm/instruction-builder.h"
 #include "vm/instruction-list.h"
 #include "vm/printer.h"
 #include "vm/vm.h"
@@ -60,15 +63,28 @@ int ExecuteAST(Context *ctx, std::ostream &os, std::shared_ptr<Expression> AST)
             Printer P{ os };
             P.Print(IR);
         }
-        if (ctx->DryRun())
+        if (ctx->DryRun()) {
+            if (ctx->DebugInstruction())
+                PrintFusionStats(os);
             return 0;
+        }
         auto TheVM = grok::vm::CreateVM(grok::vm::GetGlobalVMContext());
-        TheVM->SetCounters(IR->begin(), IR->end());
+        auto Code = Assemble(*IR);
+        TheVM->SetCounters(Code->begin(), Code->end());
 
         auto vms = std::chrono::high_resolution_clock::now();
         TheVM->Run();
         auto vme = std::chrono::high_resolution_clock::now();
 
+        // functions are compiled when they are called for the first time
+        if (ctx->DebugInstruction())
+            PrintFusionStats(os);
+
+        if (ctx->PrintGCStats()) {
+            grok::obj::Heap::PrintStats(os);
+            grok::obj::ObjectPool::PrintStats(os);
+        }
+
         Value Result = TheVM->GetResult();
         auto O = GetObjectPointer<grok::obj::JSObject>(Result);
 
@@ -84,6 +100,7 @@ int ExecuteAST(Context *ctx, std::ostream &os, std::shared_ptr<Expression> AST)
             os << " ] [ Execution took around ";
             log_progress(vme - vms);
             os << " ]" << Color::Reset() << std::endl;
+            PrintInlineCacheStats(os);
         }
     } catch (std::exception &e) {
         if (TheVM)
@@ -8,17 +8,7 @@ using namespace grok::obj;
 
 std::string JoinJSArray(std::shared_ptr<JSArray> Arr, std::string Sep)
 {
-    std::string res;
-    if (Arr->Size() == 0)
-        return res;
-    for (auto it = Arr->begin(); it != Arr->end() - 1; ++it) {
-        auto obj = (*it)->as<JSObject>();
-        res += obj->ToString();
-        res += Sep;
-    }
-
-    res += (*(Arr->end() - 1))->as<JSObject>()->ToString();
-    return res;
+    return Arr->Join(Sep);
 }
 
 std::shared_ptr<Object> ArrayJoin(std::shared_ptr<Argument> Args)
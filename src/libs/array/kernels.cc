@@ -0,0 +1,327 @@
+#include "libs/array/kernels.h"
+
+#include <algorithm>
+#include <limits>
+
+#ifdef GROK_SIMD
+#include <immintrin.h>
+#endif
+
+namespace grok {
+namespace libs {
+
+namespace {
+
+constexpr double inf = std::numeric_limits<double>::infinity();
+constexpr double nan = std::numeric_limits<double>::quiet_NaN();
+
+// the scalar kernels also finish the elements left over by the vector
+// ones
+
+double SumScalar(const double *x, size_t n)
+{
+    double sum = 0;
+    for (size_t i = 0; i < n; i++)
+        sum += x[i];
+    return sum;
+}
+
+double MinScalar(const double *x, size_t n)
+{
+    double min = inf;
+    for (size_t i = 0; i < n; i++) {
+        if (x[i] != x[i])
+            return nan;
+        if (x[i] < min)
+            min = x[i];
+    }
+    return min;
+}
+
+double MaxScalar(const double *x, size_t n)
+{
+    double max = -inf;
+    for (size_t i = 0; i < n; i++) {
+        if (x[i] != x[i])
+            return nan;
+        if (x[i] > max)
+            max = x[i];
+    }
+    return max;
+}
+
+double DotScalar(const double *x, const double *y, size_t n)
+{
+    double dot = 0;
+    for (size_t i = 0; i < n; i++)
+        dot += x[i] * y[i];
+    return dot;
+}
+
+void ScaleScalar(double *x, size_t n, double k)
+{
+    for (size_t i = 0; i < n; i++)
+        x[i] *= k;
+}
+
+void AddScalar(double *x, const double *y, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+        x[i] += y[i];
+}
+
+void FillScalar(double *x, size_t n, double value)
+{
+    for (size_t i = 0; i < n; i++)
+        x[i] = value;
+}
+
+#ifdef GROK_SIMD
+
+// SSE2 is part of x86-64, these always work. Loads are unaligned, the
+// doubles of an array have no alignment beyond the one of double
+
+double SumSSE2(const double *x, size_t n)
+{
+    __m128d s0 = _mm_setzero_pd(), s1 = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        s0 = _mm_add_pd(s0, _mm_loadu_pd(x + i));
+        s1 = _mm_add_pd(s1, _mm_loadu_pd(x + i + 2));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, _mm_add_pd(s0, s1));
+    return lanes[0] + lanes[1] + SumScalar(x + i, n - i);
+}
+
+double MinSSE2(const double *x, size_t n)
+{
+    __m128d m = _mm_set1_pd(inf), unord = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        auto v = _mm_loadu_pd(x + i);
+        unord = _mm_or_pd(unord, _mm_cmpunord_pd(v, v));
+        m = _mm_min_pd(m, v);
+    }
+    if (_mm_movemask_pd(unord))
+        return nan;
+
+    double lanes[2];
+    _mm_storeu_pd(lanes, m);
+    auto tail = MinScalar(x + i, n - i);
+    if (tail != tail)
+        return nan;
+    return std::min(std::min(lanes[0], lanes[1]), tail);
+}
+
+double MaxSSE2(const double *x, size_t n)
+{
+    __m128d m = _mm_set1_pd(-inf), unord = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        auto v = _mm_loadu_pd(x + i);
+        unord = _mm_or_pd(unord, _mm_cmpunord_pd(v, v));
+        m = _mm_max_pd(m, v);
+    }
+    if (_mm_movemask_pd(unord))
+        return nan;
+
+    double lanes[2];
+    _mm_storeu_pd(lanes, m);
+    auto tail = MaxScalar(x + i, n - i);
+    if (tail != tail)
+        return nan;
+    return std::max(std::max(lanes[0], lanes[1]), tail);
+}
+
+double DotSSE2(const double *x, const double *y, size_t n)
+{
+    __m128d s0 = _mm_setzero_pd(), s1 = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        s0 = _mm_add_pd(s0, _mm_mul_pd(_mm_loadu_pd(x + i),
+            _mm_loadu_pd(y + i)));
+        s1 = _mm_add_pd(s1, _mm_mul_pd(_mm_loadu_pd(x + i + 2),
+            _mm_loadu_pd(y + i + 2)));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, _mm_add_pd(s0, s1));
+    return lanes[0] + lanes[1] + DotScalar(x + i, y + i, n - i);
+}
+
+void ScaleSSE2(double *x, size_t n, double k)
+{
+    auto vk = _mm_set1_pd(k);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2)
+        _mm_storeu_pd(x + i, _mm_mul_pd(_mm_loadu_pd(x + i), vk));
+    ScaleScalar(x + i, n - i, k);
+}
+
+void AddSSE2(double *x, const double *y, size_t n)
+{
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2)
+        _mm_storeu_pd(x + i, _mm_add_pd(_mm_loadu_pd(x + i),
+            _mm_loadu_pd(y + i)));
+    AddScalar(x + i, y + i, n - i);
+}
+
+void FillSSE2(double *x, size_t n, double value)
+{
+    auto v = _mm_set1_pd(value);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2)
+        _mm_storeu_pd(x + i, v);
+    FillScalar(x + i, n - i, value);
+}
+
+// AVX2 kernels are compiled for the instruction set even though the rest
+// of grok isn't, they are only called when cpuid says it is there
+
+#define GROK_AVX2 __attribute__((target("avx2")))
+
+GROK_AVX2 double Lanes(__m256d v)
+{
+    double lanes[4];
+    _mm256_storeu_pd(lanes, v);
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+
+GROK_AVX2 double SumAVX2(const double *x, size_t n)
+{
+    __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        s0 = _mm256_add_pd(s0, _mm256_loadu_pd(x + i));
+        s1 = _mm256_add_pd(s1, _mm256_loadu_pd(x + i + 4));
+    }
+    return Lanes(_mm256_add_pd(s0, s1)) + SumScalar(x + i, n - i);
+}
+
+GROK_AVX2 double MinAVX2(const double *x, size_t n)
+{
+    __m256d m = _mm256_set1_pd(inf), unord = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        auto v = _mm256_loadu_pd(x + i);
+        unord = _mm256_or_pd(unord, _mm256_cmp_pd(v, v, _CMP_UNORD_Q));
+        m = _mm256_min_pd(m, v);
+    }
+    if (_mm256_movemask_pd(unord))
+        return nan;
+
+    double lanes[4];
+    _mm256_storeu_pd(lanes, m);
+    auto tail = MinScalar(x + i, n - i);
+    if (tail != tail)
+        return nan;
+    return std::min(std::min(std::min(lanes[0], lanes[1]),
+        std::min(lanes[2], lanes[3])), tail);
+}
+
+GROK_AVX2 double MaxAVX2(const double *x, size_t n)
+{
+    __m256d m = _mm256_set1_pd(-inf), unord = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        auto v = _mm256_loadu_pd(x + i);
+        unord = _mm256_or_pd(unord, _mm256_cmp_pd(v, v, _CMP_UNORD_Q));
+        m = _mm256_max_pd(m, v);
+    }
+    if (_mm256_movemask_pd(unord))
+        return nan;
+
+    double lanes[4];
+    _mm256_storeu_pd(lanes, m);
+    auto tail = MaxScalar(x + i, n - i);
+    if (tail != tail)
+        return nan;
+    return std::max(std::max(std::max(lanes[0], lanes[1]),
+        std::max(lanes[2], lanes[3])), tail);
+}
+
+GROK_AVX2 double DotAVX2(const double *x, const double *y, size_t n)
+{
+    __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+    size_t i = 0;
+    // no fma, the products are rounded like those of the other kernels
+    for (; i + 8 <= n; i += 8) {
+        s0 = _mm256_add_pd(s0, _mm256_mul_pd(_mm256_loadu_pd(x + i),
+            _mm256_loadu_pd(y + i)));
+        s1 = _mm256_add_pd(s1, _mm256_mul_pd(_mm256_loadu_pd(x + i + 4),
+            _mm256_loadu_pd(y + i + 4)));
+    }
+    return Lanes(_mm256_add_pd(s0, s1)) + DotScalar(x + i, y + i, n - i);
+}
+
+GROK_AVX2 void ScaleAVX2(double *x, size_t n, double k)
+{
+    auto vk = _mm256_set1_pd(k);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm256_storeu_pd(x + i, _mm256_mul_pd(_mm256_loadu_pd(x + i), vk));
+    ScaleScalar(x + i, n - i, k);
+}
+
+GROK_AVX2 void AddAVX2(double *x, const double *y, size_t n)
+{
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm256_storeu_pd(x + i, _mm256_add_pd(_mm256_loadu_pd(x + i),
+            _mm256_loadu_pd(y + i)));
+    AddScalar(x + i, y + i, n - i);
+}
+
+GROK_AVX2 void FillAVX2(double *x, size_t n, double value)
+{
+    auto v = _mm256_set1_pd(value);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm256_storeu_pd(x + i, v);
+    FillScalar(x + i, n - i, value);
+}
+
+#undef GROK_AVX2
+
+#endif // GROK_SIMD
+
+const NumericKernels scalar_kernels = {
+    "scalar", SumScalar, MinScalar, MaxScalar, DotScalar,
+    ScaleScalar, AddScalar, FillScalar
+};
+
+#ifdef GROK_SIMD
+const NumericKernels sse2_kernels = {
+    "sse2", SumSSE2, MinSSE2, MaxSSE2, DotSSE2,
+    ScaleSSE2, AddSSE2, FillSSE2
+};
+
+const NumericKernels avx2_kernels = {
+    "avx2", SumAVX2, MinAVX2, MaxAVX2, DotAVX2,
+    ScaleAVX2, AddAVX2, FillAVX2
+};
+#endif
+
+const NumericKernels &SelectKernels()
+{
+#ifdef GROK_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return avx2_kernels;
+    return sse2_kernels;
+#else
+    return scalar_kernels;
+#endif
+}
+
+}
+
+const NumericKernels &GetNumericKernels()
+{
+    static const NumericKernels &kernels = SelectKernels();
+    return kernels;
+}
+
+}
+}
@@ -0,0 +1,42 @@
+#ifndef ARRAY_KERNELS_H_
+#define ARRAY_KERNELS_H_
+
+#include <cstddef>
+
+namespace grok {
+namespace libs {
+
+/// NumericKernels ::= bulk operations on contiguous doubles, the ones of
+/// the widest vector instructions the cpu supports are picked once. The
+/// reductions add the lanes up in a different order than a loop of the
+/// script would, so their results may differ in the last bits
+struct NumericKernels {
+    /// Name ::= "avx2", "sse2" or "scalar"
+    const char *Name;
+
+    double (*Sum)(const double *x, size_t n);
+
+    /// Min ::= the least element, NaN if any is NaN, Infinity if n is 0
+    double (*Min)(const double *x, size_t n);
+
+    /// Max ::= the greatest element, NaN if any is NaN, -Infinity if n is 0
+    double (*Max)(const double *x, size_t n);
+
+    double (*Dot)(const double *x, const double *y, size_t n);
+
+    /// Scale ::= x[i] *= k
+    void (*Scale)(double *x, size_t n, double k);
+
+    /// Add ::= x[i] += y[i], x and y may be the same
+    void (*Add)(double *x, const double *y, size_t n);
+
+    void (*Fill)(double *x, size_t n, double value);
+};
+
+/// GetNumericKernels ::= kernels for the cpu we are running on
+extern const NumericKernels &GetNumericKernels();
+
+}
+}
+
+#endif // ARRAY_KERNELS_H_
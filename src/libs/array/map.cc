@@ -27,14 +27,26 @@ std::shared_ptr<Object> ArrayMap(std::shared_ptr<Argument> Args)
     auto vm = GetGlobalVMContext()->GetVM();
 
     auto RA = Result->as<JSArray>();
-    size_t count = 0;
-    for (auto i : *A) {
+    auto Call = [&](std::shared_ptr<Object> Element, size_t Index) {
         auto args_to_pass = CreateArgumentObject()->as<Argument>();
-        args_to_pass->Push(i);
-        args_to_pass->Push(CreateJSNumber(count++));
+        args_to_pass->Push(Element);
+        args_to_pass->Push(CreateJSNumber(Index));
 
         auto R = CallJSFunction(F, args_to_pass, vm);
         RA->Push(R);
+    };
+
+    // numbers are read by index, they have no handles to iterate over
+    if (A->HasDoubleElements()) {
+        auto Size = A->Size();
+        for (size_t i = 0; i < Size; i++)
+            Call(A->At(i), i);
+        return (Result);
+    }
+
+    size_t count = 0;
+    for (auto i : *A) {
+        Call(i, count++);
     }
     return (Result);
 }
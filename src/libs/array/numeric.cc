@@ -0,0 +1,243 @@
+#include "libs/array/numeric.h"
+#include "libs/array/kernels.h"
+#include "object/array.h"
+#include "object/typed-array.h"
+#include "object/function.h"
+#include "common/exceptions.h"
+
+#include <limits>
+#include <vector>
+
+namespace grok {
+namespace libs {
+
+using namespace grok::obj;
+
+/// Numbers ::= elements of an array or a typed array as doubles, they are
+/// its own storage when it keeps doubles and a copy otherwise
+struct Numbers {
+    const double *data = nullptr;
+    size_t size = 0;
+    std::vector<double> copy;
+};
+
+static bool ReadNumbers(std::shared_ptr<Object> obj, Numbers &numbers)
+{
+    if (IsTypedArray(obj)) {
+        auto A = obj->as<TypedArray>();
+        numbers.size = A->Length();
+        if (A->Kind() == TypedArrayKind::float64) {
+            numbers.data = A->Data<double>();
+            return true;
+        }
+        numbers.copy.resize(numbers.size);
+        for (size_t i = 0; i < numbers.size; i++)
+            numbers.copy[i] = A->Get(i);
+    } else if (IsJSArray(obj)) {
+        auto A = obj->as<JSArray>();
+        numbers.size = A->Size();
+        // holes are NaN as well, like undefined would be
+        if (A->HasDoubleElements()) {
+            numbers.data = A->Doubles().data();
+            return true;
+        }
+        numbers.copy.resize(numbers.size);
+        for (size_t i = 0; i < numbers.size; i++)
+            numbers.copy[i] = ToElementNumber(A->At(i));
+    } else {
+        return false;
+    }
+    numbers.data = numbers.copy.data();
+    return true;
+}
+
+/// WritableDoubles ::= storage of the array if it can be written as
+/// doubles, nullptr when the elements have to be stored one at a time
+static double *WritableDoubles(std::shared_ptr<Object> obj)
+{
+    if (IsTypedArray(obj)) {
+        auto A = obj->as<TypedArray>();
+        if (A->Kind() == TypedArrayKind::float64)
+            return A->Data<double>();
+    } else {
+        auto A = obj->as<JSArray>();
+        if (A->HasDoubleElements())
+            return A->Doubles().data();
+    }
+    return nullptr;
+}
+
+/// StoreNumber ::= stores the number into an element of an array or
+/// a typed array which has no writable doubles
+static void StoreNumber(std::shared_ptr<Object> obj, size_t idx,
+    double number)
+{
+    if (IsTypedArray(obj))
+        obj->as<TypedArray>()->Set(idx, number);
+    else
+        obj->as<JSArray>()->Assign(idx, CreateJSNumber(number));
+}
+
+/// DoublesWritten ::= the kernel wrote the doubles of an array, it may not
+/// be an array of ints any more
+static void DoublesWritten(std::shared_ptr<Object> obj)
+{
+    if (IsJSArray(obj))
+        obj->as<JSArray>()->DoublesWritten();
+}
+
+static std::shared_ptr<Object> Reduce(std::shared_ptr<Argument> Args,
+    double (*kernel)(const double*, size_t))
+{
+    Numbers numbers;
+    if (!ReadNumbers(Args->GetProperty("this"), numbers))
+        return CreateUndefinedObject();
+    return CreateJSNumber(kernel(numbers.data, numbers.size));
+}
+
+std::shared_ptr<Object> ArraySum(std::shared_ptr<Argument> Args)
+{
+    return Reduce(Args, GetNumericKernels().Sum);
+}
+
+std::shared_ptr<Object> ArrayMin(std::shared_ptr<Argument> Args)
+{
+    return Reduce(Args, GetNumericKernels().Min);
+}
+
+std::shared_ptr<Object> ArrayMax(std::shared_ptr<Argument> Args)
+{
+    return Reduce(Args, GetNumericKernels().Max);
+}
+
+/// ReadOther ::= the array given to dot or add, its length must be the
+/// one of the array they are called on
+static void ReadOther(std::shared_ptr<Argument> Args, size_t size,
+    Numbers &other)
+{
+    if (!ReadNumbers(Args->GetProperty("other"), other))
+        throw TypeError("argument is not an array");
+    if (other.size != size)
+        throw RangeError("arrays have different lengths "
+            + std::to_string(size) + " and " + std::to_string(other.size));
+}
+
+std::shared_ptr<Object> ArrayDot(std::shared_ptr<Argument> Args)
+{
+    Numbers numbers, other;
+    if (!ReadNumbers(Args->GetProperty("this"), numbers))
+        return CreateUndefinedObject();
+    ReadOther(Args, numbers.size, other);
+
+    return CreateJSNumber(GetNumericKernels().Dot(numbers.data, other.data,
+        numbers.size));
+}
+
+std::shared_ptr<Object> ArrayScale(std::shared_ptr<Argument> Args)
+{
+    auto This = Args->GetProperty("this");
+    Numbers numbers;
+    if (!ReadNumbers(This, numbers))
+        return CreateUndefinedObject();
+
+    auto k = ToElementNumber(Args->GetProperty("k"));
+    auto data = WritableDoubles(This);
+    if (data && IsJSArray(This)
+            && This->as<JSArray>()->Kind() == ElementKind::holey_double) {
+        // the kernel would turn the holes into NaN
+        for (size_t i = 0; i < numbers.size; i++) {
+            if (!JSArray::IsHole(data[i]))
+                data[i] *= k;
+        }
+    } else if (data) {
+        GetNumericKernels().Scale(data, numbers.size, k);
+        DoublesWritten(This);
+    } else {
+        for (size_t i = 0; i < numbers.size; i++)
+            StoreNumber(This, i, numbers.data[i] * k);
+    }
+    return This;
+}
+
+std::shared_ptr<Object> ArrayAdd(std::shared_ptr<Argument> Args)
+{
+    auto This = Args->GetProperty("this");
+    Numbers numbers, other;
+    if (!ReadNumbers(This, numbers))
+        return CreateUndefinedObject();
+    ReadOther(Args, numbers.size, other);
+
+    auto data = WritableDoubles(This);
+    if (!data) {
+        for (size_t i = 0; i < numbers.size; i++)
+            StoreNumber(This, i, numbers.data[i] + other.data[i]);
+        return This;
+    }
+
+    // views of one buffer may overlap, the kernel must read the elements
+    // of other before they are written
+    if (other.data != data && other.data < data + numbers.size
+            && data < other.data + numbers.size) {
+        other.copy.assign(other.data, other.data + numbers.size);
+        other.data = other.copy.data();
+    }
+    GetNumericKernels().Add(data, other.data, numbers.size);
+    DoublesWritten(This);
+    return This;
+}
+
+std::shared_ptr<Object> ArrayFill(std::shared_ptr<Argument> Args)
+{
+    auto This = Args->GetProperty("this");
+
+    if (!IsJSArray(This))
+        return CreateUndefinedObject();
+
+    auto A = This->as<JSArray>();
+    auto Value = Args->GetProperty("value");
+    auto type = Value->as<JSObject>()->GetType();
+
+    if (A->HasDoubleElements() && (type == ObjectType::_number
+            || type == ObjectType::_double)) {
+        auto number = ToElementNumber(Value);
+        if (number != number)
+            number = std::numeric_limits<double>::quiet_NaN();
+        GetNumericKernels().Fill(A->Doubles().data(), A->Size(), number);
+        A->DoublesWritten();
+        return This;
+    }
+
+    // every element gets a copy of the value as a store would, so that
+    // updating one element doesn't update the others
+    for (auto &element : A->Container())
+        element = CreateCopy(Value);
+    return This;
+}
+
+void DefineNumericMethods(JSObject *proto)
+{
+    struct {
+        const char *name;
+        NativeFunctionType function;
+        std::vector<std::string> params;
+    } methods[] = {
+        { "sum", ArraySum, { } },
+        { "min", ArrayMin, { } },
+        { "max", ArrayMax, { } },
+        { "dot", ArrayDot, { "other" } },
+        { "scale", ArrayScale, { "k" } },
+        { "add", ArrayAdd, { "other" } },
+    };
+
+    for (auto &method : methods) {
+        auto S = std::make_shared<Function>(method.function);
+        S->SetNonWritable();
+        S->SetNonEnumerable();
+        S->SetParams(method.params);
+        proto->AddProperty(std::string(method.name),
+            std::make_shared<Object>(S));
+    }
+}
+
+}
+}
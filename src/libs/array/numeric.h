@@ -0,0 +1,51 @@
+#ifndef ARRAY_NUMERIC_H_
+#define ARRAY_NUMERIC_H_
+
+#include "object/argument.h"
+
+namespace grok {
+namespace libs {
+
+// numeric methods of arrays and typed arrays, elements which aren't
+// numbers count as NaN. Elements kept as doubles are handed to the
+// vectorized kernels where they are
+
+/// DefineNumericMethods ::= adds sum, min, max, dot, scale and add to the
+/// prototype of arrays or typed arrays
+extern void DefineNumericMethods(grok::obj::JSObject *proto);
+
+/// ArraySum ::= sum of the elements, 0 for an empty array
+extern std::shared_ptr<grok::obj::Object>
+ArraySum(std::shared_ptr<grok::obj::Argument> Args);
+
+/// ArrayMin ::= least element, Infinity for an empty array
+extern std::shared_ptr<grok::obj::Object>
+ArrayMin(std::shared_ptr<grok::obj::Argument> Args);
+
+/// ArrayMax ::= greatest element, -Infinity for an empty array
+extern std::shared_ptr<grok::obj::Object>
+ArrayMax(std::shared_ptr<grok::obj::Argument> Args);
+
+/// ArrayDot ::= sum of the products of the elements with those of other,
+/// which must have the same length
+extern std::shared_ptr<grok::obj::Object>
+ArrayDot(std::shared_ptr<grok::obj::Argument> Args);
+
+/// ArrayScale ::= multiplies every element by k, returns the array. Holes
+/// of an array stay holes
+extern std::shared_ptr<grok::obj::Object>
+ArrayScale(std::shared_ptr<grok::obj::Argument> Args);
+
+/// ArrayAdd ::= adds the elements of other to those of the array, which
+/// is returned
+extern std::shared_ptr<grok::obj::Object>
+ArrayAdd(std::shared_ptr<grok::obj::Argument> Args);
+
+/// ArrayFill ::= stores value in every element, returns the array
+extern std::shared_ptr<grok::obj::Object>
+ArrayFill(std::shared_ptr<grok::obj::Argument> Args);
+
+}
+}
+
+#endif // ARRAY_NUMERIC_H_
@@ -5,37 +5,48 @@ namespace grok {
 namespace libs {
 
 using namespace grok::obj;
+using grok::vm::Value;
 
-std::shared_ptr<Object> ArrayPush(std::shared_ptr<Argument> Args)
+Value ArrayPush(NativeArgs &Args)
 {
-    auto This = Args->GetProperty("this");
+    const auto &This = Args.This();
 
     if (!IsJSArray(This))
-        return CreateUndefinedObject();
+        return Value::Undefined();
 
     auto Arr = This->as<JSArray>();
 
-    for (auto &Arg : *Args) {
-        Arr->Push(CreateCopy(Arg));
+    // numbers need no handle, everything else gets a copy of its own
+    for (size_t i = 0; i < Args.Size(); i++) {
+        double Number;
+        if (Args.Number(i, Number))
+            Arr->PushDouble(Number);
+        else
+            Arr->Push(Args[i].Copy());
     }
 
-    auto Sz = Arr->Size();
-
-    return CreateJSNumber(Sz);
+    return Value::Number(Arr->Size());
 }
 
-std::shared_ptr<Object> ArrayPop(std::shared_ptr<Argument> Args)
+Value ArrayPop(NativeArgs &Args)
 {
-    auto This = Args->GetProperty("this");
+    const auto &This = Args.This();
 
     if (!IsJSArray(This))
-        return CreateUndefinedObject();
+        return Value::Undefined();
 
     auto Arr = This->as<JSArray>();
-
-    auto element = Arr->Pop();
-
-    return element;
+    if (Arr->Empty())
+        return Value::Undefined();
+
+    if (Arr->HasDoubleElements()) {
+        auto &Doubles = Arr->Doubles();
+        auto Element = Doubles.back();
+        Doubles.pop_back();
+        return JSArray::IsHole(Element) ? Value::Undefined()
+            : Value::Number(Element);
+    }
+    return Value(Arr->Pop());
 }
 
 } // libs
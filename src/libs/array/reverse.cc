@@ -15,6 +15,11 @@ std::shared_ptr<Object> ArrayReverse(std::shared_ptr<Argument> Args)
         return CreateUndefinedObject();
 
     auto A = This->as<JSArray>();
+    if (A->HasDoubleElements()) {
+        std::reverse(A->Doubles().begin(), A->Doubles().end());
+        return This;
+    }
+
     auto Beg = A->begin();
     auto End = --A->end();
 
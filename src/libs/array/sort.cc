@@ -23,6 +23,12 @@ bool MyPred(std::shared_ptr<Object> A, std::shared_ptr<Object> B)
 
 void SortArrayWithDefaultPredicate(std::shared_ptr<JSArray> arr)
 {
+    // numbers are compared as they are, holes compare as strings
+    if (arr->Kind() == ElementKind::packed_int
+            || arr->Kind() == ElementKind::packed_double) {
+        std::sort(arr->Doubles().begin(), arr->Doubles().end());
+        return;
+    }
     std::sort(arr->begin(), arr->end(), MyPred);
 }
 
@@ -50,22 +56,31 @@ void SortWithPredicate(std::shared_ptr<Object> obj,
         return;
 
     auto A = obj->as<JSArray>();
-    std::sort(A->begin(), A->end(),
-            [&func](auto a, auto b) {
-                auto Args = CreateArgumentObject()->as<Argument>();
-                Args->Push(a);
-                Args->Push(b);
-                auto vm = GetGlobalVMContext()->GetVM();
-
-                auto R = CallJSFunction(func, Args, vm);
-
-                int n = 0;
-                if (IsJSNumber(R)) {
-                    n = (int)R->as<JSDouble>()->GetNumber();
-                    return n < 0 ? true : false;
-                }
-                return false;
+    auto Less = [&func](auto a, auto b) {
+        auto Args = CreateArgumentObject()->as<Argument>();
+        Args->Push(a);
+        Args->Push(b);
+        auto vm = GetGlobalVMContext()->GetVM();
+
+        auto R = CallJSFunction(func, Args, vm);
+
+        int n = 0;
+        if (IsJSNumber(R)) {
+            n = (int)R->as<JSDouble>()->GetNumber();
+            return n < 0 ? true : false;
+        }
+        return false;
+    };
+
+    // the predicate gets a new handle for every number it compares
+    if (A->HasDoubleElements()) {
+        std::sort(A->Doubles().begin(), A->Doubles().end(),
+            [&Less](double a, double b) {
+                return Less(CreateJSNumber(a), CreateJSNumber(b));
             });
+        return;
+    }
+    std::sort(A->begin(), A->end(), Less);
 }
 
 void SortInternal(std::shared_ptr<Object> A,
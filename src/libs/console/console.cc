@@ -20,58 +20,40 @@ Console::Console()
     this->AddProperty("flush", flush);
 }
 
-std::shared_ptr<grok::obj::Object>
-    Console::Print(std::shared_ptr<grok::obj::Argument> Args)
+/// Write ::= the arguments separated by spaces
+static void Write(grok::obj::NativeArgs &Args)
 {
-    if (Args->Size() == 0) {
-        std::cout << std::endl;
-        return grok::obj::CreateUndefinedObject();
+    for (size_t i = 0; i < Args.Size(); i++) {
+        if (i)
+            std::cout << " ";
+        std::cout << Args.ToString(i);
     }
-    auto it = Args->begin();
-    auto end = Args->end();
+}
 
-    while (it != end - 1) {
-        auto O = (*it)->as<grok::obj::JSObject>();
-        std::cout << O->ToString() << " ";
-        ++it;
+grok::vm::Value Console::Print(grok::obj::NativeArgs &Args)
+{
+    if (Args.Size() == 0) {
+        std::cout << std::endl;
+        return grok::vm::Value::Undefined();
     }
-
-    auto O = (*it)->as<grok::obj::JSObject>();
-    std::cout << O->ToString();
-    return grok::obj::CreateUndefinedObject();
+    Write(Args);
+    return grok::vm::Value::Undefined();
 }
 
-
-std::shared_ptr<grok::obj::Object>
-    Console::Flush(std::shared_ptr<grok::obj::Argument> Args)
+grok::vm::Value Console::Flush(grok::obj::NativeArgs &Args)
 {
     std::cout.flush();
-    return grok::obj::CreateUndefinedObject();
+    return grok::vm::Value::Undefined();
 }
 
-std::shared_ptr<grok::obj::Object>
-    Console::Log(std::shared_ptr<grok::obj::Argument> Args)
+grok::vm::Value Console::Log(grok::obj::NativeArgs &Args)
 {
-    if (Args->Size() == 0) {
-        std::cout << std::endl;
-        return grok::obj::CreateUndefinedObject();
-    }
-    auto it = Args->begin();
-    auto end = Args->end();
-
-    while (it != end - 1) {
-        auto O = (*it)->as<grok::obj::JSObject>();
-        std::cout << O->ToString() << " ";
-        ++it;
-    }
-
-    auto O = (*it)->as<grok::obj::JSObject>();
-    std::cout << O->ToString() << std::endl;
-    return grok::obj::CreateUndefinedObject();
+    Write(Args);
+    std::cout << std::endl;
+    return grok::vm::Value::Undefined();
 }
 
-std::shared_ptr<grok::obj::Object>
-    Console::Error(std::shared_ptr<grok::obj::Argument> Args)
+grok::vm::Value Console::Error(grok::obj::NativeArgs &Args)
 {
     return Log(Args);
 }
@@ -12,17 +12,13 @@ class Console : public grok::obj::JSObject {
 public:
     Console();
 
-    static std::shared_ptr<grok::obj::Object>
-    Log(std::shared_ptr<grok::obj::Argument> Args);
+    static grok::vm::Value Log(grok::obj::NativeArgs &Args);
 
-    static std::shared_ptr<grok::obj::Object>
-    Error(std::shared_ptr<grok::obj::Argument> Args);
+    static grok::vm::Value Error(grok::obj::NativeArgs &Args);
 
-    static std::shared_ptr<grok::obj::Object>
-    Print(std::shared_ptr<grok::obj::Argument> Args);
+    static grok::vm::Value Print(grok::obj::NativeArgs &Args);
     
-    static std::shared_ptr<grok::obj::Object>
-    Flush(std::shared_ptr<grok::obj::Argument> Args);
+    static grok::vm::Value Flush(grok::obj::NativeArgs &Args);
 };
 
 }
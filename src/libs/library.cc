@@ -2,6 +2,7 @@
 
 #include "libs/console/console.h" // console.log, console.error 
 #include "libs/array/array_constructor.h"
+#include "libs/typed-array/typed-array-constructor.h"
 #include "libs/example/example.h"
 #include "libs/regex/regex.h"
 #include "libs/timer/timer.h"
@@ -26,6 +27,14 @@ int LoadLibraries(VMContext *ctx)
     auto array_ctor = CreateArrayConstructorObject();
     V->StoreValue("Array", array_ctor);
 
+    V->StoreValue("ArrayBuffer", CreateArrayBufferConstructorObject());
+    V->StoreValue("Float64Array",
+        CreateTypedArrayConstructorObject(TypedArrayKind::float64));
+    V->StoreValue("Int32Array",
+        CreateTypedArrayConstructorObject(TypedArrayKind::int32));
+    V->StoreValue("Uint8Array",
+        CreateTypedArrayConstructorObject(TypedArrayKind::uint8));
+
     // create an example object constructor
     auto ex = example::Example::CreateConstructor();
     V->StoreValue("Example", ex);
@@ -19,43 +19,53 @@ std::pair<int32_t, bool> ParseIndex(std::shared_ptr<Handle> obj)
     return { res, true };
 }
 
-std::shared_ptr<Handle> StringCharAt(std::shared_ptr<Argument> args)
+/// ThisString ::= characters of the string a method was called on, they
+/// aren't copied when it is a string
+static const std::string &ThisString(const NativeArgs &Args,
+    std::string &copy)
 {
-    auto js_this = args->GetProperty("this");
-    auto js_string = js_this->as<JSObject>()->ToString();
+    const auto &This = Args.This();
+    if (IsJSString(This))
+        return This->as<JSString>()->GetString();
+    copy = This->as<JSObject>()->ToString();
+    return copy;
+}
 
-    auto idx = args->GetProperty("index");
+grok::vm::Value StringCharAt(NativeArgs &Args)
+{
+    std::string copy;
+    const auto &js_string = ThisString(Args, copy);
 
-    if (!IsJSNumber(idx)) {
+    double idx;
+    if (!Args.Number(0, idx)) {
         return CreateJSString("");
     }
 
-    auto num = (size_t)idx->as<JSDouble>()->GetNumber();
-    if (num >= js_string.length()) {
+    if (!(idx >= 0) || idx >= js_string.length()) {
         return CreateJSString("");
     }
+    auto num = (size_t)idx;
     std::string res(1, js_string[num]);
     return CreateJSString(res);
 }
 
-std::shared_ptr<Handle> StringCharCodeAt(std::shared_ptr<Argument> args)
+grok::vm::Value StringCharCodeAt(NativeArgs &Args)
 {
-    auto js_this = args->GetProperty("this");
-    auto js_string = js_this->as<JSObject>()->ToString();
-
-    auto idx = args->GetProperty("index");
+    std::string copy;
+    const auto &js_string = ThisString(Args, copy);
 
-    if (!IsJSNumber(idx)) {
-        return CreateJSNumber(0);
+    double idx;
+    if (!Args.Number(0, idx)) {
+        return grok::vm::Value::Number(0);
     }
 
-    auto num = (size_t)idx->as<JSDouble>()->GetNumber();
-    if (num >= js_string.length()) {
-        return CreateJSNumber(0);
+    if (!(idx >= 0) || idx >= js_string.length()) {
+        return grok::vm::Value::Number(0);
     }
+    auto num = (size_t)idx;
 
     // hack but works for ASCII
-    return CreateJSNumber((int16_t)js_string[num]);
+    return grok::vm::Value::Number((int16_t)js_string[num]);
 }
 
 void ConcatSingleStr(JSString *str, std::shared_ptr<Object> obj)
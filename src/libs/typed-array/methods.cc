@@ -0,0 +1,149 @@
+#include "libs/typed-array/methods.h"
+#include "libs/array/kernels.h"
+#include "object/array.h"
+#include "object/typed-array.h"
+#include "object/jsstring.h"
+#include "common/exceptions.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace grok {
+namespace libs {
+
+using namespace grok::obj;
+
+/// GetIndex ::= relative index of begin and end of subarray, negative
+/// ones count from the end, the result is clamped to [0, sz]
+static size_t GetIndex(size_t sz, std::shared_ptr<Object> obj, size_t def)
+{
+    if (IsUndefined(obj))
+        return def;
+
+    auto num = ToElementNumber(obj);
+    if (num != num)
+        return 0;
+    num = std::trunc(num);
+    if (num < 0)
+        num += sz;
+    if (num < 0)
+        return 0;
+    if (num > sz)
+        return sz;
+    return static_cast<size_t>(num);
+}
+
+std::shared_ptr<Object> TypedArrayFill(std::shared_ptr<Argument> Args)
+{
+    auto This = Args->GetProperty("this");
+
+    if (!IsTypedArray(This))
+        return CreateUndefinedObject();
+
+    auto A = This->as<TypedArray>();
+    auto number = ToElementNumber(Args->GetProperty("value"));
+    if (A->Kind() == TypedArrayKind::float64) {
+        GetNumericKernels().Fill(A->Data<double>(), A->Length(), number);
+    } else if (A->Length()) {
+        A->Set(0, number);
+        // the rest are copies of the first element, already converted
+        auto size = TypedArray::ElementSize(A->Kind());
+        auto data = A->Data<uint8_t>();
+        for (size_t i = 1; i < A->Length(); i++)
+            std::memcpy(data + i * size, data, size);
+    }
+    return This;
+}
+
+std::shared_ptr<Object> TypedArraySet(std::shared_ptr<Argument> Args)
+{
+    auto This = Args->GetProperty("this");
+
+    if (!IsTypedArray(This))
+        return CreateUndefinedObject();
+
+    auto A = This->as<TypedArray>();
+    auto Source = Args->GetProperty("source");
+    auto Offset = Args->GetProperty("offset");
+
+    size_t offset = 0;
+    if (!IsUndefined(Offset)) {
+        auto num = ToElementNumber(Offset);
+        if (!(num >= 0))
+            throw RangeError("offset is out of bounds");
+        offset = static_cast<size_t>(num);
+    }
+
+    if (IsTypedArray(Source)) {
+        auto S = Source->as<TypedArray>();
+        if (offset > A->Length() || S->Length() > A->Length() - offset)
+            throw RangeError("offset is out of bounds");
+
+        // same kind, the bytes can be copied as they are, memmove because
+        // both may view the same buffer
+        if (S->Kind() == A->Kind()) {
+            auto size = TypedArray::ElementSize(A->Kind());
+            std::memmove(A->Data<uint8_t>() + offset * size,
+                S->Data<uint8_t>(), S->Length() * size);
+        } else {
+            std::vector<double> elements(S->Length());
+            for (size_t i = 0; i < elements.size(); i++)
+                elements[i] = S->Get(i);
+            for (size_t i = 0; i < elements.size(); i++)
+                A->Set(offset + i, elements[i]);
+        }
+    } else if (IsJSArray(Source)) {
+        auto S = Source->as<JSArray>();
+        if (offset > A->Length() || S->Size() > A->Length() - offset)
+            throw RangeError("offset is out of bounds");
+
+        for (size_t i = 0; i < S->Size(); i++)
+            A->Set(offset + i, ToElementNumber(S->At(i)));
+    } else {
+        throw TypeError("invalid source of " + std::string(
+            TypedArray::Name(A->Kind())) + ".prototype.set");
+    }
+    return CreateUndefinedObject();
+}
+
+std::shared_ptr<Object> TypedArraySubarray(std::shared_ptr<Argument> Args)
+{
+    auto This = Args->GetProperty("this");
+
+    if (!IsTypedArray(This))
+        return CreateUndefinedObject();
+
+    auto A = This->as<TypedArray>();
+    auto Sz = A->Length();
+    auto begin = GetIndex(Sz, Args->GetProperty("begin"), 0);
+    auto end = GetIndex(Sz, Args->GetProperty("end"), Sz);
+    if (end < begin)
+        end = begin;
+
+    auto offset = A->ByteOffset() + begin * TypedArray::ElementSize(A->Kind());
+    auto R = AllocateShared<TypedArray>(A->Kind(), A->Buffer(), offset,
+        end - begin);
+    return AllocateShared<Object>(R);
+}
+
+std::shared_ptr<Object> TypedArrayJoin(std::shared_ptr<Argument> Args)
+{
+    auto This = Args->GetProperty("this");
+
+    if (!IsTypedArray(This))
+        return CreateUndefinedObject();
+
+    // get the separator, default is ','
+    auto Separator = Args->GetProperty("sep");
+
+    std::string sepstr;
+    if (IsUndefined(Separator))
+        sepstr = ",";
+    else
+        sepstr = Separator->as<JSObject>()->ToString();
+
+    return CreateJSString(This->as<TypedArray>()->Join(sepstr));
+}
+
+}
+}
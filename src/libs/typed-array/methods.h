@@ -0,0 +1,30 @@
+#ifndef TYPED_ARRAY_METHODS_H_
+#define TYPED_ARRAY_METHODS_H_
+
+#include "object/argument.h"
+
+namespace grok {
+namespace libs {
+
+/// TypedArrayFill ::= stores value in every element, returns the array
+extern std::shared_ptr<grok::obj::Object>
+TypedArrayFill(std::shared_ptr<grok::obj::Argument> Args);
+
+/// TypedArraySet ::= copies the elements of an array or of a typed array
+/// into the array starting at offset
+extern std::shared_ptr<grok::obj::Object>
+TypedArraySet(std::shared_ptr<grok::obj::Argument> Args);
+
+/// TypedArraySubarray ::= typed array viewing the elements from begin up
+/// to end in the same buffer
+extern std::shared_ptr<grok::obj::Object>
+TypedArraySubarray(std::shared_ptr<grok::obj::Argument> Args);
+
+/// TypedArrayJoin ::= join the elements of a typed array
+extern std::shared_ptr<grok::obj::Object>
+TypedArrayJoin(std::shared_ptr<grok::obj::Argument> Args);
+
+}
+}
+
+#endif // TYPED_ARRAY_METHODS_H_
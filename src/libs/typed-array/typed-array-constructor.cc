@@ -0,0 +1,156 @@
+#include "libs/typed-array/typed-array-constructor.h"
+#include "object/array.h"
+#include "object/function.h"
+#include "common/exceptions.h"
+#include "vm/vm.h"
+
+#include <cmath>
+#include <limits>
+
+namespace grok {
+namespace libs {
+
+using namespace grok::obj;
+
+/// ToLength ::= a length or an offset given to a constructor, it must be
+/// an integer between 0 and 2^32
+static size_t ToLength(std::shared_ptr<Object> obj, const std::string &what)
+{
+    auto number = ToElementNumber(obj);
+    if (!(number >= 0 && number <= 4294967296.0)
+            || number != std::trunc(number))
+        throw RangeError("invalid " + what + " "
+            + obj->as<JSObject>()->ToString());
+    return static_cast<size_t>(number);
+}
+
+std::shared_ptr<Object> ArrayBufferConstructor(std::shared_ptr<Argument> Args)
+{
+    grok::vm::VM *vm = grok::vm::GetGlobalVMContext()->GetVM();
+
+    if (!vm->IsConstructorCall()) {
+        return CreateUndefinedObject();
+    }
+
+    if (Args->Size() == 0)
+        return CreateArrayBuffer(0);
+    return CreateArrayBuffer(ToLength(Args->At(0), "array buffer length"));
+}
+
+/// CreateView ::= typed array of the kind on a buffer which is there
+/// already, new Float64Array(buffer, byteOffset, length)
+static std::shared_ptr<Object> CreateView(TypedArrayKind kind,
+    std::shared_ptr<Argument> Args)
+{
+    auto buffer = Args->At(0)->as<ArrayBuffer>();
+    auto byte_length = buffer->ByteLength();
+    auto size = TypedArray::ElementSize(kind);
+
+    size_t offset = 0;
+    if (Args->Size() > 1 && !IsUndefined(Args->At(1)))
+        offset = ToLength(Args->At(1), "typed array offset");
+    if (offset % size || offset > byte_length)
+        throw RangeError("start offset of "
+            + std::string(TypedArray::Name(kind))
+            + " should be a multiple of " + std::to_string(size)
+            + " in the buffer");
+
+    size_t length;
+    if (Args->Size() > 2 && !IsUndefined(Args->At(2))) {
+        length = ToLength(Args->At(2), "typed array length");
+        if (offset + length * size > byte_length)
+            throw RangeError("invalid typed array length "
+                + std::to_string(length));
+    } else {
+        if ((byte_length - offset) % size)
+            throw RangeError("byte length of "
+                + std::string(TypedArray::Name(kind))
+                + " should be a multiple of " + std::to_string(size));
+        length = (byte_length - offset) / size;
+    }
+
+    auto A = AllocateShared<TypedArray>(kind, buffer, offset, length);
+    return AllocateShared<Object>(A);
+}
+
+/// CopyElements ::= typed array of the kind with the elements of an
+/// array or of another typed array converted to its element type
+static std::shared_ptr<Object> CopyElements(TypedArrayKind kind,
+    std::shared_ptr<Object> source)
+{
+    if (IsTypedArray(source)) {
+        auto S = source->as<TypedArray>();
+        auto result = CreateTypedArray(kind, S->Length());
+        auto R = result->as<TypedArray>();
+        for (size_t i = 0; i < S->Length(); i++)
+            R->Set(i, S->Get(i));
+        return result;
+    }
+
+    auto S = source->as<JSArray>();
+    auto result = CreateTypedArray(kind, S->Size());
+    auto R = result->as<TypedArray>();
+    if (S->HasDoubleElements()) {
+        auto &doubles = S->Doubles();
+        for (size_t i = 0; i < doubles.size(); i++)
+            R->Set(i, JSArray::IsHole(doubles[i])
+                ? std::numeric_limits<double>::quiet_NaN() : doubles[i]);
+    } else {
+        for (size_t i = 0; i < S->Size(); i++)
+            R->Set(i, ToElementNumber(S->At(i)));
+    }
+    return result;
+}
+
+template <TypedArrayKind kind>
+std::shared_ptr<Object> TypedArrayConstructor(std::shared_ptr<Argument> Args)
+{
+    grok::vm::VM *vm = grok::vm::GetGlobalVMContext()->GetVM();
+
+    if (!vm->IsConstructorCall()) {
+        return CreateUndefinedObject();
+    }
+
+    if (Args->Size() == 0)
+        return CreateTypedArray(kind, 0);
+
+    auto first = Args->At(0);
+    if (IsArrayBuffer(first))
+        return CreateView(kind, Args);
+    if (IsTypedArray(first) || IsJSArray(first))
+        return CopyElements(kind, first);
+    return CreateTypedArray(kind, ToLength(first, "typed array length"));
+}
+
+std::shared_ptr<Object> CreateArrayBufferConstructorObject()
+{
+    return CreateFunction(ArrayBufferConstructor);
+}
+
+std::shared_ptr<Object> CreateTypedArrayConstructorObject(TypedArrayKind kind)
+{
+    std::shared_ptr<Object> wrapped_function;
+    switch (kind) {
+    case TypedArrayKind::float64:
+        wrapped_function =
+            CreateFunction(TypedArrayConstructor<TypedArrayKind::float64>);
+        break;
+    case TypedArrayKind::int32:
+        wrapped_function =
+            CreateFunction(TypedArrayConstructor<TypedArrayKind::int32>);
+        break;
+    case TypedArrayKind::uint8:
+        wrapped_function =
+            CreateFunction(TypedArrayConstructor<TypedArrayKind::uint8>);
+        break;
+    }
+
+    auto ctor = wrapped_function->as<Function>();
+    ctor->AddProperty("BYTES_PER_ELEMENT",
+        CreateJSNumber(TypedArray::ElementSize(kind)));
+    ctor->AddProperty("prototype", TypedArray::typed_array_handle);
+    return wrapped_function;
+}
+
+}
+}
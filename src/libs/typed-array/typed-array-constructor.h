@@ -0,0 +1,25 @@
+#ifndef TYPED_ARRAY_CONSTRUCTOR_H_
+#define TYPED_ARRAY_CONSTRUCTOR_H_
+
+#include "object/argument.h"
+#include "object/typed-array.h"
+
+namespace grok {
+namespace libs {
+
+/// ArrayBufferConstructor ::= new ArrayBuffer(byteLength)
+extern std::shared_ptr<grok::obj::Object>
+    ArrayBufferConstructor(std::shared_ptr<grok::obj::Argument> Args);
+
+extern std::shared_ptr<grok::obj::Object> CreateArrayBufferConstructorObject();
+
+/// CreateTypedArrayConstructorObject ::= constructor of the typed arrays of
+/// the kind, called as new <kind>Array(length), new <kind>Array(array) or
+/// new <kind>Array(buffer, byteOffset, length)
+extern std::shared_ptr<grok::obj::Object>
+    CreateTypedArrayConstructorObject(grok::obj::TypedArrayKind kind);
+
+}
+}
+
+#endif
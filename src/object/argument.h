@@ -8,15 +8,16 @@ namespace obj {
 
 class Argument : public JSArray {
 public:
+    // natives refer to the handles of the arguments
     Argument() :
-        JSArray()
+        JSArray(ElementKind::generic)
     { }
 };
 
 static inline auto CreateArgumentObject()
 {
-    auto arg = std::make_shared<Argument>();
-    auto O = std::make_shared<Object>(arg);
+    auto arg = AllocateShared<Argument>();
+    auto O = AllocateShared<Object>(arg);
     return O;
 }
 
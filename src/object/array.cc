@@ -10,35 +10,187 @@
 #include "libs/array/shift-unshift.h"
 #include "libs/array/map.h"
 #include "libs/array/slice.h"
+#include "libs/array/numeric.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
 
 namespace grok {
 namespace obj {
 
+/// JoinStrings ::= joins the strings of the elements, which are all made
+/// before the result so that it is allocated only once
+template <typename ElementString>
+static std::string JoinStrings(size_t count, const std::string &sep,
+    ElementString element_string)
+{
+    std::vector<std::string> strings;
+    strings.reserve(count);
+    size_t length = count ? sep.size() * (count - 1) : 0;
+    for (size_t i = 0; i < count; i++) {
+        strings.push_back(element_string(i));
+        length += strings.back().size();
+    }
+
+    std::string buff;
+    buff.reserve(length);
+    for (size_t i = 0; i < strings.size(); i++) {
+        if (i)
+            buff += sep;
+        buff += strings[i];
+    }
+    return buff;
+}
+
 std::string JSArray::AsString() const
 {
-    std::string buff = "[ ";
-    for (const auto &element : elements_) {
-        buff += element->as<JSObject>()->AsString();
-        buff += ", ";
+    if (HasDoubleElements()) {
+        return "[ " + JoinStrings(doubles_.size(), ", ",
+            [this](size_t i) {
+                return CreateElement(doubles_[i])->as<JSObject>()->AsString();
+            }) + " ]";
     }
-    if (elements_.size()) {
-        buff.pop_back();
-        buff.pop_back();
+    return "[ " + JoinStrings(elements_.size(), ", ",
+        [this](size_t i) { return elements_[i]->as<JSObject>()->AsString(); })
+        + " ]";
+}
+
+std::string JSArray::Join(const std::string &sep) const
+{
+    if (HasDoubleElements()) {
+        return JoinStrings(doubles_.size(), sep, [this](size_t i) {
+            return IsHole(doubles_[i]) ? UndefinedObject::Get()->ToString()
+                : NumberToString(doubles_[i]);
+        });
     }
-    return buff + " ]";
+    return JoinStrings(elements_.size(), sep,
+        [this](size_t i) { return elements_[i]->as<JSObject>()->ToString(); });
 }
 
 std::string JSArray::ToString() const
 {
-    std::string buff = "";
-    for (const auto &element : elements_) {
-        buff += element->as<JSObject>()->ToString();
-        buff += ",";
+    return Join(",");
+}
+
+/// hole_bits ::= a signalling NaN, arithmetic never produces one
+static constexpr uint64_t hole_bits = 0x7FF4000000000000ULL;
+
+double JSArray::Hole()
+{
+    double hole;
+    std::memcpy(&hole, &hole_bits, sizeof(hole));
+    return hole;
+}
+
+bool JSArray::IsHole(double element)
+{
+    uint64_t bits;
+    std::memcpy(&bits, &element, sizeof(bits));
+    return bits == hole_bits;
+}
+
+/// IsInt32Element ::= true for the numbers a packed_int array may hold,
+/// -0 is not one of them
+static bool IsInt32Element(double number)
+{
+    return number >= INT32_MIN && number <= INT32_MAX
+        && number == static_cast<int32_t>(number)
+        && !(number == 0 && std::signbit(number));
+}
+
+/// ElementNumber ::= number held by the handle if it is a number
+static bool ElementNumber(const JSArray::HandlePointer &obj, double &number)
+{
+    auto O = obj->as<JSObject>();
+    if (O->GetType() == ObjectType::_double) {
+        number = obj->as<JSDouble>()->GetValue();
+        return true;
+    } else if (O->GetType() == ObjectType::_number) {
+        number = obj->as<JSNumber>()->GetValue();
+        return true;
     }
-    if (elements_.size()) {
-        buff.pop_back();
+    return false;
+}
+
+bool JSArray::StoreDouble(size_type idx, double number)
+{
+    if (!HasDoubleElements() || idx >= doubles_.size())
+        return false;
+
+    if (number != number)
+        number = std::numeric_limits<double>::quiet_NaN();
+    if (kind_ == ElementKind::packed_int && !IsInt32Element(number))
+        kind_ = ElementKind::packed_double;
+    doubles_[idx] = number;
+    return true;
+}
+
+void JSArray::Generalize()
+{
+    if (!HasDoubleElements())
+        return;
+
+    elements_.reserve(doubles_.size());
+    for (auto element : doubles_)
+        elements_.push_back(CreateElement(element));
+    std::vector<double>().swap(doubles_);
+    kind_ = ElementKind::generic;
+}
+
+void JSArray::Push(const HandlePointer &obj)
+{
+    double number;
+    if (HasDoubleElements()) {
+        if (ElementNumber(obj, number)) {
+            PushDouble(number);
+            return;
+        }
+        Generalize();
     }
-    return buff;
+    elements_.push_back(obj);
+}
+
+void JSArray::PushDouble(double number)
+{
+    if (!HasDoubleElements()) {
+        elements_.push_back(CreateJSNumber(number));
+        return;
+    }
+    doubles_.push_back(0);
+    StoreDouble(doubles_.size() - 1, number);
+}
+
+void JSArray::Assign(size_type idx, const HandlePointer &obj)
+{
+    if (idx > Size()) {
+        this->AddProperty(std::to_string(idx), obj);
+        return;
+    }
+
+    double number;
+    if (HasDoubleElements() && ElementNumber(obj, number)
+            && StoreDouble(idx, number))
+        return;
+    Generalize();
+    elements_[idx] = obj;
+}
+
+void JSArray::DoublesWritten()
+{
+    if (kind_ == ElementKind::packed_int
+            && !std::all_of(doubles_.begin(), doubles_.end(), IsInt32Element))
+        kind_ = ElementKind::packed_double;
+}
+
+JSArray::HandlePointer JSArray::CreateElement(double element)
+{
+    if (IsHole(element))
+        return CreateUndefinedObject();
+    return CreateJSNumber(element);
 }
 
 JSObject::Value JSArray::GetProperty(const JSObject::Name &name)
@@ -49,21 +201,34 @@ JSObject::Value JSArray::GetProperty(const JSObject::Name &name)
     return At(name);
 }
 
+/// IsIndex ::= true for a string of digits, which can't name a static
+/// property
+static bool IsIndex(const std::string &prop)
+{
+    return prop.size() && std::all_of(prop.begin(), prop.end(),
+        [](char c) { return c >= '0' && c <= '9'; });
+}
+
 JSArray::HandlePointer JSArray::At(const std::string &prop)
 {
-    auto p = GetStaticProperty(prop);
+    if (!IsIndex(prop)) {
+        auto p = GetStaticProperty(prop);
 
-    if (p.second) {
-        return p.first;
+        if (p.second) {
+            return p.first;
+        }
     }
 
-    size_type idx = 0;
-    // we still try to convert the string into number
-    try {
-        idx = std::stod(prop);
-    } catch (...) {
+    // we still try to convert the string into number, without throwing
+    // for the names which aren't one
+    const char *begin = prop.c_str();
+    char *end;
+    errno = 0;
+    auto number = std::strtod(begin, &end);
+    if (end == begin || errno == ERANGE)
         return JSObject::GetProperty(prop);
-    }
+
+    size_type idx = number;
     return this->At(idx);
 }
 
@@ -84,9 +249,6 @@ std::shared_ptr<Object> CreateArray(size_t size)
 {
     auto ptr = std::make_shared<JSArray>();
     ptr->Resize(size);
-    for (size_t i = 0; i < size; i++) {
-        ptr->Assign(i, CreateUndefinedObject());
-    }
     return std::make_shared<Handle>(ptr);
 }
 
@@ -157,6 +319,15 @@ void JSArray::Init()
     S->SetParams({ "start", "end" });
     S->SetNonEnumerable();
     ptr->AddProperty(std::string("slice"), std::make_shared<Object>(S));
+
+    // a.fill
+    S = std::make_shared<Function>(grok::libs::ArrayFill);
+    S->SetNonWritable();
+    S->SetParams({ "value" });
+    S->SetNonEnumerable();
+    ptr->AddProperty(std::string("fill"), std::make_shared<Object>(S));
+
+    grok::libs::DefineNumericMethods(ptr.get());
 }
 
 }
@@ -8,6 +8,18 @@
 
 namespace grok { namespace obj {
 
+/// ElementKind ::= how the elements of an array are stored. Arrays of
+/// numbers keep them as raw doubles and only get a handle per element
+/// when something other than a number is stored or a handle is asked
+/// for. Transitions only go down the list, an array never gets packed
+/// again.
+enum class ElementKind {
+  packed_int,       // doubles which are all int32
+  packed_double,    // doubles
+  holey_double,     // doubles, some are holes which read as undefined
+  generic           // a handle for every element
+};
+
 class JSArray : public JSObject {
 public:
   using HandlePointer = std::shared_ptr<Handle>;
@@ -16,27 +28,38 @@ public:
   using reverse_iterator 
         = std::vector<HandlePointer>::reverse_iterator;
 
-  JSArray(const std::vector<HandlePointer> &elements) { elements_ = elements; }
+  JSArray(const std::vector<HandlePointer> &elements)
+    : kind_{ ElementKind::generic }
+  { elements_ = elements; }
 
-  JSArray() {}
+  JSArray() : kind_{ ElementKind::packed_int } {}
 
   JSArray(const JSArray &arr) { // create a object by a copy from other object
+    kind_ = arr.kind_;
+    doubles_ = arr.doubles_;
     elements_ = (arr.elements_);
   }
 
   JSArray &operator=(const JSArray &arr) { // assign an other array
+    kind_ = arr.kind_;
+    doubles_ = arr.doubles_;
     elements_ = arr.elements_;
     return (*this);
   }
 
   HandlePointer operator[](int i) { // no index checking
+    Generalize();
     return elements_[i];
   }
 
+  /// At ::= element at the index, elements of arrays of numbers have no
+  /// handle of their own so they get a new one which is only for reading
   HandlePointer At(size_type i) {
     if (i >= Size()) {
       return JSObject::GetProperty(std::to_string(i));
     }
+    if (HasDoubleElements())
+      return CreateElement(doubles_[i]);
     return elements_[i];
   }
 
@@ -44,7 +67,7 @@ public:
 
   size_type Size() const
   { // returns the size of the vector
-    return elements_.size();
+    return HasDoubleElements() ? doubles_.size() : elements_.size();
   }
 
   ObjectType GetType() const override
@@ -52,7 +75,38 @@ public:
     return ObjectType::_array;
   }
 
+  ElementKind Kind() const { return kind_; }
+
+  bool HasDoubleElements() const { return kind_ != ElementKind::generic; }
+
+  /// Doubles ::= raw storage of an array with double elements
+  std::vector<double> &Doubles() { return doubles_; }
+
+  /// Hole ::= the NaN marking an element of a holey array, NaNs stored
+  /// by the script are always the canonical one
+  static double Hole();
+  static bool IsHole(double element);
+
+  /// StoreDouble ::= stores a number into an array of doubles, returns
+  /// false when the array has handles or the index is out of range
+  bool StoreDouble(size_type idx, double number);
+
+  /// DoublesWritten ::= the doubles were written in bulk through Doubles(),
+  /// a packed_int array becomes packed_double unless all are still int32
+  void DoublesWritten();
+
+  /// Generalize ::= gives every element a handle, from now on the array
+  /// is generic
+  void Generalize();
+
   bool Erase(size_type idx) { // erases the element
+    if (HasDoubleElements()) {
+      if (idx < Size()) {
+        doubles_[idx] = Hole();
+        kind_ = ElementKind::holey_double;
+      }
+      return true;
+    }
     if (idx < Size())
       elements_[idx];
     elements_[idx] = CreateUndefinedObject();
@@ -60,63 +114,110 @@ public:
   }
 
   bool Empty() const { // returns true if the array is empty
-    return elements_.empty();
+    return Size() == 0;
   }
 
   void Resize(size_type sz)
   {
+    if (HasDoubleElements()) {
+      if (sz > doubles_.size())
+        kind_ = ElementKind::holey_double;
+      doubles_.resize(sz, Hole());
+      return;
+    }
     elements_.resize(sz, CreateUndefinedObject());
   }
 
-  void Push(const HandlePointer &obj) { // pushes the element to the last
-    elements_.push_back(obj);
+  void Push(const HandlePointer &obj); // pushes the element to the last
+
+  /// PushDouble ::= pushes a number, it gets a handle only when the array
+  /// is generic
+  void PushDouble(double number);
+
+  void Reserve(size_type sz)
+  {
+    if (HasDoubleElements())
+      doubles_.reserve(sz);
+    else
+      elements_.reserve(sz);
   }
 
   HandlePointer Pop() { // pops the last element
+    if (HasDoubleElements()) {
+      auto ret = CreateElement(doubles_.back());
+      doubles_.pop_back();
+      return ret;
+    }
     auto ret = elements_.back();
     elements_.pop_back();
     return ret;
   }
 
-  void Assign(size_type idx, const HandlePointer &obj)
+  void Assign(size_type idx, const HandlePointer &obj);
+
+  void Clear() { doubles_.clear(); elements_.clear(); }
+
+  void Trace(std::vector<JSObject::Value*> &refs) override
   {
-    if (idx > Size()) {
-      this->AddProperty(std::to_string(idx), obj);
-      return;
+    JSObject::Trace(refs);
+    for (auto &element : elements_) {
+      if (element)
+        refs.push_back(&element);
     }
-    elements_[idx] = obj;
   }
 
-  void Clear() { elements_.clear(); }
+  void ReleaseReferences() override
+  {
+    JSObject::ReleaseReferences();
+    doubles_.clear();
+    elements_.clear();
+  }
+
+  // iterators refer to the handles, so they make the array generic
 
   iterator begin()
   {
+    Generalize();
     return elements_.begin();
   }
 
   iterator end()
   {
+    Generalize();
     return elements_.end();
   }
 
   reverse_iterator rbegin()
   {
+    Generalize();
     return elements_.rbegin();
   }
 
   reverse_iterator rend()
   {
+    Generalize();
     return elements_.rend();
   }
 
   std::string ToString() const override;
 
+  /// Join ::= strings of the elements separated by sep
+  std::string Join(const std::string &sep) const;
+
   std::string AsString() const override;
 
   JSObject::Value GetProperty(const JSObject::Name &name) override;
 
-  auto &Container() { return elements_; }
+  auto &Container() { Generalize(); return elements_; }
+
+protected:
+  explicit JSArray(ElementKind kind) : kind_{ kind } {}
+
 private:
+  static HandlePointer CreateElement(double element);
+
+  ElementKind kind_;
+  std::vector<double> doubles_;
   std::vector<HandlePointer> elements_;
 
 public:
@@ -0,0 +1,68 @@
+#include "object/atom.h"
+
+#include <deque>
+#include <unordered_map>
+
+namespace grok {
+namespace obj {
+
+namespace {
+
+struct Table {
+    Table()
+    {
+        for (auto name : { "", "this" }) {
+            atoms.emplace(name, static_cast<Atom>(names.size()));
+            names.push_back(name);
+        }
+    }
+
+    // a deque never moves its strings, Name() returns references to them
+    std::deque<std::string> names;
+    std::unordered_map<std::string, Atom> atoms;
+};
+
+Table &GetTable()
+{
+    // leaked on purpose, atoms may be used while statics are destroyed
+    static auto table = new Table();
+    return *table;
+}
+
+}
+
+Atom AtomTable::Intern(const std::string &str)
+{
+    auto &table = GetTable();
+    auto it = table.atoms.find(str);
+    if (it != table.atoms.end())
+        return it->second;
+
+    auto atom = static_cast<Atom>(table.names.size());
+    table.names.push_back(str);
+    table.atoms.emplace(table.names.back(), atom);
+    return atom;
+}
+
+bool AtomTable::Find(const std::string &str, Atom &atom)
+{
+    auto &table = GetTable();
+    auto it = table.atoms.find(str);
+    if (it == table.atoms.end())
+        return false;
+    atom = it->second;
+    return true;
+}
+
+const std::string &AtomTable::Name(Atom atom)
+{
+    return GetTable().names[atom];
+}
+
+size_t AtomTable::Size()
+{
+    return GetTable().names.size();
+}
+
+} // obj
+} // grok
@@ -0,0 +1,41 @@
+#ifndef ATOM_H_
+#define ATOM_H_
+
+#include <cstdint>
+#include <string>
+
+namespace grok {
+namespace obj {
+
+/// Atom ::= number of an interned string. Names of variables and
+/// properties are interned when the code is assembled, so the VM, shapes
+/// and scopes compare and hash integers instead of strings. Atoms are
+/// never freed, the first ones are always the same.
+using Atom = uint32_t;
+
+enum : Atom {
+    atom_empty = 0,
+    atom_this = 1
+};
+
+/// AtomTable ::= the global table of interned strings
+class AtomTable {
+public:
+    /// Intern ::= returns the atom of the string, interning it if needed
+    static Atom Intern(const std::string &str);
+
+    /// Find ::= returns true and sets atom if the string was interned,
+    /// a name which was never interned can't be the name of a property
+    static bool Find(const std::string &str, Atom &atom);
+
+    /// Name ::= returns the string of the atom
+    static const std::string &Name(Atom atom);
+
+    /// Size ::= number of atoms
+    static size_t Size();
+};
+
+} // obj
+} // grok
+
+#endif // atom.h
@@ -0,0 +1,58 @@
+#ifndef ENVIRONMENT_H_
+#define ENVIRONMENT_H_
+
+#include "object/jsobject.h"
+
+#include <vector>
+
+namespace grok {
+namespace obj {
+
+/// Environment ::= variables of a call which are captured by the closures
+/// created during the call, they outlive the call as long as one of the
+/// closures does. outer is the environment the called function closed
+/// over, a slot is empty till the variable has been declared
+class Environment : public JSObject {
+public:
+  Environment(size_t size, std::shared_ptr<Handle> outer)
+    : slots_(size), outer_{ std::move(outer) }
+  { }
+
+  std::shared_ptr<Handle> &Slot(size_t idx) { return slots_[idx]; }
+
+  const std::shared_ptr<Handle> &Outer() const { return outer_; }
+
+  void Trace(std::vector<JSObject::Value*> &refs) override
+  {
+    JSObject::Trace(refs);
+    for (auto &slot : slots_) {
+      if (slot)
+        refs.push_back(&slot);
+    }
+    if (outer_)
+      refs.push_back(&outer_);
+  }
+
+  void ReleaseReferences() override
+  {
+    JSObject::ReleaseReferences();
+    slots_.clear();
+    outer_.reset();
+  }
+
+private:
+  std::vector<std::shared_ptr<Handle>> slots_;
+  std::shared_ptr<Handle> outer_;
+};
+
+static inline std::shared_ptr<Object>
+CreateEnvironment(size_t size, std::shared_ptr<Handle> outer)
+{
+  auto E = AllocateShared<Environment>(size, std::move(outer));
+  return AllocateShared<Object>(E);
+}
+
+} // obj
+} // grok
+
+#endif // environment.h
@@ -3,6 +3,7 @@
 #include "vm/codegen.h"
 #include "vm/vm.h"
 
+#include <map>
 #include <sstream>
 
 namespace grok {
@@ -12,18 +13,34 @@ using namespace grok::parser;
 
 Function::Function()
     : JSObject{}, AST{}, Proto{ nullptr }, NFT{ nullptr },
-      Native{ false }, CodeGened{ false }, IR{}, Params{ }
+      FastNFT{ nullptr }, Native{ false }, CodeGened{ false }, IR{},
+      Params{ }, ParamAtoms{ }, FrameSize{ 0 }, Names{ }, Scope{ },
+      EnvSize{ 0 }, CapturedParams{ }, Closure{ }, Calls{ 0 }, Jit{ }
 { }
 
 Function::Function(std::shared_ptr<grok::parser::Expression> AST,
     std::shared_ptr<grok::parser::FunctionPrototype> proto)
     : JSObject(), AST{ AST }, Proto{ proto }, NFT{ nullptr },
-      Native{ false }, CodeGened{ false }, IR{}, Params{ Proto->GetArgs() }
-{ }
+      FastNFT{ nullptr }, Native{ false }, CodeGened{ false }, IR{},
+      Params{ Proto->GetArgs() }, ParamAtoms{ }, FrameSize{ 0 }, Names{ },
+      Scope{ }, EnvSize{ 0 }, CapturedParams{ }, Closure{ }, Calls{ 0 },
+      Jit{ }
+{
+    InternParams();
+}
 
 Function::Function(NativeFunctionType function)
     : JSObject{}, AST{}, Proto{ nullptr }, NFT{ function },
-      Native{ true }, CodeGened{ true }, IR{}, Params{}
+      FastNFT{ nullptr }, Native{ true }, CodeGened{ true }, IR{}, Params{},
+      ParamAtoms{}, FrameSize{ 0 }, Names{ }, Scope{ }, EnvSize{ 0 },
+      CapturedParams{ }, Closure{ }, Calls{ 0 }, Jit{ }
+{ }
+
+Function::Function(FastNativeType function)
+    : JSObject{}, AST{}, Proto{ nullptr }, NFT{ nullptr },
+      FastNFT{ function }, Native{ true }, CodeGened{ true }, IR{}, Params{},
+      ParamAtoms{}, FrameSize{ 0 }, Names{ }, Scope{ }, EnvSize{ 0 },
+      CapturedParams{ }, Closure{ }, Calls{ 0 }, Jit{ }
 { }
 
 std::string Function::AsString() const
@@ -70,11 +87,59 @@ void Function::PrepareFunction()
 
     CodeGenerator Generator;
     Generator.SetInsideFunction();
+    Generator.SetScope(Scope);
+    Generator.SetParams(Params);
     Generator.Generate(AST.get());
-    IR = Generator.GetIR();
+    IR = Generator.GetCode();
+    FrameSize = Generator.GetFrameSize();
+    for (const auto &Local : Generator.GetLocals())
+        Names.emplace_back(AtomTable::Intern(Local.first), Local.second);
     CodeGened = true;
 }
 
+void Function::SetScope(const std::vector<std::string> &captured,
+    const std::set<std::string> &free, std::shared_ptr<LexicalScope> outer)
+{
+    Scope = std::make_shared<LexicalScope>();
+    Scope->free = free;
+    Scope->outer = outer;
+    for (const auto &name : captured)
+        Scope->captured.emplace(name, Scope->captured.size());
+    EnvSize = captured.size();
+
+    // a repeated param name refers to the last one
+    CapturedParams.clear();
+    std::map<size_t, size_t> params;
+    for (size_t i = 0; i < Params.size(); i++) {
+        auto slot = Scope->captured.find(Params[i]);
+        if (slot != Scope->captured.end())
+            params[slot->second] = i;
+    }
+    for (const auto &param : params)
+        CapturedParams.emplace_back(param.second, param.first);
+}
+
+std::shared_ptr<Handle> Function::CreateClosure(std::shared_ptr<Handle> env)
+{
+    // the code is generated once for all the closures of the function
+    PrepareFunction();
+    auto F = std::make_shared<Function>(*this);
+    F->Closure = std::move(env);
+    F->Calls = 0;
+    F->AddProperty("prototype", CreateJSObject());
+    return std::make_shared<Object>(F);
+}
+
+JitCode *Function::GetHotCode(size_t threshold)
+{
+#ifdef GROK_BASELINE_JIT
+    // compiled only once, a function which can't be compiled never will
+    if (!Jit && Calls++ == threshold)
+        Jit = JitCode::Compile(*IR);
+#endif
+    return Jit.get();
+}
+
 bool Function::IsNative() const 
 {
     return Native;
@@ -94,9 +159,21 @@ const std::vector<std::string> &Function::GetParams() const
     return Params;
 }
 
+void Function::InternParams()
+{
+    ParamAtoms.clear();
+    for (const auto &Param : Params)
+        ParamAtoms.push_back(AtomTable::Intern(Param));
+}
+
 Value Function::CallNative(std::vector<grok::vm::Value> &Args,
     std::shared_ptr<Handle> This)
 {
+    if (FastNFT) {
+        NativeArgs FastArgs{ Args.data(), Args.size(), This };
+        return FastNFT(FastArgs);
+    }
+
     auto Obj = CreateArgumentObject();
     auto ArgObj = Obj->as<Argument>();
     size_t idx = 0, max = 0;
@@ -157,7 +234,7 @@ std::shared_ptr<Object> CallJSFunction(std::shared_ptr<Function> func,
     ib->AddInstruction(std::move(instr));
     
     ib->Finalize();
-    std::shared_ptr<InstructionList> ir = ib->ReleaseInstructionList();
+    auto ir = Assemble(*ib->ReleaseInstructionList());
 
     // transfer the control
     vm->SaveState();
@@ -182,7 +259,7 @@ std::shared_ptr<Object> CallJSFunction(std::shared_ptr<Function> func,
 void CreateInterruptRequest(std::shared_ptr<Function> func,
         std::shared_ptr<Argument> Args, VM* vm)
 {
-    static std::vector<std::shared_ptr<InstructionList>> st;
+    static std::vector<std::shared_ptr<Code>> st;
     auto ib = InstructionBuilder::CreateBuilder();
     ib->CreateBlock();
 
@@ -199,7 +276,7 @@ void CreateInterruptRequest(std::shared_ptr<Function> func,
     ib->AddInstruction(std::move(instr));
     
     ib->Finalize();
-    std::shared_ptr<InstructionList> ir = ib->ReleaseInstructionList();
+    auto ir = Assemble(*ib->ReleaseInstructionList());
     st.push_back(ir);
     // transfer the control
     // TODO: The result of this interrupt must be stored somewhere
@@ -266,7 +343,7 @@ std::shared_ptr<Handle> Function::st_func_handle    ;
 
 void Function::Init()
 {
-    st_func_handle = CreateFunction(nullptr);
+    st_func_handle = CreateFunction(NativeFunctionType{ nullptr });
     auto st_func = st_func_handle->as<Function>();
 
     auto function_handle = CreateFunction(JSFunctionApply);
@@ -4,23 +4,29 @@
 #include "object/jsobject.h"
 #include "parser/functionstatement.h"
 #include "object/argument.h"
+#include "object/native-args.h"
 #include "vm/instruction-list.h"
 #include "vm/context.h"
 #include "vm/counter.h"
 
+#include <set>
 #include <string>
 #include <vector>
 
 namespace grok {
 namespace vm {
 class VM;
+class JitCode;
+struct LexicalScope;
 }
 }
 
 namespace grok {
 namespace obj {
 
-/// NativeFunctionType ::= captures the type of the native function
+/// NativeFunctionType ::= captures the type of the native function of
+/// the old calling convention, which gets its arguments in an Argument
+/// object. The fast one is FastNativeType (see native-args.h)
 using NativeFunctionType = std::shared_ptr<Object> (*)
                     (std::shared_ptr<grok::obj::Argument>);
 
@@ -31,6 +37,7 @@ public:
     Function(std::shared_ptr<grok::parser::Expression> AST,
         std::shared_ptr<grok::parser::FunctionPrototype> proto);
     Function(NativeFunctionType function);
+    Function(FastNativeType function);
     ~Function() { };
 
     /// HasCodeGened ::= returns true if code for the function
@@ -46,16 +53,76 @@ public:
     /// IsNative ::= returns true this function holds a native handler
     bool IsNative() const;
 
+    /// IsFastNative ::= the native handler has the fast calling convention
+    bool IsFastNative() const { return FastNFT != nullptr; }
+
+    /// CallFastNative ::= calls the native handler of the fast calling
+    /// convention, IsFastNative() must be true
+    grok::vm::Value CallFastNative(NativeArgs &Args) { return FastNFT(Args); }
+
     /// GetAddress ::= returns the starting address of code
     grok::vm::Counter GetAddress();
 
     /// GetArgs ::= returns the argument vector
     const std::vector<std::string> &GetParams() const;
 
+    /// GetParamAtoms ::= returns the atoms of the parameters
+    const std::vector<Atom> &GetParamAtoms() const { return ParamAtoms; }
+
     grok::vm::Counter GetEnd()
     {
         return IR->end();
     }
+
+    /// GetFrameSize ::= number of slots the function's locals need
+    size_t GetFrameSize() const { return FrameSize; }
+
+    /// GetLocalNames ::= names of the slots, variables of the function are
+    /// looked up by them when they are referred to by name
+    const grok::vm::LocalNames &GetLocalNames() const { return Names; }
+
+    /// SetScope ::= the variables of the function which closures capture
+    /// and the names it refers to without declaring them, outer is the
+    /// scope of the function the function is nested in
+    void SetScope(const std::vector<std::string> &captured,
+        const std::set<std::string> &free,
+        std::shared_ptr<grok::vm::LexicalScope> outer);
+
+    /// GetEnvSize ::= number of slots of the environment created by a
+    /// call, 0 if the function has no captured variables
+    size_t GetEnvSize() const { return EnvSize; }
+
+    /// GetCapturedParams ::= slots of the params which are captured and
+    /// their slots in the environment
+    const std::vector<std::pair<size_t, size_t>> &GetCapturedParams() const
+    {
+        return CapturedParams;
+    }
+
+    /// GetClosure ::= environment the function closed over, nullptr if
+    /// it wasn't created by `clos`
+    const std::shared_ptr<Handle> &GetClosure() const { return Closure; }
+
+    /// CreateClosure ::= a new function sharing the code of this one
+    /// which closes over env
+    std::shared_ptr<Handle> CreateClosure(std::shared_ptr<Handle> env);
+
+    void Trace(std::vector<JSObject::Value*> &refs) override
+    {
+        JSObject::Trace(refs);
+        if (Closure)
+            refs.push_back(&Closure);
+    }
+
+    void ReleaseReferences() override
+    {
+        JSObject::ReleaseReferences();
+        Closure.reset();
+    }
+
+    /// GetHotCode ::= counts a call of the function, returns its machine
+    /// code once it has been called threshold times (nullptr till then)
+    grok::vm::JitCode *GetHotCode(size_t threshold);
     ObjectType GetType() const override
     { return ObjectType::_function; }
 
@@ -66,6 +133,7 @@ public:
     void SetParams(std::vector<std::string> parms)
     {
         Params = parms;
+        InternParams();
     }
 
     virtual grok::vm::Value CallNative(std::vector<grok::vm::Value> &Args,
@@ -74,13 +142,25 @@ public:
     std::shared_ptr<Handle> GetProperty(const std::string &str) override;
 
 protected:
+    void InternParams();
+
     std::shared_ptr<grok::parser::Expression> AST;
     std::shared_ptr<grok::parser::FunctionPrototype> Proto;
     NativeFunctionType NFT;
+    FastNativeType FastNFT;
     bool Native;
     bool CodeGened;     // for delayed code generation
-    std::shared_ptr<grok::vm::InstructionList> IR;
+    std::shared_ptr<grok::vm::Code> IR;
     std::vector<std::string> Params;
+    std::vector<Atom> ParamAtoms;
+    size_t FrameSize;
+    grok::vm::LocalNames Names;
+    std::shared_ptr<grok::vm::LexicalScope> Scope;
+    size_t EnvSize;
+    std::vector<std::pair<size_t, size_t>> CapturedParams;
+    std::shared_ptr<Handle> Closure;
+    size_t Calls;       // calls before the function got compiled
+    std::shared_ptr<grok::vm::JitCode> Jit;
 
 public:
     static std::shared_ptr<Handle> st_func_handle;    // acts as constructor
@@ -108,6 +188,14 @@ CreateFunction(NativeFunctionType NFT)
     return std::make_shared<Object>(F);
 }
 
+static inline std::shared_ptr<Object>
+CreateFunction(FastNativeType NFT)
+{
+    auto F = std::make_shared<Function>(NFT);
+    F->AddProperty("prototype", CreateJSObject());
+    return std::make_shared<Object>(F);
+}
+
 static inline bool
 IsFunction(std::shared_ptr<Object> obj)
 {
@@ -0,0 +1,187 @@
+#include "object/gc.h"
+#include "object/jsbasicobject.h"
+
+#include <chrono>
+#include <unordered_map>
+#include <vector>
+
+namespace grok {
+namespace obj {
+
+JSObject *Heap::head_ = nullptr;
+size_t Heap::live_ = 0;
+size_t Heap::allocated_ = 0;
+size_t Heap::threshold_ = Heap::MinThreshold;
+size_t Heap::collections_ = 0;
+size_t Heap::freed_ = 0;
+double Heap::total_ms_ = 0;
+double Heap::max_ms_ = 0;
+
+void Heap::Track(JSObject *obj)
+{
+    obj->gc_prev_ = nullptr;
+    obj->gc_next_ = head_;
+    if (head_)
+        head_->gc_prev_ = obj;
+    head_ = obj;
+    live_++;
+    allocated_++;
+}
+
+void Heap::Untrack(JSObject *obj)
+{
+    if (obj->gc_prev_)
+        obj->gc_prev_->gc_next_ = obj->gc_next_;
+    else
+        head_ = obj->gc_next_;
+    if (obj->gc_next_)
+        obj->gc_next_->gc_prev_ = obj->gc_prev_;
+    live_--;
+}
+
+namespace {
+
+// what the collector knows about a handle referenced from the heap
+struct HandleInfo {
+    long internal = 0;  // references from the heap
+    long count = 0;     // all references
+};
+
+// what the collector knows about an object
+struct ObjectInfo {
+    long internal = 0;  // handles in the heap which refer to the object
+    long count = 0;     // all references to the object
+    bool marked = false;
+    JSObject::Value *referrer = nullptr; // one of the handles from the heap
+    std::vector<JSObject::Value*> refs;
+};
+
+}
+
+void Heap::Collect()
+{
+    auto start = std::chrono::high_resolution_clock::now();
+
+    std::unordered_map<JSObject*, ObjectInfo> objects;
+    std::unordered_map<Handle*, HandleInfo> handles;
+    objects.reserve(live_);
+
+    // find the references between the objects, the traversal must not
+    // copy any handle otherwise the counts are off
+    for (auto obj = head_; obj; obj = obj->gc_next_) {
+        auto &info = objects[obj];
+        obj->Trace(info.refs);
+        for (auto ref : info.refs) {
+            auto &h = handles[ref->get()];
+            h.internal++;
+            h.count = ref->use_count();
+        }
+    }
+
+    for (auto &obj : objects) {
+        for (auto ref : obj.second.refs) {
+            if (ref->get()->empty())
+                continue;
+            auto target = objects.find(ref->get()->get<JSObject>());
+            if (target == objects.end())
+                continue;
+            if (!target->second.referrer) {
+                // every handle in the heap adds one reference to the
+                // object, count each handle only once
+                target->second.count = ref->get()->use_count();
+            }
+            target->second.referrer = ref;
+        }
+    }
+    for (auto &h : handles) {
+        if (h.first->empty())
+            continue;
+        auto target = objects.find(h.first->get<JSObject>());
+        if (target != objects.end())
+            target->second.internal++;
+    }
+
+    // roots are the objects and handles referenced from outside the heap
+    std::vector<JSObject*> worklist;
+    for (auto &obj : objects) {
+        if (obj.second.internal == 0
+                || obj.second.count > obj.second.internal) {
+            obj.second.marked = true;
+            worklist.push_back(obj.first);
+        }
+    }
+    for (auto &h : handles) {
+        if (h.second.count <= h.second.internal || h.first->empty())
+            continue;
+        auto target = objects.find(h.first->get<JSObject>());
+        if (target != objects.end() && !target->second.marked) {
+            target->second.marked = true;
+            worklist.push_back(target->first);
+        }
+    }
+
+    while (!worklist.empty()) {
+        auto obj = worklist.back();
+        worklist.pop_back();
+        for (auto ref : objects[obj].refs) {
+            if (ref->get()->empty())
+                continue;
+            auto target = objects.find(ref->get()->get<JSObject>());
+            if (target != objects.end() && !target->second.marked) {
+                target->second.marked = true;
+                worklist.push_back(target->first);
+            }
+        }
+    }
+
+    // hold every garbage object while the cycles are broken, so that
+    // none of them is freed while another one still refers to it
+    std::vector<JSObject::Value> garbage;
+    std::vector<JSObject*> unreachable;
+    for (auto &obj : objects) {
+        if (obj.second.marked)
+            continue;
+        garbage.push_back(*obj.second.referrer);
+        unreachable.push_back(obj.first);
+    }
+    objects.clear();
+    handles.clear();
+
+    for (auto obj : unreachable) {
+        obj->ReleaseReferences();
+    }
+    garbage.clear();
+
+    // the threshold grows with the live objects, and keeps on doubling as
+    // long as the collections find nothing to free, a program building a
+    // large graph which stays reachable would otherwise trace all of it
+    // again and again
+    size_t threshold = 2 * live_;
+    if (threshold < MinThreshold)
+        threshold = MinThreshold;
+    if (unreachable.empty() && threshold < 2 * threshold_)
+        threshold = 2 * threshold_;
+    threshold_ = threshold;
+
+    freed_ += unreachable.size();
+    collections_++;
+    allocated_ = 0;
+
+    auto end = std::chrono::high_resolution_clock::now();
+    auto ms = std::chrono::duration_cast<std::chrono::microseconds>(
+        end - start).count() / 1000.0;
+    total_ms_ += ms;
+    if (ms > max_ms_)
+        max_ms_ = ms;
+}
+
+void Heap::PrintStats(std::ostream &os)
+{
+    os << "[ GC: " << collections_ << " collections, " << freed_
+        << " objects freed from cycles, " << live_ << " live objects, "
+        << total_ms_ << "ms total, " << max_ms_ << "ms longest pause ]"
+        << std::endl;
+}
+
+} // obj
+} // grok
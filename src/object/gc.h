@@ -0,0 +1,68 @@
+#ifndef GC_H_
+#define GC_H_
+
+#include <cstddef>
+#include <iostream>
+
+namespace grok {
+namespace obj {
+
+class JSObject;
+
+/// Heap ::= cycle collector on top of reference counting. Objects are
+/// still owned by shared_ptr's and freed as soon as nothing points to
+/// them, the collector only reclaims the cycles which reference counting
+/// leaks. It is not a replacement of the reference counts: the VM stack
+/// still pays for them on every push and pop, and every allocation pays
+/// for linking the object into the heap.
+/// A collection traces the references between the objects, anything
+/// referenced more often than the objects themselves reference it is
+/// held from outside the heap i.e. by the VM stacks, scopes, instruction
+/// constants or native code and is a root. The roots are found from the
+/// counts only, the VM is never scanned. Objects not reachable from the
+/// roots are garbage, dropping their references frees them.
+class Heap {
+public:
+    /// MinThreshold ::= allocations between two collections, the actual
+    /// threshold is twice the number of objects which survive and doubles
+    /// after every collection which frees nothing
+    static constexpr size_t MinThreshold = 20000;
+
+    /// Track ::= links a new object into the heap
+    static void Track(JSObject *obj);
+
+    /// Untrack ::= unlinks an object which is being destroyed
+    static void Untrack(JSObject *obj);
+
+    /// ShouldCollect ::= returns true if enough objects were allocated
+    /// since the last collection
+    static bool ShouldCollect() { return allocated_ >= threshold_; }
+
+    /// Collect ::= frees the objects which are only reachable from cycles,
+    /// must only be called when no raw pointer to an object is in use
+    /// i.e. between two instructions
+    static void Collect();
+
+    /// Freed ::= number of objects freed from cycles so far
+    static size_t Freed() { return freed_; }
+
+    /// PrintStats ::= prints the counters of the collector
+    static void PrintStats(std::ostream &os);
+
+private:
+    static JSObject *head_;
+    static size_t live_;
+    static size_t allocated_;
+    static size_t threshold_;
+
+    // statistics
+    static size_t collections_;
+    static size_t freed_;
+    static double total_ms_;
+    static double max_ms_;
+};
+
+} // obj
+} // grok
+
+#endif // gc.h
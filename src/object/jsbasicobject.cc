@@ -10,7 +10,7 @@ std::string JSObject::AsString() const
 {
     std::string buff = "";
     buff += "{\n";
-    for (const auto &it : object_) {
+    for (const auto &it : *this) {
         auto prop = it.second->as<JSObject>();
         if (!prop->IsEnumerable())
             continue;
@@ -26,6 +26,60 @@ std::string JSObject::AsString() const
     return buff;
 }
 
+void JSObject::ToDictionary()
+{
+    dictionary_ = shape_->CloneAsDictionary();
+    shape_ = dictionary_.get();
+}
+
+void JSObject::AddProperty(const Name &name, const Value &prop)
+{
+    // a name which isn't interned yet is interned only if the object
+    // keeps a shape of the tree, a dictionary stores it by its string
+    Atom atom;
+    if (AtomTable::Find(name, atom) || (!shape_->IsDictionary()
+            && shape_->Size() < Shape::MaxTreeProperties)) {
+        AddProperty(AtomTable::Intern(name), prop);
+        return;
+    }
+
+    if (auto slot = FindSlot(name)) {
+        *slot = prop;
+        return;
+    }
+    if (!shape_->IsDictionary())
+        ToDictionary();
+    shape_ = shape_->AddProperty(name);
+    slots_.push_back(prop);
+}
+
+void JSObject::AddProperty(Atom atom, const Value &prop)
+{
+    if (auto slot = FindSlot(atom)) {
+        *slot = prop;
+        return;
+    }
+
+    auto next = shape_->AddProperty(atom);
+    if (!next) {
+        ToDictionary();
+        next = shape_->AddProperty(atom);
+    }
+    shape_ = next;
+    slots_.push_back(prop);
+}
+
+void JSObject::RemoveProperty(const Name &name)
+{
+    if (!HasProperty(name))
+        return;
+    if (!shape_->IsDictionary())
+        ToDictionary();
+
+    *FindSlot(name) = nullptr;
+    shape_->RemoveProperty(name);
+}
+
 std::string JSObject::ToString() const
 {
     return "[ object Object ]";
@@ -98,23 +152,23 @@ std::pair<std::shared_ptr<Handle>, bool>
     return { proto->GetProperty(name), true };
 }
 
-std::shared_ptr<Handle> JSObject::GetProperty(const std::string &name)
+std::shared_ptr<Handle> JSObject::FindProperty(const std::string &name)
 {
     // if the object has its own custom property, then go for it
-    if (HasProperty(name)) {
-        return object_.find(name)->second;
+    if (auto slot = FindSlot(name)) {
+        return *slot;
     }
 
-    auto ctor_it = object_.find("constructor");
+    auto ctor = FindSlot("constructor");
 
     std::pair<std::shared_ptr<Handle>, bool> p;
 
-    if (name == "constructor" && ctor_it != object_.end()) {
-        return ctor_it->second;
+    if (name == "constructor" && ctor) {
+        return *ctor;
     }
     // check for inherited property
-    if (ctor_it != object_.end()) {
-        p = CheckForInheritedProperty(name, ctor_it->second);
+    if (ctor) {
+        p = CheckForInheritedProperty(name, *ctor);
     }
     if (!p.second) {
         // check for built-in property
@@ -123,11 +177,18 @@ std::shared_ptr<Handle> JSObject::GetProperty(const std::string &name)
     if (p.second) {
         return p.first;
     }
-    auto value = object_.find(name);
-    if ((value) != object_.end()) {
-        return value->second;
-    }
+    return nullptr;
+}
+
+std::shared_ptr<Handle> JSObject::GetProperty(const std::string &name)
+{
+    if (auto prop = FindProperty(name))
+        return prop;
+
     auto def = CreateUndefinedObject();
+    // undefined and null are shared by everyone, they never get properties
+    if (this == UndefinedObject::Get().get() || this == JSNull::Get().get())
+        return def;
     AddProperty(name, def); // an ugly hack to add properties at runtime
     return def;
 }
@@ -162,10 +223,25 @@ void DefineInternalObjectProperties(JSObject *obj)
     obj->AddProperty("prototype", std::make_shared<Handle>(o));
 }
 
+const std::shared_ptr<UndefinedObject> &UndefinedObject::Get()
+{
+    // leaked on purpose, handles may outlive every static
+    static auto undefined = new std::shared_ptr<UndefinedObject>(
+        std::make_shared<UndefinedObject>());
+    return *undefined;
+}
+
+const std::shared_ptr<JSNull> &JSNull::Get()
+{
+    static auto null = new std::shared_ptr<JSNull>(
+        std::make_shared<JSNull>());
+    return *null;
+}
+
 std::shared_ptr<Object> CreateJSObject()
 {
-    auto O = std::make_shared<JSObject>();
-    return std::make_shared<Object>(O);
+    auto O = AllocateShared<JSObject>();
+    return AllocateShared<Object>(O);
 }
 
 std::shared_ptr<Object> CreateCopy(std::shared_ptr<Object> obj)
@@ -175,7 +251,8 @@ std::shared_ptr<Object> CreateCopy(std::shared_ptr<Object> obj)
             return CreateJSNumber(obj->as<JSNumber>()->GetNumber());
         return CreateJSNumber(obj->as<JSDouble>()->GetNumber());
     } else if (IsJSString(obj)) {
-        return CreateJSString(obj->as<JSString>()->ToString());
+        // a long string is copied by referring to it
+        return CreateJSRope(obj->as<JSString>(), nullptr);
     }
     // else return reference
     return obj;
@@ -1,9 +1,14 @@
 #ifndef OBJECT_H_
 #define OBJECT_H_
 
+#include "object/gc.h"
 #include "object/object.h"
+#include "object/pool.h"
+#include "object/shape.h"
 
 #include <map>
+#include <memory>
+#include <vector>
 
 namespace grok { namespace obj {
 
@@ -18,7 +23,9 @@ enum class ObjectType {
   _object,
   _array,
   _argument,
-  _function
+  _function,
+  _array_buffer,
+  _typed_array
 };
 
 
@@ -26,21 +33,78 @@ template <class Key, class Value>
 using PropertyContainer = std::map<Key, Value>;
 static inline std::shared_ptr<Handle> CreateUndefinedObject();
 
-// A javascript object is a set of name : value pair
+// A javascript object is a set of name : value pair, the names are kept
+// in the shape of the object and the values in its slots
 class JSObject {
 public:
   using Name = std::string;
   using Value = std::shared_ptr<Handle>;
-  using iterator = PropertyContainer<Name, Value>::iterator;
-  using const_iterator = PropertyContainer<Name, Value>::const_iterator;
 
-  JSObject(const PropertyContainer<Name, Value> &map) : object_(map) {}
+  // iterates over the properties ordered by name, dereferencing
+  // gives a (name, value) pair just like std::map did
+  template <class Slots, class V>
+  class property_iterator {
+  public:
+    property_iterator(Shape::const_iterator it, Slots *slots)
+      : it_{ it }, slots_{ slots }
+    { }
+
+    std::pair<const Name&, V&> operator*() const
+    {
+      return { it_->first, (*slots_)[it_->second] };
+    }
+
+    property_iterator &operator++()
+    {
+      ++it_;
+      return *this;
+    }
+
+    bool operator==(const property_iterator &other) const
+    {
+      return it_ == other.it_;
+    }
+
+    bool operator!=(const property_iterator &other) const
+    {
+      return it_ != other.it_;
+    }
+
+  private:
+    Shape::const_iterator it_;
+    Slots *slots_;
+  };
+
+  using iterator = property_iterator<std::vector<Value>, Value>;
+  using const_iterator =
+    property_iterator<const std::vector<Value>, const Value>;
+
+  JSObject(const PropertyContainer<Name, Value> &map)
+    : JSObject()
+  {
+    for (const auto &it : map)
+      AddProperty(it.first, it.second);
+  }
 
-  JSObject() : object_(), enumerable_{ true }, writable_{ true } {}
+  JSObject()
+    : shape_{ Shape::Empty() }, dictionary_{ }, slots_{ },
+      enumerable_{ true }, writable_{ true }
+  {
+    Heap::Track(this);
+  }
 
-  JSObject(const JSObject &obj) : object_(obj.object_), writable_{ true } {}
+  JSObject(const JSObject &obj)
+    : shape_{ obj.shape_ }, dictionary_{ }, slots_(obj.slots_),
+      enumerable_{ true }, writable_{ true }
+  {
+    if (obj.dictionary_) {
+      dictionary_ = obj.dictionary_->CloneAsDictionary();
+      shape_ = dictionary_.get();
+    }
+    Heap::Track(this);
+  }
 
-  virtual ~JSObject() { }
+  virtual ~JSObject() { Heap::Untrack(this); }
 
   virtual ObjectType GetType() const
   {
@@ -49,20 +113,26 @@ public:
   }
 
   // add a new property to the object
-  virtual void AddProperty(const Name &name, const Value &prop) {
-    object_[name] = prop;
-  }
+  virtual void AddProperty(const Name &name, const Value &prop);
+
+  // same as above for an interned name
+  void AddProperty(Atom atom, const Value &prop);
 
   // remove a property currently existing in the object
-  virtual void RemoveProperty(const Name &name) { object_.erase(name); }
+  virtual void RemoveProperty(const Name &name);
 
   // returns true if a property exists in the object
   virtual bool HasProperty(const Name &name) {
-    return object_.find(name) != object_.end();
+    size_t slot;
+    return shape_->Lookup(name, slot);
   }
 
   virtual Value GetProperty(const Name &name);
 
+  // value of the own or inherited property, nullptr if there is none.
+  // Unlike GetProperty it never adds the property to the object
+  Value FindProperty(const Name &name);
+
   bool IsEnumerable() const { return enumerable_; }
 
   void SetNonEnumerable() { enumerable_ = false; }
@@ -71,11 +141,49 @@ public:
 
   void SetNonWritable() { writable_ = false; }
 
-  iterator begin() { return object_.begin(); }
+  iterator begin() { return { shape_->begin(), &slots_ }; }
+
+  iterator end() { return { shape_->end(), &slots_ }; }
+
+  const_iterator begin() const { return { shape_->begin(), &slots_ }; }
+
+  const_iterator end() const { return { shape_->end(), &slots_ }; }
+
+  void Clear()
+  {
+    shape_ = Shape::Empty();
+    dictionary_.reset();
+    slots_.clear();
+  }
+
+  // returns the shape of the object, two objects with the same shape
+  // store the same property in the same slot
+  Shape *GetShape() const { return shape_; }
+
+  // adds the handles held by the object to refs, used by the collector
+  virtual void Trace(std::vector<Value*> &refs)
+  {
+    for (auto &slot : slots_) {
+      if (slot)
+        refs.push_back(&slot);
+    }
+  }
+
+  // drops every handle held by the object, used by the collector to
+  // break cycles of garbage
+  virtual void ReleaseReferences() { Clear(); }
 
-  iterator end() { return object_.end(); }
+  // returns the value stored in the slot, slot must come from the shape
+  Value &GetSlot(size_t slot) { return slots_[slot]; }
 
-  void Clear() { object_.clear(); }
+  // value of the own property or nullptr if the object doesn't have it
+  Value *FindSlot(Atom atom)
+  {
+    size_t slot;
+    if (!shape_->Lookup(atom, slot))
+      return nullptr;
+    return &slots_[slot];
+  }
 
   virtual std::string ToString() const;
   virtual std::string AsString() const;
@@ -86,7 +194,25 @@ public:
   }
 
 private:
-  PropertyContainer<Name, Value> object_;
+  // value of the property or nullptr if the object doesn't have it
+  Value *FindSlot(const Name &name)
+  {
+    size_t slot;
+    if (!shape_->Lookup(name, slot))
+      return nullptr;
+    return &slots_[slot];
+  }
+
+  // moves the object out of the transition tree into its own shape
+  void ToDictionary();
+
+  friend class Heap;
+  JSObject *gc_prev_;
+  JSObject *gc_next_;
+
+  Shape *shape_;
+  std::unique_ptr<Shape> dictionary_;
+  std::vector<Value> slots_;
   bool enumerable_;
   bool writable_;
 
@@ -98,6 +224,10 @@ public:
 };
 
 class JSNull : public JSObject {
+public:
+  /// Get ::= the only JSNull, it is never freed
+  static const std::shared_ptr<JSNull> &Get();
+
   std::string ToString() const override
   {
     return "null";
@@ -121,6 +251,9 @@ public:
   {
   }
 
+  /// Get ::= the only UndefinedObject, it is never freed
+  static const std::shared_ptr<UndefinedObject> &Get();
+
   std::string ToString() const override
   {
     return "undefined";
@@ -150,30 +283,27 @@ static inline bool CanEvaluateToTrue(std::shared_ptr<Handle> obj)
           || (type != ObjectType::_null);
 }
 
+/// Handles are the storage of variables, properties and elements, which
+/// get assigned by resetting the handle, so every undefined and null still
+/// gets its own handle but all of them refer to the same object
 static inline std::shared_ptr<Handle> CreateUndefinedObject()
 {
-  auto Undef = std::make_shared<UndefinedObject>();
-  auto UndefWrapper = std::make_shared<Handle>(Undef);
-  return UndefWrapper;
+  return AllocateShared<Handle>(UndefinedObject::Get());
 }
 
 static inline std::shared_ptr<Handle> CreateJSNull()
 {
-  auto Null = std::make_shared<JSNull>();
-  auto UndefWrapper = std::make_shared<Handle>(Null);
-  return UndefWrapper;
+  return AllocateShared<Handle>(JSNull::Get());
 }
 
-static inline bool IsUndefined(std::shared_ptr<Handle> obj)
+static inline bool IsUndefined(const std::shared_ptr<Handle> &obj)
 {
-  auto O = obj->as<JSObject>();
-  return O->GetType() == ObjectType::_undefined;
+  return obj->get<JSObject>() == UndefinedObject::Get().get();
 }
 
-static inline bool IsNull(std::shared_ptr<Handle> obj)
+static inline bool IsNull(const std::shared_ptr<Handle> &obj)
 {
-  auto O = obj->as<JSObject>();
-  return O->GetType() == ObjectType::_null;
+  return obj->get<JSObject>() == JSNull::Get().get();
 }
 
 extern void DefineInternalObjectProperties(JSObject *obj);
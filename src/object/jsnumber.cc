@@ -1,16 +1,27 @@
 #include "object/jsnumber.h"
 #include "common/colors.h"
 
+#include <cmath>
 #include <sstream>
 
 namespace grok {
 namespace obj {
 
+std::string NumberToString(double num)
+{
+    // integers below a million look the same with either
+    if (num > -1e6 && num < 1e6 && num == static_cast<int32_t>(num)
+            && !(num == 0 && std::signbit(num)))
+        return std::to_string(static_cast<int32_t>(num));
+
+    std::ostringstream os;
+    os << num;
+    return os.str();
+}
+
 std::string JSDouble::ToString() const
 {
-     std::ostringstream os;
-     os << number_;
-     return os.str();
+    return NumberToString(number_);
 }
 
 std::string JSDouble::AsString() const
@@ -21,8 +32,8 @@ std::string JSDouble::AsString() const
 std::shared_ptr<Object> CreateJSNumber(std::string str)
 {
     try {
-      auto S = std::make_shared<JSDouble>(str);
-      auto W = std::make_shared<Object>(S);
+      auto S = AllocateShared<JSDouble>(str);
+      auto W = AllocateShared<Object>(S);
       return W;
     } catch (...) {
       return CreateUndefinedObject();
@@ -31,8 +42,8 @@ std::shared_ptr<Object> CreateJSNumber(std::string str)
 
 std::shared_ptr<Object> CreateJSNumber(double num)
 {
-    auto S = std::make_shared<JSDouble>(num);
-    auto W = std::make_shared<Object>(S);
+    auto S = AllocateShared<JSDouble>(num);
+    auto W = AllocateShared<Object>(S);
     return W;
 }
 
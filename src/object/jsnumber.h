@@ -9,6 +9,9 @@ namespace obj {
 extern std::shared_ptr<Object> CreateJSNumber(double num);
 extern std::shared_ptr<Object> CreateJSNumber(std::string str);
 
+/// NumberToString ::= the string of a number as JSDouble prints it
+extern std::string NumberToString(double num);
+
 // JSNumber class holding a javascript number
 class JSNumber : public JSObject {
 public:
@@ -20,19 +20,17 @@ Object operator+(std::shared_ptr<JSNumber> &l, Object r)
 
   if (type == ObjectType::_number) {
     auto rhs = r.as<JSNumber>();
-    auto result = std::make_shared<JSNumber>(l->GetNumber()
+    auto result = AllocateShared<JSNumber>(l->GetNumber()
                         + rhs->GetNumber());
     return Object(result);
   } else if (type == ObjectType::_double) {
     auto rhs = r.as<JSDouble>();
-    auto result = std::make_shared<JSDouble>(l->GetNumber()
+    auto result = AllocateShared<JSDouble>(l->GetNumber()
                         + rhs->GetNumber());
     return Object(result);
   } else if (type == ObjectType::_string) {
-    auto rhs = r.as<JSString>();
-    auto result = std::make_shared<JSString>(l->ToString()
-                        + rhs->ToString());
-    return Object(result);
+    auto lhs = AllocateShared<JSString>(l->ToString());
+    return *CreateJSRope(lhs, r.as<JSString>());
   } else {
     throw std::runtime_error("Code reached a place where it"
                           " was not supposed to be");
@@ -45,12 +43,12 @@ Object operator<(std::shared_ptr<JSNumber> &l, Object r)
 
   if (type == ObjectType::_number) {
     auto rhs = r.as<JSNumber>();
-    auto result = std::make_shared<JSNumber>(l->GetNumber()
+    auto result = AllocateShared<JSNumber>(l->GetNumber()
                         < rhs->GetNumber());
     return Object(result);
   } else if (type == ObjectType::_double) {
     auto rhs = r.as<JSDouble>();
-    auto result = std::make_shared<JSNumber>(l->GetNumber()
+    auto result = AllocateShared<JSNumber>(l->GetNumber()
                         < rhs->GetNumber());
     return Object(result);
   } else {
@@ -67,12 +65,12 @@ Object operator>(std::shared_ptr<JSNumber> &l, Object r)
 
   if (type == ObjectType::_number) {
     auto rhs = r.as<JSNumber>();
-    auto result = std::make_shared<JSNumber>(l->GetNumber()
+    auto result = AllocateShared<JSNumber>(l->GetNumber()
                         > rhs->GetNumber());
     return Object(result);
   } else if (type == ObjectType::_double) {
     auto rhs = r.as<JSDouble>();
-    auto result = std::make_shared<JSNumber>(l->GetNumber()
+    auto result = AllocateShared<JSNumber>(l->GetNumber()
                         > rhs->GetNumber());
     return Object(result);
   } else {
@@ -89,12 +87,12 @@ Object operator<=(std::shared_ptr<JSNumber> &l, Object r)
 
   if (type == ObjectType::_number) {
     auto rhs = r.as<JSNumber>();
-    auto result = std::make_shared<JSNumber>(l->GetNumber()
+    auto result = AllocateShared<JSNumber>(l->GetNumber()
                         <= rhs->GetNumber());
     return Object(result);
   } else if (type == ObjectType::_double) {
     auto rhs = r.as<JSDouble>();
-    auto result = std::make_shared<JSNumber>(l->GetNumber()
+    auto result = AllocateShared<JSNumber>(l->GetNumber()
                         <= rhs->GetNumber());
     return Object(result);
   } else {
@@ -111,12 +109,12 @@ Object operator>=(std::shared_ptr<JSNumber> &l, Object r)
 
   if (type == ObjectType::_number) {
     auto rhs = r.as<JSNumber>();
-    auto result = std::make_shared<JSNumber>(l->GetNumber()
+    auto result = AllocateShared<JSNumber>(l->GetNumber()
                         >= rhs->GetNumber());
     return Object(result);
   } else if (type == ObjectType::_double) {
     auto rhs = r.as<JSDouble>();
-    auto result = std::make_shared<JSNumber>(l->GetNumber()
+    auto result = AllocateShared<JSNumber>(l->GetNumber()
                         >= rhs->GetNumber());
     return Object(result);
   } else {
@@ -132,16 +130,16 @@ Object operator-(std::shared_ptr<JSNumber> &l, Object r)
   auto type = r.as<JSObject>()->GetType();
   if (type == ObjectType::_number) {
     auto rhs = r.as<JSNumber>();
-    auto result = std::make_shared<JSNumber>(l->GetNumber()
+    auto result = AllocateShared<JSNumber>(l->GetNumber()
                       - rhs->GetNumber());
     return Object(result);
   } else if (type == ObjectType::_double) {
     auto rhs = r.as<JSDouble>();
-    auto result = std::make_shared<JSDouble>(l->GetNumber()
+    auto result = AllocateShared<JSDouble>(l->GetNumber()
                         - rhs->GetNumber());
     return Object(result);
   } else {
-      auto result = std::make_shared<UndefinedObject>();
+      auto result = UndefinedObject::Get();
       return Object(result);
   }
 }
@@ -151,16 +149,16 @@ Object operator*(std::shared_ptr<JSNumber> &l, Object r)
   auto type = r.as<JSObject>()->GetType();
   if (type == ObjectType::_number) {
     auto rhs = r.as<JSNumber>();
-    auto result = std::make_shared<JSNumber>(l->GetNumber()
+    auto result = AllocateShared<JSNumber>(l->GetNumber()
                       * rhs->GetNumber());
     return Object(result);
   } else if (type == ObjectType::_double) {
     auto rhs = r.as<JSDouble>();
-    auto result = std::make_shared<JSDouble>(l->GetNumber()
+    auto result = AllocateShared<JSDouble>(l->GetNumber()
                         * rhs->GetNumber());
     return Object(result);
   } else {
-      auto result = std::make_shared<UndefinedObject>();
+      auto result = UndefinedObject::Get();
       return Object(result);
   }
 }
@@ -170,16 +168,16 @@ Object operator/(std::shared_ptr<JSNumber> &l, Object r)
   auto type = r.as<JSObject>()->GetType();
   if (type == ObjectType::_number) {
     auto rhs = r.as<JSNumber>();
-    auto result = std::make_shared<JSNumber>(l->GetNumber()
+    auto result = AllocateShared<JSNumber>(l->GetNumber()
                       / rhs->GetNumber());
     return Object(result);
   } else if (type == ObjectType::_double) {
     auto rhs = r.as<JSDouble>();
-    auto result = std::make_shared<JSDouble>(l->GetNumber()
+    auto result = AllocateShared<JSDouble>(l->GetNumber()
                         / rhs->GetNumber());
     return Object(result);
   } else {
-      auto result = std::make_shared<UndefinedObject>();
+      auto result = UndefinedObject::Get();
       return Object(result);
   }
 }
@@ -189,16 +187,16 @@ Object operator%(std::shared_ptr<JSNumber> &l, Object r)
   auto type = r.as<JSObject>()->GetType();
   if (type == ObjectType::_number) {
     auto rhs = r.as<JSNumber>();
-    auto result = std::make_shared<JSNumber>(l->GetNumber()
+    auto result = AllocateShared<JSNumber>(l->GetNumber()
                       % rhs->GetNumber());
     return Object(result);
   } else if (type == ObjectType::_double) {
     auto rhs = r.as<JSDouble>();
-    auto result = std::make_shared<JSNumber>(l->GetNumber()
+    auto result = AllocateShared<JSNumber>(l->GetNumber()
                         % (int32_t)rhs->GetNumber());
     return Object(result);
   } else {
-      auto result = std::make_shared<UndefinedObject>();
+      auto result = UndefinedObject::Get();
       return Object(result);
   }
 }
@@ -208,16 +206,16 @@ Object operator<<(std::shared_ptr<JSNumber> &l, Object r)
   auto type = r.as<JSObject>()->GetType();
   if (type == ObjectType::_number) {
     auto rhs = r.as<JSNumber>();
-    auto result = std::make_shared<JSNumber>(l->GetNumber()
+    auto result = AllocateShared<JSNumber>(l->GetNumber()
                       << rhs->GetNumber());
     return Object(result);
   } else if (type == ObjectType::_double) {
     auto rhs = r.as<JSDouble>();
-    auto result = std::make_shared<JSNumber>(l->GetNumber()
+    auto result = AllocateShared<JSNumber>(l->GetNumber()
                         << (int32_t)rhs->GetNumber());
     return Object(result);
   } else  {
-      auto result = std::make_shared<UndefinedObject>();
+      auto result = UndefinedObject::Get();
       return Object(result);
   }
 }
@@ -227,16 +225,16 @@ Object operator>>(std::shared_ptr<JSNumber> &l, Object r)
   auto type = r.as<JSObject>()->GetType();
   if (type == ObjectType::_number) {
     auto rhs = r.as<JSNumber>();
-    auto result = std::make_shared<JSNumber>(l->GetNumber()
+    auto result = AllocateShared<JSNumber>(l->GetNumber()
                       >> (int32_t)rhs->GetNumber());
     return Object(result);
   } else if (type == ObjectType::_double) {
     auto rhs = r.as<JSDouble>();
-    auto result = std::make_shared<JSNumber>(l->GetNumber()
+    auto result = AllocateShared<JSNumber>(l->GetNumber()
                         >> (int32_t)rhs->GetNumber());
     return Object(result);
   } else  {
-      auto result = std::make_shared<UndefinedObject>();
+      auto result = UndefinedObject::Get();
       return Object(result);
   }
 }
@@ -246,16 +244,16 @@ Object operator|(std::shared_ptr<JSNumber> &l, Object r)
   auto type = r.as<JSObject>()->GetType();
   if (type == ObjectType::_number) {
     auto rhs = r.as<JSNumber>();
-    auto result = std::make_shared<JSNumber>(l->GetNumber()
+    auto result = AllocateShared<JSNumber>(l->GetNumber()
                       | rhs->GetNumber());
     return Object(result);
   } else if (type == ObjectType::_double) {
     auto rhs = r.as<JSDouble>();
-    auto result = std::make_shared<JSNumber>(l->GetNumber()
+    auto result = AllocateShared<JSNumber>(l->GetNumber()
                         | (int32_t)rhs->GetNumber());
     return Object(result);
   } else {
-      auto result = std::make_shared<UndefinedObject>();
+      auto result = UndefinedObject::Get();
       return Object(result);
   }
 }
@@ -265,16 +263,16 @@ Object operator&(std::shared_ptr<JSNumber> &l, Object r)
   auto type = r.as<JSObject>()->GetType();
   if (type == ObjectType::_number) {
     auto rhs = r.as<JSNumber>();
-    auto result = std::make_shared<JSNumber>(l->GetNumber()
+    auto result = AllocateShared<JSNumber>(l->GetNumber()
                       & (int32_t)rhs->GetNumber());
     return Object(result);
   } else if (type == ObjectType::_double) {
     auto rhs = r.as<JSDouble>();
-    auto result = std::make_shared<JSNumber>(l->GetNumber()
+    auto result = AllocateShared<JSNumber>(l->GetNumber()
                         & (int32_t  )rhs->GetNumber());
     return Object(result);
   } else {
-      auto result = std::make_shared<UndefinedObject>();
+      auto result = UndefinedObject::Get();
       return Object(result);
   }
 }
@@ -284,12 +282,12 @@ Object operator||(std::shared_ptr<JSNumber> &l, Object r)
   auto type = r.as<JSObject>()->GetType();
   if (type == ObjectType::_number) {
     auto rhs = r.as<JSNumber>();
-    auto result = std::make_shared<JSNumber>(l->GetNumber()
+    auto result = AllocateShared<JSNumber>(l->GetNumber()
                       || rhs->GetNumber());
     return Object(result);
   } else if (type == ObjectType::_double) {
     auto rhs = r.as<JSDouble>();
-    auto result = std::make_shared<JSNumber>(l->GetNumber()
+    auto result = AllocateShared<JSNumber>(l->GetNumber()
                         || rhs->GetNumber());
     return Object(result);
   } else {
@@ -304,12 +302,12 @@ Object operator&&(std::shared_ptr<JSNumber> &l, Object r)
   auto type = r.as<JSObject>()->GetType();
   if (type == ObjectType::_number) {
     auto rhs = r.as<JSNumber>();
-    auto result = std::make_shared<JSNumber>(l->GetNumber()
+    auto result = AllocateShared<JSNumber>(l->GetNumber()
                       && rhs->GetNumber());
     return Object(result);
   } else if (type == ObjectType::_double) {
     auto rhs = r.as<JSDouble>();
-    auto result = std::make_shared<JSNumber>(l->GetNumber()
+    auto result = AllocateShared<JSNumber>(l->GetNumber()
                         && rhs->GetNumber());
     return Object(result);
   } else {
@@ -324,16 +322,16 @@ Object operator^(std::shared_ptr<JSNumber> &l, Object r)
   auto type = r.as<JSObject>()->GetType();
   if (type == ObjectType::_number) {
     auto rhs = r.as<JSNumber>();
-    auto result = std::make_shared<JSNumber>(l->GetNumber()
+    auto result = AllocateShared<JSNumber>(l->GetNumber()
                       ^ (int32_t)rhs->GetNumber());
     return Object(result);
   } else if (type == ObjectType::_double) {
     auto rhs = r.as<JSDouble>();
-    auto result = std::make_shared<JSNumber>(l->GetNumber()
+    auto result = AllocateShared<JSNumber>(l->GetNumber()
                         ^ (int32_t)rhs->GetNumber());
     return Object(result);
   } else {
-      auto result = std::make_shared<UndefinedObject>();
+      auto result = UndefinedObject::Get();
       return (result);
   }
 }
@@ -343,12 +341,12 @@ Object operator==(std::shared_ptr<JSNumber> &l, Object r)
   auto type = r.as<JSObject>()->GetType();
   if (type == ObjectType::_number) {
     auto rhs = r.as<JSNumber>();
-    auto result = std::make_shared<JSNumber>(l->GetNumber()
+    auto result = AllocateShared<JSNumber>(l->GetNumber()
                       == rhs->GetNumber());
     return Object(result);
   } else if (type == ObjectType::_double) {
     auto rhs = r.as<JSDouble>();
-    auto result = std::make_shared<JSNumber>(l->GetNumber()
+    auto result = AllocateShared<JSNumber>(l->GetNumber()
                         == rhs->GetNumber());
     return Object(result);
   } else {
@@ -362,12 +360,12 @@ Object operator!=(std::shared_ptr<JSNumber> &l, Object r)
   auto type = r.as<JSObject>()->GetType();
   if (type == ObjectType::_number) {
     auto rhs = r.as<JSNumber>();
-    auto result = std::make_shared<JSNumber>(l->GetNumber()
+    auto result = AllocateShared<JSNumber>(l->GetNumber()
                       != rhs->GetNumber());
     return Object(result);
   } else if (type == ObjectType::_double) {
     auto rhs = r.as<JSDouble>();
-    auto result = std::make_shared<JSNumber>(l->GetNumber()
+    auto result = AllocateShared<JSNumber>(l->GetNumber()
                         != rhs->GetNumber());
     return Object(result);
   } else {
@@ -386,17 +384,20 @@ Object operator+(std::shared_ptr<JSDouble> &l, Object r)
 
   if (type == ObjectType::_number) {
     auto rhs = r.as<JSNumber>();
-    auto result = std::make_shared<JSDouble>(l->GetNumber()
+    auto result = AllocateShared<JSDouble>(l->GetNumber()
                         + rhs->GetNumber());
     return Object(result);
   } else if (type == ObjectType::_double) {
     auto rhs = r.as<JSDouble>();
-    auto result = std::make_shared<JSDouble>(l->GetNumber()
+    auto result = AllocateShared<JSDouble>(l->GetNumber()
                         + rhs->GetNumber());
     return Object(result);
+  } else if (type == ObjectType::_string) {
+    auto lhs = AllocateShared<JSString>(l->ToString());
+    return *CreateJSRope(lhs, r.as<JSString>());
   } else {
     auto rhs = r.as<JSObject>();
-    auto result = std::make_shared<JSString>(l->ToString()
+    auto result = AllocateShared<JSString>(l->ToString()
                         + rhs->ToString());
     return Object(result);
   }
@@ -408,12 +409,12 @@ Object operator<(std::shared_ptr<JSDouble> &l, Object r)
 
   if (type == ObjectType::_number) {
     auto rhs = r.as<JSNumber>();
-    auto result = std::make_shared<JSNumber>(l->GetNumber()
+    auto result = AllocateShared<JSNumber>(l->GetNumber()
                         < rhs->GetNumber());
     return Object(result);
   } else if (type == ObjectType::_double) {
     auto rhs = r.as<JSDouble>();
-    auto result = std::make_shared<JSNumber>(l->GetNumber()
+    auto result = AllocateShared<JSNumber>(l->GetNumber()
                         < rhs->GetNumber());
     return Object(result);
   } else {
@@ -430,12 +431,12 @@ Object operator>(std::shared_ptr<JSDouble> &l, Object r)
 
   if (type == ObjectType::_number) {
     auto rhs = r.as<JSNumber>();
-    auto result = std::make_shared<JSNumber>(l->GetNumber()
+    auto result = AllocateShared<JSNumber>(l->GetNumber()
                         > rhs->GetNumber());
     return Object(result);
   } else if (type == ObjectType::_double) {
     auto rhs = r.as<JSDouble>();
-    auto result = std::make_shared<JSNumber>(l->GetNumber()
+    auto result = AllocateShared<JSNumber>(l->GetNumber()
                         > rhs->GetNumber());
     return Object(result);
   } else {
@@ -452,12 +453,12 @@ Object operator<=(std::shared_ptr<JSDouble> &l, Object r)
 
   if (type == ObjectType::_number) {
     auto rhs = r.as<JSNumber>();
-    auto result = std::make_shared<JSNumber>(l->GetNumber()
+    auto result = AllocateShared<JSNumber>(l->GetNumber()
                         <= rhs->GetNumber());
     return Object(result);
   } else if (type == ObjectType::_double) {
     auto rhs = r.as<JSDouble>();
-    auto result = std::make_shared<JSNumber>(l->GetNumber()
+    auto result = AllocateShared<JSNumber>(l->GetNumber()
                         <= rhs->GetNumber());
     return Object(result);
   } else {
@@ -474,12 +475,12 @@ Object operator>=(std::shared_ptr<JSDouble> &l, Object r)
 
   if (type == ObjectType::_number) {
     auto rhs = r.as<JSNumber>();
-    auto result = std::make_shared<JSNumber>(l->GetNumber()
+    auto result = AllocateShared<JSNumber>(l->GetNumber()
                         >= rhs->GetNumber());
     return Object(result);
   } else if (type == ObjectType::_double) {
     auto rhs = r.as<JSDouble>();
-    auto result = std::make_shared<JSNumber>(l->GetNumber()
+    auto result = AllocateShared<JSNumber>(l->GetNumber()
                         >= rhs->GetNumber());
     return Object(result);
   } else {
@@ -495,16 +496,16 @@ Object operator-(std::shared_ptr<JSDouble> &l, Object r)
   auto type = r.as<JSObject>()->GetType();
   if (type == ObjectType::_number) {
     auto rhs = r.as<JSNumber>();
-    auto result = std::make_shared<JSDouble>(l->GetNumber()
+    auto result = AllocateShared<JSDouble>(l->GetNumber()
                       - rhs->GetNumber());
     return Object(result);
   } else if (type == ObjectType::_double) {
     auto rhs = r.as<JSDouble>();
-    auto result = std::make_shared<JSDouble>(l->GetNumber()
+    auto result = AllocateShared<JSDouble>(l->GetNumber()
                         - rhs->GetNumber());
     return Object(result);
   } else  {
-      auto result = std::make_shared<UndefinedObject>();
+      auto result = UndefinedObject::Get();
       return Object(result);
   }
 }
@@ -514,16 +515,16 @@ Object operator*(std::shared_ptr<JSDouble> &l, Object r)
   auto type = r.as<JSObject>()->GetType();
   if (type == ObjectType::_number) {
     auto rhs = r.as<JSNumber>();
-    auto result = std::make_shared<JSDouble>(l->GetNumber()
+    auto result = AllocateShared<JSDouble>(l->GetNumber()
                       * rhs->GetNumber());
     return Object(result);
   } else if (type == ObjectType::_double) {
     auto rhs = r.as<JSDouble>();
-    auto result = std::make_shared<JSDouble>(l->GetNumber()
+    auto result = AllocateShared<JSDouble>(l->GetNumber()
                         * rhs->GetNumber());
     return Object(result);
   } else  {
-      auto result = std::make_shared<UndefinedObject>();
+      auto result = UndefinedObject::Get();
       return Object(result);
   }
 }
@@ -533,16 +534,16 @@ Object operator/(std::shared_ptr<JSDouble> &l, Object r)
   auto type = r.as<JSObject>()->GetType();
   if (type == ObjectType::_number) {
     auto rhs = r.as<JSNumber>();
-    auto result = std::make_shared<JSDouble>(l->GetNumber()
+    auto result = AllocateShared<JSDouble>(l->GetNumber()
                       / rhs->GetNumber());
     return Object(result);
   } else if (type == ObjectType::_double) {
     auto rhs = r.as<JSDouble>();
-    auto result = std::make_shared<JSDouble>(l->GetNumber()
+    auto result = AllocateShared<JSDouble>(l->GetNumber()
                         / rhs->GetNumber());
     return Object(result);
   } else  {
-      auto result = std::make_shared<UndefinedObject>();
+      auto result = UndefinedObject::Get();
       return Object(result);
   }
 }
@@ -552,16 +553,16 @@ Object operator%(std::shared_ptr<JSDouble> &l, Object r)
   auto type = r.as<JSObject>()->GetType();
   if (type == ObjectType::_number) {
     auto rhs = r.as<JSNumber>();
-    auto result = std::make_shared<JSNumber>((int32_t)l->GetNumber()
+    auto result = AllocateShared<JSNumber>((int32_t)l->GetNumber()
                       % rhs->GetNumber());
     return Object(result);
   } else if (type == ObjectType::_double) {
     auto rhs = r.as<JSDouble>();
-    auto result = std::make_shared<JSNumber>((int32_t)l->GetNumber()
+    auto result = AllocateShared<JSNumber>((int32_t)l->GetNumber()
                         % (int32_t)rhs->GetNumber());
     return Object(result);
   } else  {
-      auto result = std::make_shared<UndefinedObject>();
+      auto result = UndefinedObject::Get();
       return Object(result);
   }
 }
@@ -572,16 +573,16 @@ Object operator<<(std::shared_ptr<JSDouble> &l, Object r)
   auto type = r.as<JSObject>()->GetType();
   if (type == ObjectType::_number) {
     auto rhs = r.as<JSNumber>();
-    auto result = std::make_shared<JSNumber>((int32_t)l->GetNumber()
+    auto result = AllocateShared<JSNumber>((int32_t)l->GetNumber()
                       << rhs->GetNumber());
     return Object(result);
   } else if (type == ObjectType::_double) {
     auto rhs = r.as<JSDouble>();
-    auto result = std::make_shared<JSNumber>((int32_t)l->GetNumber()
+    auto result = AllocateShared<JSNumber>((int32_t)l->GetNumber()
                         << (int32_t)rhs->GetNumber());
     return Object(result);
   } else  {
-      auto result = std::make_shared<UndefinedObject>();
+      auto result = UndefinedObject::Get();
       return Object(result);
   }
 }
@@ -591,16 +592,16 @@ Object operator>>(std::shared_ptr<JSDouble> &l, Object r)
   auto type = r.as<JSObject>()->GetType();
   if (type == ObjectType::_number) {
     auto rhs = r.as<JSNumber>();
-    auto result = std::make_shared<JSNumber>((int32_t)l->GetNumber()
+    auto result = AllocateShared<JSNumber>((int32_t)l->GetNumber()
                       >> rhs->GetNumber());
     return Object(result);
   } else if (type == ObjectType::_double) {
     auto rhs = r.as<JSDouble>();
-    auto result = std::make_shared<JSNumber>((int32_t)l->GetNumber()
+    auto result = AllocateShared<JSNumber>((int32_t)l->GetNumber()
                         >> (int32_t)rhs->GetNumber());
     return Object(result);
   } else  {
-      auto result = std::make_shared<UndefinedObject>();
+      auto result = UndefinedObject::Get();
       return Object(result);
   }
 }
@@ -610,16 +611,16 @@ Object operator|(std::shared_ptr<JSDouble> &l, Object r)
   auto type = r.as<JSObject>()->GetType();
   if (type == ObjectType::_number) {
     auto rhs = r.as<JSNumber>();
-    auto result = std::make_shared<JSNumber>((int32_t)l->GetNumber()
+    auto result = AllocateShared<JSNumber>((int32_t)l->GetNumber()
                       | rhs->GetNumber());
     return Object(result);
   } else if (type == ObjectType::_double) {
     auto rhs = r.as<JSDouble>();
-    auto result = std::make_shared<JSNumber>((int32_t)l->GetNumber()
+    auto result = AllocateShared<JSNumber>((int32_t)l->GetNumber()
                         | (int32_t)rhs->GetNumber());
     return Object(result);
   } else  {
-      auto result = std::make_shared<UndefinedObject>();
+      auto result = UndefinedObject::Get();
       return Object(result);
   }
 }
@@ -629,16 +630,16 @@ Object operator&(std::shared_ptr<JSDouble> &l, Object r)
   auto type = r.as<JSObject>()->GetType();
   if (type == ObjectType::_number) {
     auto rhs = r.as<JSNumber>();
-    auto result = std::make_shared<JSNumber>((int32_t)l->GetNumber()
+    auto result = AllocateShared<JSNumber>((int32_t)l->GetNumber()
                       & rhs->GetNumber());
     return Object(result);
   } else if (type == ObjectType::_double) {
     auto rhs = r.as<JSDouble>();
-    auto result = std::make_shared<JSNumber>((int32_t)l->GetNumber()
+    auto result = AllocateShared<JSNumber>((int32_t)l->GetNumber()
                         & (int32_t)rhs->GetNumber());
     return Object(result);
   } else  {
-      auto result = std::make_shared<UndefinedObject>();
+      auto result = UndefinedObject::Get();
       return Object(result);
   }
 }
@@ -648,12 +649,12 @@ Object operator||(std::shared_ptr<JSDouble> &l, Object r)
   auto type = r.as<JSObject>()->GetType();
   if (type == ObjectType::_number) {
     auto rhs = r.as<JSNumber>();
-    auto result = std::make_shared<JSNumber>((int32_t)l->GetNumber()
+    auto result = AllocateShared<JSNumber>((int32_t)l->GetNumber()
                       || rhs->GetNumber());
     return Object(result);
   } else if (type == ObjectType::_double) {
     auto rhs = r.as<JSDouble>();
-    auto result = std::make_shared<JSNumber>((int32_t)l->GetNumber()
+    auto result = AllocateShared<JSNumber>((int32_t)l->GetNumber()
                         || (int32_t)rhs->GetNumber());
     return Object(result);
   } else  {
@@ -668,12 +669,12 @@ Object operator&&(std::shared_ptr<JSDouble> &l, Object r)
   auto type = r.as<JSObject>()->GetType();
   if (type == ObjectType::_number) {
     auto rhs = r.as<JSNumber>();
-    auto result = std::make_shared<JSNumber>((int32_t)l->GetNumber()
+    auto result = AllocateShared<JSNumber>((int32_t)l->GetNumber()
                       && rhs->GetNumber());
     return Object(result);
   } else if (type == ObjectType::_double) {
     auto rhs = r.as<JSDouble>();
-    auto result = std::make_shared<JSNumber>((int32_t)l->GetNumber()
+    auto result = AllocateShared<JSNumber>((int32_t)l->GetNumber()
                         && (int32_t)rhs->GetNumber());
     return Object(result);
   } else  {
@@ -688,16 +689,16 @@ Object operator^(std::shared_ptr<JSDouble> &l, Object r)
   auto type = r.as<JSObject>()->GetType();
   if (type == ObjectType::_number) {
     auto rhs = r.as<JSNumber>();
-    auto result = std::make_shared<JSNumber>((int32_t)l->GetNumber()
+    auto result = AllocateShared<JSNumber>((int32_t)l->GetNumber()
                       ^ rhs->GetNumber());
     return Object(result);
   } else if (type == ObjectType::_double) {
     auto rhs = r.as<JSDouble>();
-    auto result = std::make_shared<JSNumber>((int32_t)l->GetNumber()
+    auto result = AllocateShared<JSNumber>((int32_t)l->GetNumber()
                         ^ (int32_t)rhs->GetNumber());
     return Object(result);
   } else {
-      auto result = std::make_shared<UndefinedObject>();
+      auto result = UndefinedObject::Get();
       return (result);
   }
 }
@@ -707,12 +708,12 @@ Object operator==(std::shared_ptr<JSDouble> &l, Object r)
   auto type = r.as<JSObject>()->GetType();
   if (type == ObjectType::_number) {
     auto rhs = r.as<JSNumber>();
-    auto result = std::make_shared<JSNumber>(l->GetNumber()
+    auto result = AllocateShared<JSNumber>(l->GetNumber()
                       == rhs->GetNumber());
     return Object(result);
   } else if (type == ObjectType::_double) {
     auto rhs = r.as<JSDouble>();
-    auto result = std::make_shared<JSNumber>(l->GetNumber()
+    auto result = AllocateShared<JSNumber>(l->GetNumber()
                         == rhs->GetNumber());
     return Object(result);
   } else {
@@ -727,12 +728,12 @@ Object operator!=(std::shared_ptr<JSDouble> &l, Object r)
   auto type = r.as<JSObject>()->GetType();
   if (type == ObjectType::_number) {
     auto rhs = r.as<JSNumber>();
-    auto result = std::make_shared<JSNumber>(l->GetNumber()
+    auto result = AllocateShared<JSNumber>(l->GetNumber()
                       != rhs->GetNumber());
     return Object(result);
   } else if (type == ObjectType::_double) {
     auto rhs = r.as<JSDouble>();
-    auto result = std::make_shared<JSNumber>(l->GetNumber()
+    auto result = AllocateShared<JSNumber>(l->GetNumber()
                         != rhs->GetNumber());
     return Object(result);
   } else  {
@@ -746,10 +747,14 @@ Object operator!=(std::shared_ptr<JSDouble> &l, Object r)
 ///             Operators for strings
 ///=====------------------------------------------------------------------=====
 
+/// concatenations make ropes, so that building a long string piece by
+/// piece copies every piece only once
 Object operator +(std::shared_ptr<JSString> &l, Object r)
 {
     auto obj = r.as<JSObject>();
-    return *CreateJSString(l->ToString() + obj->ToString());
+    if (obj->GetType() == ObjectType::_string)
+        return *CreateJSRope(l, r.as<JSString>());
+    return *CreateJSRope(l, AllocateShared<JSString>(obj->ToString()));
 }
 
 Object operator>(std::shared_ptr<JSString> &l, Object r)
@@ -815,7 +820,7 @@ Object operator op(Object l, Object r) \
   case ObjectType::_array: \
   case ObjectType::_undefined: \
   default: {\
-      auto result = std::make_shared<UndefinedObject>(); \
+      auto result = UndefinedObject::Get(); \
       return Object(result); \
     }  \
   } \
@@ -881,7 +886,7 @@ Object operator op (Object l, Object r) \
     break;\
   }; \
   \
-  auto object = std::make_shared<UndefinedObject>(); \
+  auto object = UndefinedObject::Get(); \
   return Object(object); \
 }
 
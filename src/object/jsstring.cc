@@ -3,6 +3,8 @@
 #include "libs/string/properties.h"
 #include "common/colors.h"
 
+#include <vector>
+
 namespace grok {
 namespace obj {
 
@@ -15,7 +17,7 @@ JSObject::Value JSString::GetProperty(const std::string &prop)
         idx = std::stod(prop);
     } catch (...) {
         if (prop == "length") {
-            return CreateJSNumber(js_string_.size());
+            return CreateJSNumber(Length());
         }
         auto method = GetStaticProperty(prop);
         if (method.second) {
@@ -24,12 +26,61 @@ JSObject::Value JSString::GetProperty(const std::string &prop)
         return JSObject::GetProperty(prop);
     }
 
-    return CreateJSString(std::string() + js_string_[idx]);
+    return CreateJSString(std::string() + GetString()[idx]);
+}
+
+/// ReleaseRope ::= drops both parts of a rope, the ropes which nobody
+/// else refers to are taken apart first so that freeing a rope made of
+/// thousands of concatenations doesn't recurse as deep
+void JSString::ReleaseRope(std::shared_ptr<JSString> &left,
+    std::shared_ptr<JSString> &right)
+{
+    std::vector<std::shared_ptr<JSString>> pending;
+    pending.push_back(std::move(left));
+    pending.push_back(std::move(right));
+
+    while (pending.size()) {
+        auto node = std::move(pending.back());
+        pending.pop_back();
+        if (node && node.use_count() == 1 && node->left_) {
+            pending.push_back(std::move(node->left_));
+            pending.push_back(std::move(node->right_));
+        }
+    }
+}
+
+JSString::~JSString()
+{
+    if (left_)
+        ReleaseRope(left_, right_);
+}
+
+void JSString::FlattenRope() const
+{
+    std::string flat;
+    flat.reserve(length_);
+
+    // leaves are appended from left to right without recursion
+    std::vector<const JSString*> pending{ right_.get(), left_.get() };
+    while (pending.size()) {
+        auto node = pending.back();
+        pending.pop_back();
+        if (!node)
+            continue;
+        if (node->left_) {
+            pending.push_back(node->right_.get());
+            pending.push_back(node->left_.get());
+        } else {
+            flat += node->js_string_;
+        }
+    }
+    js_string_ = std::move(flat);
+    ReleaseRope(left_, right_);
 }
 
 std::string JSString::AsString() const
 {
-    return Color::Color(Color::fgreen) + std::string("'") + js_string_
+    return Color::Color(Color::fgreen) + std::string("'") + ToString()
             + "'" + Color::Reset();
 }
 
@@ -50,15 +101,29 @@ void JSString::Init()
 
 void JSString::concat(const std::string &str)
 {
-    js_string_ += str;
+    GetString() += str;
 }
 
+/// strings get toString, hasOwnProperty and prototype from JSObject::st_obj
+/// like every other object does, they have no own properties to create
 std::shared_ptr<Object> CreateJSString(std::string str)
 {
-    auto S = std::make_shared<JSString>(str);
-    auto W = std::make_shared<Object>(S);
-    DefineInternalObjectProperties(S.get());
-    return W;
+    auto S = AllocateShared<JSString>(std::move(str));
+    return AllocateShared<Object>(S);
+}
+
+std::shared_ptr<Object> CreateJSRope(std::shared_ptr<JSString> left,
+    std::shared_ptr<JSString> right)
+{
+    auto length = left->Length() + (right ? right->Length() : 0);
+    if (length < JSString::MinRopeLength) {
+        auto str = left->ToString();
+        if (right)
+            str += right->ToString();
+        return CreateJSString(std::move(str));
+    }
+    auto S = AllocateShared<JSString>(std::move(left), std::move(right));
+    return AllocateShared<Object>(S);
 }
 
 }
@@ -8,30 +8,58 @@ namespace obj {
 
 extern std::shared_ptr<Object> CreateJSString(std::string str = "");
 
+/// JSString ::= javascript string. A string made by concatenating long
+/// strings is a rope which only refers to both of them, it is flattened
+/// into one std::string when its characters are read. Strings must not
+/// be modified once they may be part of a rope.
 class JSString : public JSObject {
 public:
   using size_type = std::string::size_type;
 
-  JSString(std::string str) : js_string_(std::move(str)) {}
+  /// MinRopeLength ::= shorter results of a concatenation are copied
+  static constexpr size_type MinRopeLength = 256;
 
-  JSString() : js_string_("") {}
+  JSString(std::string str) : js_string_(std::move(str)), length_{ 0 } {}
 
-  ~JSString() {}
+  JSString() : js_string_(""), length_{ 0 } {}
+
+  /// rope of left followed by right, right may be nullptr
+  JSString(std::shared_ptr<JSString> left, std::shared_ptr<JSString> right)
+    : js_string_{ }, left_{ std::move(left) }, right_{ std::move(right) },
+      length_{ left_->Length() + (right_ ? right_->Length() : 0) }
+  { }
+
+  ~JSString();
+
+  inline std::string &GetString()
+  {
+    Flatten();
+    return js_string_;
+  }
 
-  inline std::string &GetString() { return js_string_; }
   ObjectType GetType() const override { return ObjectType::_string; }
-  std::string ToString() const override { return js_string_; }
-  
+
+  std::string ToString() const override
+  {
+    Flatten();
+    return js_string_;
+  }
+
+  /// Length ::= length of the string without flattening it
+  size_type Length() const { return left_ ? length_ : js_string_.size(); }
+
+  bool IsRope() const { return left_ != nullptr; }
+
   std::string AsString() const override;
   
   JSObject::Value GetProperty(const std::string &prop) override;
 
   bool IsTrue() const override
   {
-    return js_string_.size();
+    return Length();
   }
 
-  std::string& str() { return js_string_; }
+  std::string& str() { return GetString(); }
 
   void concat(const std::string &str);
 
@@ -40,13 +68,34 @@ public:
 
   static void Init();
 private:
-  std::string js_string_;
+  /// Flatten ::= copies the characters of the rope into js_string_ and
+  /// drops the strings it referred to
+  void Flatten() const
+  {
+    if (left_)
+      FlattenRope();
+  }
+
+  void FlattenRope() const;
+
+  static void ReleaseRope(std::shared_ptr<JSString> &left,
+    std::shared_ptr<JSString> &right);
+
+  mutable std::string js_string_;
+  mutable std::shared_ptr<JSString> left_;
+  mutable std::shared_ptr<JSString> right_;
+  size_type length_;
 
 public:
   // this variable holds all string properties
   static JSString string;
 };
 
+/// CreateJSRope ::= string of left followed by right (which may be
+/// nullptr), a rope when the result is long enough else a plain copy
+extern std::shared_ptr<Object> CreateJSRope(std::shared_ptr<JSString> left,
+    std::shared_ptr<JSString> right);
+
 static inline bool IsJSString(std::shared_ptr<Object> obj)
 {
   auto O = obj->as<JSObject>();
@@ -0,0 +1,104 @@
+#ifndef NATIVE_ARGS_H_
+#define NATIVE_ARGS_H_
+
+#include "object/jsnumber.h"
+#include "vm/var-store.h"
+
+namespace grok {
+namespace obj {
+
+/// NativeArgs ::= arguments of a call of a native function of the fast
+/// calling convention. They are the values on the stack of the VM and
+/// `this`, nothing is allocated for the call. The values are only valid
+/// till the native returns, a native which keeps one must Copy() it and
+/// one which runs code of the VM must read them all before
+class NativeArgs {
+public:
+    NativeArgs(grok::vm::Value *args, size_t size,
+        std::shared_ptr<Handle> This)
+        : args_{ args }, size_{ size }, this_{ std::move(This) }
+    { }
+
+    size_t Size() const { return size_; }
+
+    /// operator[] ::= the idx-th argument, idx must be less than Size()
+    const grok::vm::Value &operator[](size_t idx) const
+    {
+        return args_[idx];
+    }
+
+    const grok::vm::Value *begin() const { return args_; }
+
+    const grok::vm::Value *end() const { return args_ + size_; }
+
+    const std::shared_ptr<Handle> &This() const { return this_; }
+
+    /// At ::= handle of the idx-th argument, undefined when there are
+    /// fewer. An immediate gets a new handle, so At() is slower than []
+    std::shared_ptr<Handle> At(size_t idx) const
+    {
+        if (idx >= size_)
+            return CreateUndefinedObject();
+        return args_[idx].Box();
+    }
+
+    /// Number ::= true if the idx-th argument is a number, which is
+    /// stored into number
+    bool Number(size_t idx, double &number) const
+    {
+        if (idx >= size_)
+            return false;
+
+        const auto &V = args_[idx];
+        if (V.IsDouble()) {
+            number = V.AsDouble();
+            return true;
+        } else if (V.IsInt32()) {
+            number = V.AsInt32();
+            return true;
+        } else if (!V.IsCell() || !V.O) {
+            return false;
+        }
+
+        auto O = V.O->get<JSObject>();
+        if (O->GetType() == ObjectType::_double) {
+            number = static_cast<JSDouble*>(O)->GetValue();
+            return true;
+        } else if (O->GetType() == ObjectType::_number) {
+            number = static_cast<JSNumber*>(O)->GetValue();
+            return true;
+        }
+        return false;
+    }
+
+    /// ToString ::= string of the idx-th argument as the old convention
+    /// printed it, numbers are always printed like doubles
+    std::string ToString(size_t idx) const
+    {
+        if (idx >= size_)
+            return UndefinedObject::Get()->ToString();
+
+        const auto &V = args_[idx];
+        if (V.IsDouble())
+            return NumberToString(V.AsDouble());
+        if (V.IsInt32())
+            return NumberToString(V.AsInt32());
+        if (V.IsCell() && V.O)
+            return V.O->get<JSObject>()->ToString();
+        return V.Box()->as<JSObject>()->ToString();
+    }
+
+private:
+    grok::vm::Value *args_;
+    size_t size_;
+    std::shared_ptr<Handle> this_;
+};
+
+/// FastNativeType ::= type of a native function of the fast calling
+/// convention, see NativeArgs
+using FastNativeType = grok::vm::Value (*)(NativeArgs &Args);
+
+} // obj
+} // grok
+
+#endif // NATIVE_ARGS_H_
@@ -2,6 +2,7 @@
 #define REGISTER_H_
 
 #include <memory>
+#include <string>
 
 namespace grok { namespace obj {
 
@@ -75,6 +76,18 @@ public:
         return std::static_pointer_cast<C>(data_);
     }
 
+    /// get ::= same as as<C>() but doesn't touch the reference count,
+    /// for hot paths which only peek at the object
+    template <typename C>
+    inline C *get() const
+    {
+        return static_cast<C*>(data_.get());
+    }
+
+    long use_count() const {
+        return data_.use_count();
+    }
+
     bool empty() const {
         return !data_;
     }
@@ -0,0 +1,174 @@
+#include "object/pool.h"
+
+#include <cstdint>
+#include <cstdlib>
+
+namespace grok {
+namespace obj {
+
+// the caches, the lock and the lists need no constructor, objects freed
+// while the program exits still find them usable
+thread_local ObjectPool::ThreadCache ObjectPool::cache_;
+std::atomic_flag ObjectPool::lock_ = ATOMIC_FLAG_INIT;
+ObjectPool::Chunk *ObjectPool::partial_[ObjectPool::Classes] = { };
+size_t ObjectPool::chunks_ = 0;
+size_t ObjectPool::peak_chunks_ = 0;
+
+void *ObjectPool::Refill(size_t cls)
+{
+    auto &cache = cache_;
+    if (!cache.registered) {
+        // a thread which is exiting doesn't keep blocks anymore
+        if (cache.exited) {
+            Guard guard;
+            return AllocateBlock(cls);
+        }
+        static thread_local CacheFlusher flusher;
+        (void)flusher;
+        cache.registered = true;
+    }
+
+    Guard guard;
+    for (size_t i = 1; i < CacheSize / 2; i++) {
+        auto block = static_cast<Block*>(AllocateBlock(cls));
+        block->next = cache.blocks[cls];
+        cache.blocks[cls] = block;
+        cache.sizes[cls]++;
+    }
+    return AllocateBlock(cls);
+}
+
+void ObjectPool::Flush(size_t cls, void *ptr)
+{
+    auto &cache = cache_;
+    Guard guard;
+    while (cache.sizes[cls] > CacheSize / 2) {
+        auto block = cache.blocks[cls];
+        cache.blocks[cls] = block->next;
+        cache.sizes[cls]--;
+        FreeBlock(block);
+    }
+    FreeBlock(ptr);
+}
+
+void ObjectPool::FlushThreadCache()
+{
+    auto &cache = cache_;
+    Guard guard;
+    for (size_t cls = 0; cls < Classes; cls++) {
+        while (auto block = cache.blocks[cls]) {
+            cache.blocks[cls] = block->next;
+            FreeBlock(block);
+        }
+        cache.sizes[cls] = 0;
+    }
+    cache.registered = false;
+    cache.exited = true;
+}
+
+void *ObjectPool::AllocateBlock(size_t cls)
+{
+    auto size = (cls + 1) * Alignment;
+    auto chunk = partial_[cls];
+    if (!chunk)
+        chunk = NewChunk(cls);
+
+    void *block;
+    if (chunk->free) {
+        block = chunk->free;
+        chunk->free = chunk->free->next;
+    } else {
+        block = chunk->top;
+        chunk->top += size;
+    }
+    chunk->live++;
+
+    // a full chunk leaves the list until one of its blocks is freed
+    auto end = reinterpret_cast<char*>(chunk) + ChunkSize;
+    if (!chunk->free && static_cast<size_t>(end - chunk->top) < size)
+        Unlink(chunk);
+    return block;
+}
+
+void ObjectPool::FreeBlock(void *ptr)
+{
+    auto chunk = reinterpret_cast<Chunk*>(
+        reinterpret_cast<uintptr_t>(ptr) & ~(ChunkSize - 1));
+    auto block = static_cast<Block*>(ptr);
+
+    block->next = chunk->free;
+    chunk->free = block;
+    chunk->live--;
+    if (!chunk->listed)
+        Link(chunk);
+
+    // an empty chunk is kept only if its class has no other room, so
+    // that a block allocated and freed in a loop doesn't get a new chunk
+    // every time
+    if (chunk->live == 0 && (chunk->prev || chunk->next)) {
+        Unlink(chunk);
+        std::free(chunk);
+        chunks_--;
+    }
+}
+
+ObjectPool::Chunk *ObjectPool::NewChunk(size_t cls)
+{
+    void *memory = nullptr;
+    if (posix_memalign(&memory, ChunkSize, ChunkSize))
+        throw std::bad_alloc();
+
+    auto chunk = static_cast<Chunk*>(memory);
+    chunk->prev = chunk->next = nullptr;
+    chunk->free = nullptr;
+    chunk->top = static_cast<char*>(memory) + HeaderSize;
+    chunk->live = 0;
+    chunk->cls = cls;
+    chunk->listed = false;
+    Link(chunk);
+
+    chunks_++;
+    if (chunks_ > peak_chunks_)
+        peak_chunks_ = chunks_;
+    return chunk;
+}
+
+void ObjectPool::Link(Chunk *chunk)
+{
+    auto &head = partial_[chunk->cls];
+    chunk->prev = nullptr;
+    chunk->next = head;
+    if (head)
+        head->prev = chunk;
+    head = chunk;
+    chunk->listed = true;
+}
+
+void ObjectPool::Unlink(Chunk *chunk)
+{
+    if (chunk->prev)
+        chunk->prev->next = chunk->next;
+    else
+        partial_[chunk->cls] = chunk->next;
+    if (chunk->next)
+        chunk->next->prev = chunk->prev;
+    chunk->prev = chunk->next = nullptr;
+    chunk->listed = false;
+}
+
+size_t ObjectPool::Chunks()
+{
+    Guard guard;
+    return chunks_;
+}
+
+void ObjectPool::PrintStats(std::ostream &os)
+{
+    Guard guard;
+    os << "[ Pool: " << chunks_ << " chunks, " << chunks_ * ChunkSize / 1024
+        << "KB in use, " << peak_chunks_ * ChunkSize / 1024 << "KB at peak ]"
+        << std::endl;
+}
+
+} // obj
+} // grok
@@ -0,0 +1,197 @@
+#ifndef POOL_H_
+#define POOL_H_
+
+#include <atomic>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <new>
+
+namespace grok {
+namespace obj {
+
+/// ObjectPool ::= pooled allocator for the small objects which the
+/// interpreter creates for nearly every operation i.e. numbers, strings,
+/// handles and argument objects. It is not a young generation, objects
+/// never move and are freed by their reference counts as before, it only
+/// makes their allocation cheaper than malloc.
+/// Every chunk holds blocks of one size class, blocks are carved from it
+/// by bumping a pointer and freed blocks go to the free list of their
+/// chunk. A chunk whose blocks are all free is returned to the system
+/// unless it is the last one of its class with room left.
+/// The pool may be used from any thread. Each thread keeps upto CacheSize
+/// free blocks of every class to itself, only refilling and flushing that
+/// cache takes the lock of the pool
+class ObjectPool {
+public:
+    static constexpr size_t Alignment = 16;
+    static constexpr size_t MaxSize = 256;
+    static constexpr size_t ChunkSize = 64 * 1024;
+    static constexpr size_t Classes = MaxSize / Alignment;
+    static constexpr size_t CacheSize = 64;
+
+    static void *Allocate(size_t size)
+    {
+        if (size > MaxSize)
+            return ::operator new(size);
+        auto cls = ClassOf(size);
+        auto &cache = cache_;
+        if (auto block = cache.blocks[cls]) {
+            cache.blocks[cls] = block->next;
+            cache.sizes[cls]--;
+            return block;
+        }
+        return Refill(cls);
+    }
+
+    static void Free(void *ptr, size_t size)
+    {
+        if (size > MaxSize) {
+            ::operator delete(ptr);
+            return;
+        }
+        auto cls = ClassOf(size);
+        auto &cache = cache_;
+        if (cache.sizes[cls] < CacheSize && cache.registered) {
+            auto block = static_cast<Block*>(ptr);
+            block->next = cache.blocks[cls];
+            cache.blocks[cls] = block;
+            cache.sizes[cls]++;
+            return;
+        }
+        Flush(cls, ptr);
+    }
+
+    /// Chunks ::= number of chunks the pool holds now
+    static size_t Chunks();
+
+    /// PrintStats ::= prints the memory used by the pool
+    static void PrintStats(std::ostream &os);
+
+private:
+    struct Block {
+        Block *next;
+    };
+
+    // header at the start of every chunk, chunks are aligned to their
+    // size so the chunk of a block is found from its address
+    struct Chunk {
+        Chunk *prev;        // chunks of the class with room left
+        Chunk *next;
+        Block *free;
+        char *top;
+        size_t live;        // blocks in use or in the cache of a thread
+        size_t cls;
+        bool listed;        // whether it is in the list of its class
+    };
+
+    // blocks of a chunk start after its header
+    static constexpr size_t HeaderSize =
+        (sizeof(Chunk) + Alignment - 1) & ~(Alignment - 1);
+
+    // ThreadCache ::= free blocks kept by a thread. Blocks are only kept
+    // while registered i.e. the thread will flush them when it exits
+    struct ThreadCache {
+        Block *blocks[Classes];
+        size_t sizes[Classes];
+        bool registered;
+        bool exited;
+    };
+
+    // CacheFlusher ::= flushes the cache of the thread when it exits
+    struct CacheFlusher {
+        ~CacheFlusher() { FlushThreadCache(); }
+    };
+
+    // Guard ::= holds the lock of the pool while it is alive
+    class Guard {
+    public:
+        Guard()
+        {
+            while (lock_.test_and_set(std::memory_order_acquire))
+                ;
+        }
+
+        ~Guard()
+        {
+            lock_.clear(std::memory_order_release);
+        }
+    };
+
+    static size_t ClassOf(size_t size)
+    {
+        return (size + Alignment - 1) / Alignment - 1;
+    }
+
+    // Refill ::= takes half a cache of blocks from the chunks and returns
+    // one more of them
+    static void *Refill(size_t cls);
+
+    // Flush ::= gives half of the cache and the block back to the chunks
+    static void Flush(size_t cls, void *ptr);
+
+    // FlushThreadCache ::= gives every block of the cache back
+    static void FlushThreadCache();
+
+    // the lock must be held for these
+    static void *AllocateBlock(size_t cls);
+    static void FreeBlock(void *ptr);
+    static Chunk *NewChunk(size_t cls);
+    static void Link(Chunk *chunk);
+    static void Unlink(Chunk *chunk);
+
+    static thread_local ThreadCache cache_;
+    static std::atomic_flag lock_;
+    static Chunk *partial_[Classes];
+    static size_t chunks_;
+    static size_t peak_chunks_;
+};
+
+/// PoolAllocator ::= standard allocator on top of the pool, used with
+/// std::allocate_shared so that the object and its control block come
+/// from one block
+template <typename T>
+struct PoolAllocator {
+    using value_type = T;
+
+    PoolAllocator() = default;
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U> &) { }
+
+    T *allocate(size_t n)
+    {
+        return static_cast<T*>(ObjectPool::Allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T *ptr, size_t n)
+    {
+        ObjectPool::Free(ptr, n * sizeof(T));
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const PoolAllocator<T>&, const PoolAllocator<U>&)
+{
+    return true;
+}
+
+template <typename T, typename U>
+bool operator!=(const PoolAllocator<T>&, const PoolAllocator<U>&)
+{
+    return false;
+}
+
+/// AllocateShared ::= same as std::make_shared but allocates from
+/// the pool
+template <typename T, typename... Args>
+static inline std::shared_ptr<T> AllocateShared(Args&&... args)
+{
+    return std::allocate_shared<T>(PoolAllocator<T>{ },
+        std::forward<Args>(args)...);
+}
+
+} // obj
+} // grok
+
+#endif // pool.h
@@ -19,7 +19,7 @@ void AddPropertiesFromPrototype(JSObject *ctor, JSObject *obj)
 
     std::shared_ptr<JSObject> proto = proto_wrapped->as<JSObject>();
 
-    for (auto &property : *proto) {
+    for (const auto &property : *proto) {
         obj->AddProperty(property.first, CreateCopy(property.second));
     }
 }
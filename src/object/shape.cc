@@ -0,0 +1,77 @@
+#include "object/shape.h"
+
+#include <stdexcept>
+
+namespace grok {
+namespace obj {
+
+Shape *Shape::Empty()
+{
+    static Shape *root = new Shape();
+    return root;
+}
+
+Shape *Shape::AddProperty(Atom atom)
+{
+    if (dictionary_) {
+        table_[AtomTable::Name(atom)] = slot_count_;
+        slots_[atom] = slot_count_++;
+        return this;
+    }
+
+    auto it = transitions_.find(atom);
+    if (it != transitions_.end())
+        return it->second.get();
+
+    if (table_.size() >= MaxTreeProperties)
+        return nullptr;
+
+    std::unique_ptr<Shape> child{ new Shape() };
+    child->table_ = table_;
+    child->table_[AtomTable::Name(atom)] = slot_count_;
+    child->slots_ = slots_;
+    child->slots_[atom] = slot_count_;
+    child->slot_count_ = slot_count_ + 1;
+
+    auto shape = child.get();
+    transitions_[atom] = std::move(child);
+    return shape;
+}
+
+Shape *Shape::AddProperty(const Name &name)
+{
+    Atom atom;
+    if (!dictionary_ || AtomTable::Find(name, atom))
+        return AddProperty(AtomTable::Intern(name));
+
+    table_[name] = slot_count_++;
+    unnamed_++;
+    return this;
+}
+
+void Shape::RemoveProperty(const Name &name)
+{
+    if (!dictionary_)
+        throw std::runtime_error("fatal: property removed from a shared "
+            "shape");
+    if (!table_.erase(name))
+        return;
+
+    Atom atom;
+    if (!AtomTable::Find(name, atom) || !slots_.erase(atom))
+        unnamed_--;
+}
+
+std::unique_ptr<Shape> Shape::CloneAsDictionary() const
+{
+    std::unique_ptr<Shape> dict{ new Shape() };
+    dict->table_ = table_;
+    dict->slots_ = slots_;
+    dict->slot_count_ = slot_count_;
+    dict->unnamed_ = unnamed_;
+    dict->dictionary_ = true;
+    return dict;
+}
+
+} // obj
+} // grok
@@ -0,0 +1,113 @@
+#ifndef SHAPE_H_
+#define SHAPE_H_
+
+#include "object/atom.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace grok {
+namespace obj {
+
+/// Shape ::= layout of the properties of an object i.e. the slot in which
+/// the value of each property is stored. Objects which got the same
+/// properties in the same order share one shape, shapes form a tree of
+/// transitions rooted at the empty shape where each edge adds a property.
+/// An object that grows too large or loses a property switches to a
+/// dictionary shape which is owned by that object only and is modified
+/// in place. Shapes in the tree are never freed. Properties are looked up
+/// by their atoms, the names are only kept for iterating in their order.
+/// A dictionary keeps a name which isn't interned by its string only, so
+/// that computed keys don't fill the atom table which is never freed.
+class Shape {
+public:
+    using Name = std::string;
+    using Table = std::map<Name, size_t>;
+    using const_iterator = Table::const_iterator;
+
+    /// MaxTreeProperties ::= objects with more properties than this
+    /// go to dictionary mode
+    static constexpr size_t MaxTreeProperties = 32;
+
+    /// Empty ::= returns the root of the transition tree
+    static Shape *Empty();
+
+    /// Lookup ::= returns true if the shape has the property and sets slot
+    bool Lookup(Atom atom, size_t &slot) const
+    {
+        auto it = slots_.find(atom);
+        if (it != slots_.end()) {
+            slot = it->second;
+            return true;
+        }
+        // the name may have been added before it was interned
+        return unnamed_ && LookupName(AtomTable::Name(atom), slot);
+    }
+
+    bool Lookup(const Name &name, size_t &slot) const
+    {
+        Atom atom;
+        if (AtomTable::Find(name, atom))
+            return Lookup(atom, slot);
+        return unnamed_ && LookupName(name, slot);
+    }
+
+    /// AddProperty ::= returns the shape with the property added to this
+    /// one, the new property always takes slot SlotCount() of this shape.
+    /// A dictionary shape adds it to itself and returns `this`, a shape
+    /// from the tree returns nullptr if the object should become a
+    /// dictionary instead
+    Shape *AddProperty(Atom atom);
+
+    /// A name which isn't interned is interned only for a shape of the
+    /// tree, a dictionary keeps it by its string
+    Shape *AddProperty(const Name &name);
+
+    /// RemoveProperty ::= removes a property of a dictionary shape, its
+    /// slot is left unused
+    void RemoveProperty(const Name &name);
+
+    /// CloneAsDictionary ::= returns a dictionary shape with the same layout
+    std::unique_ptr<Shape> CloneAsDictionary() const;
+
+    /// SlotCount ::= number of slots an object of this shape needs
+    size_t SlotCount() const { return slot_count_; }
+
+    /// Size ::= number of properties
+    size_t Size() const { return table_.size(); }
+
+    bool IsDictionary() const { return dictionary_; }
+
+    /// properties are visited ordered by their names
+    const_iterator begin() const { return table_.begin(); }
+    const_iterator end() const { return table_.end(); }
+
+private:
+    Shape()
+        : table_{ }, slots_{ }, transitions_{ }, slot_count_{ 0 },
+          unnamed_{ 0 }, dictionary_{ false }
+    { }
+
+    bool LookupName(const Name &name, size_t &slot) const
+    {
+        auto it = table_.find(name);
+        if (it == table_.end())
+            return false;
+        slot = it->second;
+        return true;
+    }
+
+    Table table_;
+    std::unordered_map<Atom, size_t> slots_;
+    std::map<Atom, std::unique_ptr<Shape>> transitions_;
+    size_t slot_count_;
+    size_t unnamed_;        // properties of table_ which aren't in slots_
+    bool dictionary_;
+};
+
+} // obj
+} // grok
+
+#endif // shape.h
@@ -0,0 +1,244 @@
+#include "object/typed-array.h"
+#include "object/function.h"
+#include "object/jsnumber.h"
+#include "common/exceptions.h"
+
+#include "libs/typed-array/methods.h"
+#include "libs/array/numeric.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace grok {
+namespace obj {
+
+ArrayBuffer::ArrayBuffer(size_t byte_length)
+  : data_{ nullptr }, byte_length_{ byte_length }
+{
+    void *data = nullptr;
+    // an empty buffer still gets a block, so Data() is never null
+    if (posix_memalign(&data, Alignment, std::max<size_t>(byte_length, 1)))
+        throw RangeError("can't allocate an ArrayBuffer of "
+            + std::to_string(byte_length) + " bytes");
+    data_ = static_cast<uint8_t*>(data);
+    std::memset(data_, 0, byte_length_);
+}
+
+ArrayBuffer::~ArrayBuffer()
+{
+    std::free(data_);
+}
+
+std::string ArrayBuffer::AsString() const
+{
+    return "ArrayBuffer { byteLength: " + std::to_string(byte_length_) + " }";
+}
+
+JSObject::Value ArrayBuffer::GetProperty(const JSObject::Name &name)
+{
+    if (name == "byteLength")
+        return CreateJSNumber(byte_length_);
+    return JSObject::GetProperty(name);
+}
+
+TypedArray::TypedArray(TypedArrayKind kind,
+    std::shared_ptr<ArrayBuffer> buffer, size_t offset, size_t length)
+  : kind_{ kind }, buffer_{ buffer }, data_{ buffer_->Data() + offset },
+    offset_{ offset }, length_{ length }
+{
+}
+
+size_t TypedArray::ElementSize(TypedArrayKind kind)
+{
+    switch (kind) {
+    case TypedArrayKind::float64:
+        return sizeof(double);
+    case TypedArrayKind::int32:
+        return sizeof(int32_t);
+    case TypedArrayKind::uint8:
+    default:
+        return sizeof(uint8_t);
+    }
+}
+
+const char *TypedArray::Name(TypedArrayKind kind)
+{
+    switch (kind) {
+    case TypedArrayKind::float64:
+        return "Float64Array";
+    case TypedArrayKind::int32:
+        return "Int32Array";
+    case TypedArrayKind::uint8:
+    default:
+        return "Uint8Array";
+    }
+}
+
+/// ToUint32 ::= the number modulo 2^32 as the integer typed arrays store
+/// it, NaN and the infinities are 0
+static uint32_t ToUint32(double number)
+{
+    if (number >= 0 && number < 4294967296.0)
+        return static_cast<uint32_t>(number);
+    if (!std::isfinite(number))
+        return 0;
+
+    auto n = std::fmod(std::trunc(number), 4294967296.0);
+    if (n < 0)
+        n += 4294967296.0;
+    return static_cast<uint32_t>(n);
+}
+
+void TypedArray::Set(size_t idx, double number)
+{
+    switch (kind_) {
+    case TypedArrayKind::float64:
+        Data<double>()[idx] = number;
+        break;
+    case TypedArrayKind::int32:
+        Data<int32_t>()[idx] = static_cast<int32_t>(ToUint32(number));
+        break;
+    case TypedArrayKind::uint8:
+        Data<uint8_t>()[idx] = static_cast<uint8_t>(ToUint32(number));
+        break;
+    }
+}
+
+std::string TypedArray::Join(const std::string &sep) const
+{
+    std::vector<std::string> strings;
+    strings.reserve(length_);
+    size_t length = length_ ? sep.size() * (length_ - 1) : 0;
+    for (size_t i = 0; i < length_; i++) {
+        strings.push_back(NumberToString(Get(i)));
+        length += strings.back().size();
+    }
+
+    std::string buff;
+    buff.reserve(length);
+    for (size_t i = 0; i < strings.size(); i++) {
+        if (i)
+            buff += sep;
+        buff += strings[i];
+    }
+    return buff;
+}
+
+std::string TypedArray::AsString() const
+{
+    return std::string(Name(kind_)) + " [ " + Join(", ") + " ]";
+}
+
+JSObject::Value TypedArray::GetProperty(const JSObject::Name &name)
+{
+    if (name == "length")
+        return CreateJSNumber(length_);
+    if (name == "byteLength")
+        return CreateJSNumber(length_ * ElementSize(kind_));
+    if (name == "byteOffset")
+        return CreateJSNumber(offset_);
+    if (name == "buffer")
+        return AllocateShared<Object>(buffer_);
+    if (name == "BYTES_PER_ELEMENT")
+        return CreateJSNumber(ElementSize(kind_));
+
+    // elements are numbers read from the buffer, the ones out of range
+    // are undefined
+    if (name.size() && std::all_of(name.begin(), name.end(),
+            [](char c) { return c >= '0' && c <= '9'; })) {
+        auto idx = std::strtod(name.c_str(), nullptr);
+        if (idx < length_)
+            return CreateJSNumber(Get(static_cast<size_t>(idx)));
+        return CreateUndefinedObject();
+    }
+
+    auto p = GetStaticProperty(name);
+    if (p.second)
+        return p.first;
+    return JSObject::GetProperty(name);
+}
+
+std::shared_ptr<Handle> TypedArray::typed_array_handle;
+
+std::pair<std::shared_ptr<Handle>, bool>
+ TypedArray::GetStaticProperty(const std::string &str)
+{
+    auto methods = typed_array_handle->as<JSObject>();
+
+    if (!methods->HasProperty(str))
+        return { nullptr, false };
+    return { methods->GetProperty(str), true };
+}
+
+void TypedArray::Init()
+{
+    typed_array_handle = CreateJSObject();
+    auto ptr = typed_array_handle->as<JSObject>();
+
+    // a.fill(value)
+    auto S = std::make_shared<Function>(grok::libs::TypedArrayFill);
+    S->SetNonWritable();
+    S->SetNonEnumerable();
+    S->SetParams({ "value" });
+    ptr->AddProperty(std::string("fill"), std::make_shared<Object>(S));
+
+    // a.set(source, offset)
+    S = std::make_shared<Function>(grok::libs::TypedArraySet);
+    S->SetNonWritable();
+    S->SetNonEnumerable();
+    S->SetParams({ "source", "offset" });
+    ptr->AddProperty(std::string("set"), std::make_shared<Object>(S));
+
+    // a.subarray(begin, end)
+    S = std::make_shared<Function>(grok::libs::TypedArraySubarray);
+    S->SetNonWritable();
+    S->SetNonEnumerable();
+    S->SetParams({ "begin", "end" });
+    ptr->AddProperty(std::string("subarray"), std::make_shared<Object>(S));
+
+    // a.join(sep)
+    S = std::make_shared<Function>(grok::libs::TypedArrayJoin);
+    S->SetNonWritable();
+    S->SetNonEnumerable();
+    S->SetParams({ "sep" });
+    ptr->AddProperty(std::string("join"), std::make_shared<Object>(S));
+
+    grok::libs::DefineNumericMethods(ptr.get());
+}
+
+double ToElementNumber(std::shared_ptr<Object> obj)
+{
+    auto O = obj->as<JSObject>();
+    if (O->GetType() == ObjectType::_double)
+        return obj->as<JSDouble>()->GetValue();
+    if (O->GetType() == ObjectType::_number)
+        return obj->as<JSNumber>()->GetValue();
+    if (O->GetType() == ObjectType::_undefined)
+        return std::numeric_limits<double>::quiet_NaN();
+
+    auto maybenum = CreateJSNumber(O->ToString());
+    if (IsUndefined(maybenum))
+        return std::numeric_limits<double>::quiet_NaN();
+    return ToElementNumber(maybenum);
+}
+
+std::shared_ptr<Object> CreateArrayBuffer(size_t byte_length)
+{
+    auto B = AllocateShared<ArrayBuffer>(byte_length);
+    return AllocateShared<Object>(B);
+}
+
+std::shared_ptr<Object> CreateTypedArray(TypedArrayKind kind, size_t length)
+{
+    auto buffer = CreateArrayBuffer(length * TypedArray::ElementSize(kind));
+    auto A = AllocateShared<TypedArray>(kind, buffer->as<ArrayBuffer>(), 0,
+        length);
+    return AllocateShared<Object>(A);
+}
+
+}
+}
@@ -0,0 +1,147 @@
+#ifndef TYPED_ARRAY_H_
+#define TYPED_ARRAY_H_
+
+#include "object/jsobject.h"
+
+#include <cstdint>
+
+namespace grok {
+namespace obj {
+
+/// ArrayBuffer ::= fixed block of zeroed bytes shared by the typed arrays
+/// which view it. The block is aligned for the vector instructions, so
+/// native kernels can work on the elements where they are
+class ArrayBuffer : public JSObject {
+public:
+  static constexpr size_t Alignment = 64;
+
+  explicit ArrayBuffer(size_t byte_length);
+  ArrayBuffer(const ArrayBuffer &) = delete;
+  ArrayBuffer &operator=(const ArrayBuffer &) = delete;
+  ~ArrayBuffer();
+
+  uint8_t *Data() const { return data_; }
+
+  size_t ByteLength() const { return byte_length_; }
+
+  ObjectType GetType() const override
+  {
+    return ObjectType::_array_buffer;
+  }
+
+  std::string ToString() const override { return "[object ArrayBuffer]"; }
+
+  std::string AsString() const override;
+
+  JSObject::Value GetProperty(const JSObject::Name &name) override;
+
+private:
+  uint8_t *data_;
+  size_t byte_length_;
+};
+
+/// TypedArrayKind ::= element type of a typed array
+enum class TypedArrayKind {
+  float64,
+  int32,
+  uint8
+};
+
+/// TypedArray ::= view of `length` elements of one type at `offset` bytes
+/// into an ArrayBuffer. Elements are read as numbers and converted to the
+/// element type when stored, there is never a handle for an element.
+/// The buffer is answered by GetProperty, so it can't be replaced
+class TypedArray : public JSObject {
+public:
+  TypedArray(TypedArrayKind kind, std::shared_ptr<ArrayBuffer> buffer,
+    size_t offset, size_t length);
+
+  TypedArrayKind Kind() const { return kind_; }
+
+  size_t Length() const { return length_; }
+
+  size_t ByteOffset() const { return offset_; }
+
+  std::shared_ptr<ArrayBuffer> Buffer() const { return buffer_; }
+
+  static size_t ElementSize(TypedArrayKind kind);
+
+  /// Name ::= name of the constructor of the kind e.g. "Float64Array"
+  static const char *Name(TypedArrayKind kind);
+
+  /// Data ::= the first element, T must be the element type of the kind
+  template <typename T>
+  T *Data() const { return reinterpret_cast<T*>(data_); }
+
+  /// Get ::= the element at idx, which must be less than Length()
+  double Get(size_t idx) const
+  {
+    switch (kind_) {
+    case TypedArrayKind::float64:
+      return Data<double>()[idx];
+    case TypedArrayKind::int32:
+      return Data<int32_t>()[idx];
+    case TypedArrayKind::uint8:
+    default:
+      return Data<uint8_t>()[idx];
+    }
+  }
+
+  /// Set ::= converts the number to the element type and stores it, idx
+  /// must be less than Length()
+  void Set(size_t idx, double number);
+
+  ObjectType GetType() const override
+  {
+    return ObjectType::_typed_array;
+  }
+
+  /// Join ::= strings of the elements separated by sep
+  std::string Join(const std::string &sep) const;
+
+  std::string ToString() const override { return Join(","); }
+
+  std::string AsString() const override;
+
+  JSObject::Value GetProperty(const JSObject::Name &name) override;
+
+private:
+  TypedArrayKind kind_;
+  std::shared_ptr<ArrayBuffer> buffer_;
+  uint8_t *data_;
+  size_t offset_;
+  size_t length_;
+
+public:
+  static std::shared_ptr<Handle> typed_array_handle;
+  static void Init();
+  static std::pair<std::shared_ptr<Handle>, bool>
+   GetStaticProperty(const std::string &str);
+};
+
+static inline bool IsTypedArray(std::shared_ptr<Object> obj)
+{
+  return obj->as<JSObject>()->GetType() == ObjectType::_typed_array;
+}
+
+static inline bool IsArrayBuffer(std::shared_ptr<Object> obj)
+{
+  return obj->as<JSObject>()->GetType() == ObjectType::_array_buffer;
+}
+
+/// ToElementNumber ::= the number stored for obj in a typed array, NaN for
+/// the objects which aren't numbers or numeric strings
+extern double ToElementNumber(std::shared_ptr<Object> obj);
+
+/// CreateArrayBuffer ::= a new zeroed ArrayBuffer of byte_length bytes
+extern std::shared_ptr<Object> CreateArrayBuffer(size_t byte_length);
+
+/// CreateTypedArray ::= a new typed array of length elements with a
+/// buffer of its own
+extern std::shared_ptr<Object> CreateTypedArray(TypedArrayKind kind,
+  size_t length);
+
+} // obj
+} // grok
+
+#endif // TYPED_ARRAY_H_
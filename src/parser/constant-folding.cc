@@ -0,0 +1,491 @@
+#include "parser/constant-folding.h"
+
+#include <cmath>
+
+namespace grok {
+namespace parser {
+
+using Constant = ConstantFolding::Constant;
+
+void ConstantFolding::Fold(std::unique_ptr<Expression> &tree)
+{
+    ConstantFolding folding;
+    folding.FoldValue(tree);
+}
+
+Constant ConstantFolding::FoldValue(std::unique_ptr<Expression> &expr,
+    bool *is_double)
+{
+    Constant value;
+    if (!expr) {
+        if (is_double)
+            *is_double = false;
+        return value;
+    }
+
+    expr->Accept(this);
+    if (replacement_)
+        expr = std::move(replacement_);
+
+    std::swap(value, constant_);
+    if (is_double)
+        *is_double = is_double_;
+    is_double_ = false;
+    return value;
+}
+
+bool ConstantFolding::FoldBranch(std::unique_ptr<Expression> &stmt)
+{
+    auto declared = declares_;
+    declares_ = false;
+    FoldValue(stmt);
+
+    auto result = declares_;
+    declares_ = declares_ || declared;
+    return result;
+}
+
+void ConstantFolding::Replace(std::unique_ptr<Expression> expr)
+{
+    replacement_ = std::move(expr);
+}
+
+/// int32 constants stay as they are, see ConstantFolding
+void ConstantFolding::ReplaceWithConstant()
+{
+    is_double_ = constant_.kind == Constant::number;
+    if (constant_.kind == Constant::number)
+        Replace(std::make_unique<IntegralLiteral>(constant_.d));
+    else if (constant_.kind == Constant::string)
+        Replace(std::make_unique<StringLiteral>(constant_.s));
+}
+
+static std::unique_ptr<Expression> EmptyStatement()
+{
+    return std::make_unique<BlockStatement>(ExpressionList());
+}
+
+static Constant NumberConstant(double number)
+{
+    Constant result;
+    result.kind = Constant::number;
+    result.d = number;
+    return result;
+}
+
+static Constant Int32Constant(int32_t number)
+{
+    Constant result;
+    result.kind = Constant::int32;
+    result.i = number;
+    return result;
+}
+
+/// IsTrue ::= truth of the constant as the flags of the VM see it
+static bool IsTrue(const Constant &value)
+{
+    switch (value.kind) {
+    case Constant::number:
+        return value.d;
+    case Constant::int32:
+        return value.i;
+    default:
+        return value.s.size();
+    }
+}
+
+static bool IsNumeric(const Constant &value)
+{
+    return value.kind == Constant::number || value.kind == Constant::int32;
+}
+
+static double AsDouble(const Constant &value)
+{
+    return value.kind == Constant::int32 ? value.i : value.d;
+}
+
+/// ToInt32 ::= truncates the number as the VM does, fails for the doubles
+/// which don't fit in an int32 since their conversion is undefined
+static bool ToInt32(const Constant &value, int32_t &result)
+{
+    if (value.kind == Constant::int32) {
+        result = value.i;
+        return true;
+    }
+    if (value.kind != Constant::number || !(value.d > INT32_MIN - 1.0)
+            || !(value.d < INT32_MAX + 1.0))
+        return false;
+    result = static_cast<int32_t>(value.d);
+    return true;
+}
+
+static int32_t WrapInt32(int64_t num)
+{
+    return static_cast<int32_t>(static_cast<uint32_t>(num));
+}
+
+template <typename T>
+static T Arithmetic(TokenType op, T lhs, T rhs)
+{
+    return op == PLUS ? lhs + rhs : op == MINUS ? lhs - rhs : lhs * rhs;
+}
+
+/// FoldOperator ::= result of the binary operator on the constants as the
+/// fast paths of the VM compute it. Operands which would take the generic
+/// path aren't folded, except for strings which are concatenated and
+/// compared for (in)equality
+static bool FoldOperator(TokenType op, const Constant &lhs,
+    const Constant &rhs, Constant &result)
+{
+    if (lhs.kind == Constant::string && rhs.kind == Constant::string) {
+        if (op == PLUS) {
+            result.kind = Constant::string;
+            result.s = lhs.s + rhs.s;
+        } else if (op == EQUAL || op == NOTEQ) {
+            result = Int32Constant((lhs.s == rhs.s) == (op == EQUAL));
+        } else {
+            return false;
+        }
+        return true;
+    }
+    if (!IsNumeric(lhs) || !IsNumeric(rhs))
+        return false;
+
+    auto ints = lhs.kind == Constant::int32 && rhs.kind == Constant::int32;
+    auto l = AsDouble(lhs), r = AsDouble(rhs);
+    int32_t li, ri;
+
+    switch (op) {
+    default:
+        return false;
+    case PLUS:
+    case MINUS:
+    case MUL:
+        if (ints)
+            result = Int32Constant(WrapInt32(
+                Arithmetic<int64_t>(op, lhs.i, rhs.i)));
+        else
+            result = NumberConstant(Arithmetic(op, l, r));
+        return true;
+    case DIV:
+        if (!ints) {
+            result = NumberConstant(l / r);
+            return true;
+        } else if (rhs.i == 0
+                || (rhs.i == -1 && lhs.i == INT32_MIN)) {
+            return false;
+        }
+        result = Int32Constant(lhs.i / rhs.i);
+        return true;
+    case MOD:
+        if (!ToInt32(lhs, li) || !ToInt32(rhs, ri) || ri == 0
+                || (ri == -1 && li == INT32_MIN))
+            return false;
+        result = Int32Constant(li % ri);
+        return true;
+    case LT:
+        result = Int32Constant(l < r);
+        return true;
+    case GT:
+        result = Int32Constant(l > r);
+        return true;
+    case LTE:
+        result = Int32Constant(l <= r);
+        return true;
+    case GTE:
+        result = Int32Constant(l >= r);
+        return true;
+    case EQUAL:
+        result = Int32Constant(l == r);
+        return true;
+    case NOTEQ:
+        result = Int32Constant(l != r);
+        return true;
+    case SHL:
+    case SHR:
+        if (!ToInt32(lhs, li) || !ToInt32(rhs, ri) || ri < 0 || ri > 31)
+            return false;
+        result = Int32Constant(op == SHR ? li >> ri
+            : WrapInt32(static_cast<uint32_t>(li) << ri));
+        return true;
+    case BOR:
+    case BAND:
+    case XOR:
+        if (!ToInt32(lhs, li) || !ToInt32(rhs, ri))
+            return false;
+        result = Int32Constant(op == BOR ? li | ri
+            : op == BAND ? li & ri : li ^ ri);
+        return true;
+    case OR:
+    case AND:
+    {
+        // both sides are evaluated, see LOGICAL_OPERATOR in vm.cc
+        if (!ToInt32(lhs, li)
+                || (lhs.kind == Constant::number && !ToInt32(rhs, ri)))
+            return false;
+        bool lt = li != 0;
+        bool rt = lhs.kind == Constant::int32 ? r != 0 : ri != 0;
+        result = Int32Constant(op == OR ? lt || rt : lt && rt);
+        return true;
+    }
+    }
+}
+
+static bool IsNumber(const Constant &value, double number)
+{
+    return value.kind == Constant::number && value.d == number
+        && !std::signbit(value.d);
+}
+
+void ConstantFolding::Visit(NullLiteral *) { }
+
+void ConstantFolding::Visit(ThisHolder *) { }
+
+void ConstantFolding::Visit(IntegralLiteral *i)
+{
+    constant_ = NumberConstant(i->value());
+    is_double_ = true;
+}
+
+void ConstantFolding::Visit(StringLiteral *s)
+{
+    constant_.kind = Constant::string;
+    constant_.s = s->string();
+}
+
+void ConstantFolding::Visit(ArrayLiteral *a)
+{
+    for (auto &expr : a->exprs())
+        FoldValue(expr);
+}
+
+void ConstantFolding::Visit(ObjectLiteral *o)
+{
+    for (auto &prop : o->proxy())
+        FoldValue(prop.second);
+}
+
+void ConstantFolding::Visit(Identifier *) { }
+
+/// booleans are pushed as doubles
+void ConstantFolding::Visit(BooleanLiteral *b)
+{
+    constant_ = NumberConstant(b->pred());
+    is_double_ = true;
+}
+
+void ConstantFolding::Visit(ArgumentList *a)
+{
+    for (auto &expr : a->args())
+        FoldValue(expr);
+}
+
+void ConstantFolding::Visit(FunctionCallExpression *f)
+{
+    for (auto &expr : f->args())
+        FoldValue(expr);
+    FoldValue(f->func());
+}
+
+void ConstantFolding::Visit(CallExpression *c)
+{
+    for (auto &expr : c->members())
+        FoldValue(expr);
+    FoldValue(c->func());
+}
+
+void ConstantFolding::Visit(DotMemberExpression *) { }
+
+void ConstantFolding::Visit(IndexMemberExpression *i)
+{
+    FoldValue(i->expr());
+}
+
+void ConstantFolding::Visit(MemberExpression *m)
+{
+    for (auto &expr : m->members())
+        FoldValue(expr);
+}
+
+void ConstantFolding::Visit(NewExpression *n)
+{
+    FoldValue(n->member());
+}
+
+/// `!` and `~` push doubles
+void ConstantFolding::Visit(PrefixExpression *p)
+{
+    int32_t number;
+    auto value = FoldValue(p->expr());
+
+    if (p->op() == NOT) {
+        is_double_ = true;
+        if (value.kind != Constant::none) {
+            constant_ = NumberConstant(!IsTrue(value));
+            ReplaceWithConstant();
+        }
+    } else if (p->op() == BNOT) {
+        is_double_ = true;
+        if (ToInt32(value, number)) {
+            constant_ = NumberConstant(~number);
+            ReplaceWithConstant();
+        }
+    }
+}
+
+void ConstantFolding::Visit(PostfixExpression *p)
+{
+    FoldValue(p->expr());
+}
+
+/// `x * 1`, `1 * x`, `x / 1` and `x - 0` are x only if x is a double, they
+/// turn an int32 into a double and anything else goes through the generic
+/// operators. `x + 0` isn't x when x is -0
+void ConstantFolding::Visit(BinaryExpression *b)
+{
+    bool lhs_double, rhs_double;
+    auto op = b->op();
+    auto lhs = FoldValue(b->lhs(), &lhs_double);
+    auto rhs = FoldValue(b->rhs(), &rhs_double);
+
+    Constant result;
+    if (FoldOperator(op, lhs, rhs, result)) {
+        constant_ = std::move(result);
+        ReplaceWithConstant();
+        return;
+    }
+
+    is_double_ = lhs_double && rhs_double
+        && (op == PLUS || op == MINUS || op == MUL || op == DIV);
+    if (!is_double_)
+        return;
+
+    if ((op == MUL || op == DIV) && IsNumber(rhs, 1.0))
+        Replace(std::move(b->lhs()));
+    else if (op == MUL && IsNumber(lhs, 1.0))
+        Replace(std::move(b->rhs()));
+    else if (op == MINUS && IsNumber(rhs, 0.0))
+        Replace(std::move(b->lhs()));
+}
+
+void ConstantFolding::Visit(AssignExpression *a)
+{
+    FoldValue(a->lhs());
+    FoldValue(a->rhs());
+}
+
+void ConstantFolding::Visit(TernaryExpression *t)
+{
+    bool second_double, third_double;
+    auto condition = FoldValue(t->first());
+    auto second = FoldValue(t->second(), &second_double);
+    auto third = FoldValue(t->third(), &third_double);
+
+    if (condition.kind == Constant::none)
+        return;
+
+    auto taken = IsTrue(condition);
+    constant_ = taken ? std::move(second) : std::move(third);
+    is_double_ = taken ? second_double : third_double;
+    Replace(std::move(taken ? t->second() : t->third()));
+}
+
+void ConstantFolding::Visit(CommaExpression *c)
+{
+    for (auto &expr : c->exprs())
+        FoldValue(expr);
+}
+
+void ConstantFolding::Visit(Declaration *d)
+{
+    declares_ = true;
+    FoldValue(d->expr());
+}
+
+void ConstantFolding::Visit(DeclarationList *d)
+{
+    for (auto &decl : d->exprs())
+        Visit(decl.get());
+}
+
+/// a branch which is never taken is dropped unless it declares something,
+/// the code for a variable is generated when it is declared
+void ConstantFolding::Visit(IfStatement *i)
+{
+    auto condition = FoldValue(i->condition());
+    auto declares = FoldBranch(i->body());
+
+    if (condition.kind == Constant::none)
+        return;
+    if (IsTrue(condition))
+        Replace(std::move(i->body()));
+    else if (!declares)
+        Replace(EmptyStatement());
+}
+
+void ConstantFolding::Visit(IfElseStatement *i)
+{
+    auto condition = FoldValue(i->condition());
+    auto body_declares = FoldBranch(i->body());
+    auto else_declares = FoldBranch(i->els());
+
+    if (condition.kind == Constant::none)
+        return;
+    if (IsTrue(condition) && !else_declares)
+        Replace(std::move(i->body()));
+    else if (!IsTrue(condition) && !body_declares)
+        Replace(std::move(i->els()));
+}
+
+void ConstantFolding::Visit(ForStatement *f)
+{
+    FoldValue(f->init());
+    auto condition = FoldValue(f->condition());
+    FoldValue(f->update());
+    auto declares = FoldBranch(f->body());
+
+    if (condition.kind != Constant::none && !IsTrue(condition)
+            && !declares)
+        Replace(f->init() ? std::move(f->init()) : EmptyStatement());
+}
+
+void ConstantFolding::Visit(WhileStatement *w)
+{
+    auto condition = FoldValue(w->condition());
+    auto declares = FoldBranch(w->body());
+
+    if (condition.kind != Constant::none && !IsTrue(condition)
+            && !declares)
+        Replace(EmptyStatement());
+}
+
+/// the value of the body is popped by the loop, so `do ... while (false)`
+/// stays a loop
+void ConstantFolding::Visit(DoWhileStatement *d)
+{
+    FoldValue(d->body());
+    FoldValue(d->condition());
+}
+
+void ConstantFolding::Visit(BlockStatement *b)
+{
+    for (auto &stmt : b->statements())
+        FoldValue(stmt);
+}
+
+void ConstantFolding::Visit(FunctionPrototype *) { }
+
+/// a nested function has been folded when it was parsed, its name is
+/// declared in the function enclosing it
+void ConstantFolding::Visit(FunctionStatement *)
+{
+    declares_ = true;
+}
+
+void ConstantFolding::Visit(ReturnStatement *r)
+{
+    FoldValue(r->expr());
+}
+
+} // parser
+} // grok
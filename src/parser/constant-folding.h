@@ -0,0 +1,60 @@
+#ifndef CONSTANT_FOLDING_H_
+#define CONSTANT_FOLDING_H_
+
+#include "parser/astvisitor.h"
+
+#include <cstdint>
+#include <string>
+
+namespace grok {
+namespace parser {
+
+/// ConstantFolding ::= evaluates the operators whose operands are literals
+/// at parse time, applies the identities which hold for any operand of
+/// the operator and drops the branches a constant condition never takes.
+/// The result of a folded operator is the one the VM would have produced,
+/// an int32 result can't be written as a literal (literals are doubles)
+/// so it is only used to fold the operator or the branch enclosing it
+class ConstantFolding : public ASTVisitor {
+public:
+    /// Fold ::= folds the statement or the body of a function in place, the
+    /// functions nested in it have been folded when they were parsed
+    static void Fold(std::unique_ptr<Expression> &tree);
+
+#define DECLARE_VISIT(type) void Visit(type *) override;
+AST_NODE_LIST(DECLARE_VISIT)
+#undef DECLARE_VISIT
+
+    /// Constant ::= value of the expression visited last, if it has one
+    struct Constant {
+        enum Kind { none, number, int32, string };
+
+        Kind kind = none;
+        double d = 0.0;
+        int32_t i = 0;
+        std::string s;
+    };
+
+private:
+    /// FoldValue ::= folds the expression, returns its value if it is
+    /// constant and sets is_double if it is a double anyway
+    Constant FoldValue(std::unique_ptr<Expression> &expr,
+        bool *is_double = nullptr);
+
+    /// FoldBranch ::= folds a statement which runs only if a condition
+    /// holds and returns true if it declares a variable or a function
+    bool FoldBranch(std::unique_ptr<Expression> &stmt);
+
+    void Replace(std::unique_ptr<Expression> expr);
+    void ReplaceWithConstant();
+
+    Constant constant_;
+    bool is_double_ = false;            // value is a double if not constant
+    bool declares_ = false;
+    std::unique_ptr<Expression> replacement_;
+};
+
+} // parser
+} // grok
+
+#endif // constant-folding.h
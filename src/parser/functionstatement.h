@@ -2,6 +2,7 @@
 #define FUNCTION_STATEMENT_H_
 
 #include "parser/expression.h"
+#include <set>
 #include <vector>
 #include <string>
 
@@ -35,9 +36,19 @@ public:
 
     std::unique_ptr<FunctionPrototype> &proto() { return proto_; }
     std::unique_ptr<Expression> &body() { return body_; }
+
+    /// captured ::= variables of the function which the functions nested
+    /// in it refer to, in the order of their slots in the environment
+    std::vector<std::string> &captured() { return captured_; }
+
+    /// free_names ::= names the function and the functions nested in it
+    /// refer to without declaring them
+    std::set<std::string> &free_names() { return free_; }
 private:
     std::unique_ptr<FunctionPrototype> proto_;
     std::unique_ptr<Expression> body_;
+    std::vector<std::string> captured_;
+    std::set<std::string> free_;
 };
 
 } // parser
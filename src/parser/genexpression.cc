@@ -60,12 +60,25 @@ void BooleanLiteral::emit(std::shared_ptr<InstructionBuilder> builder)
     builder->AddInstruction(std::move(instr));
 }
 
+/// Identifiers resolved to a slot of the frame are fetched using the slot,
+/// the captured ones from their environment and rest of them are looked
+/// up by their names
 void Identifier::emit(std::shared_ptr<InstructionBuilder> builder)
 {
+    size_t slot, hops;
     auto instr = InstructionBuilder::Create<Instructions::fetch>();
     instr->data_type_ = d_name;
     instr->str_ = name_;
 
+    if (builder->LookupLocal(name_, slot)) {
+        instr->kind_ = Instructions::fetchl;
+        instr->number_ = static_cast<double>(slot);
+    } else if (builder->LookupCaptured(name_, hops, slot)) {
+        instr->kind_ = Instructions::fetche;
+        instr->number_ = static_cast<double>(slot);
+        instr->reg_[0] = static_cast<int32_t>(hops);
+    }
+
     builder->AddInstruction(std::move(instr));
     
     instr = InstructionBuilder::Create<Instructions::pushim>();
@@ -73,69 +86,151 @@ void Identifier::emit(std::shared_ptr<InstructionBuilder> builder)
     builder->AddInstruction(std::move(instr));
 }
 
-void EmitBinaryOperator(BinaryExpression::Operator op,
-        std::shared_ptr<InstructionBuilder> builder)
+/// BinaryOperatorKind ::= kind of the stack instruction for the operator
+static Instructions BinaryOperatorKind(BinaryExpression::Operator op)
 {
-    auto instr = InstructionBuilder::Create<Instructions::noop>();
     switch (op) {
     default:
         throw TypeError("unknown operator");
     case PLUS:
-        instr->kind_ = Instructions::adds;
-        break;
+        return Instructions::adds;
     case MINUS:
-        instr->kind_ = Instructions::subs;
-        break;
+        return Instructions::subs;
     case MUL:
-        instr->kind_ = Instructions::muls;
-        break;
+        return Instructions::muls;
     case DIV:
-        instr->kind_ = Instructions::divs;
-        break;
+        return Instructions::divs;
     case SHR:
-        instr->kind_ = Instructions::shrs;
-        break;
+        return Instructions::shrs;
     case SHL:
-        instr->kind_ = Instructions::shls;
-        break;
+        return Instructions::shls;
     case MOD:
-        instr->kind_ = Instructions::rems;
-        break;
+        return Instructions::rems;
     case LT:
-        instr->kind_ = Instructions::lts;
-        break;
+        return Instructions::lts;
     case GT:
-        instr->kind_ = Instructions::gts;
-        break;
+        return Instructions::gts;
     case LTE:
-        instr->kind_ = Instructions::ltes;
-        break;
+        return Instructions::ltes;
     case GTE:
-        instr->kind_ = Instructions::gtes;
-        break;
+        return Instructions::gtes;
     case EQUAL:
-        instr->kind_ = Instructions::eqs;
-        break;
+        return Instructions::eqs;
     case NOTEQ:
-        instr->kind_ = Instructions::neqs;
-        break;
+        return Instructions::neqs;
     case BAND:
-        instr->kind_ = Instructions::bands;
-        break;
+        return Instructions::bands;
     case BOR:
-        instr->kind_ = Instructions::bors;
-        break;
+        return Instructions::bors;
     case OR:
-        instr->kind_ = Instructions::ors;
-        break;
+        return Instructions::ors;
     case AND:
-        instr->kind_ = Instructions::ands;
-        break;
+        return Instructions::ands;
     case XOR:
-        instr->kind_ = Instructions::xors;
-        break;
+        return Instructions::xors;
+    }
+}
+
+void EmitBinaryOperator(BinaryExpression::Operator op,
+        std::shared_ptr<InstructionBuilder> builder)
+{
+    auto instr = InstructionBuilder::Create<Instructions::noop>();
+    instr->kind_ = BinaryOperatorKind(op);
+    instr->data_type_ = d_null;
+    builder->AddInstruction(std::move(instr));
+}
+
+/// RegisterOperand ::= an operand of a register instruction is either a
+/// local whose slot is never empty or a number, reg is -1 for the number
+static bool RegisterOperand(Expression *expr,
+    std::shared_ptr<InstructionBuilder> builder, int32_t &reg, double &number)
+{
+    size_t slot;
+    if (auto literal = dynamic_cast<IntegralLiteral*>(expr)) {
+        reg = -1;
+        number = literal->value();
+        return true;
     }
+
+    auto id = dynamic_cast<Identifier*>(expr);
+    if (!id || !builder->LookupRegister(id->GetName(), slot)
+            || slot > INT16_MAX)
+        return false;
+    reg = static_cast<int32_t>(slot);
+    return true;
+}
+
+/// EmitRegisterOperator ::= emits `binr` for the binary expression if
+/// both operands can be registers (but not both numbers), the result is
+/// stored in the slot dst or pushed when dst is -1
+static bool EmitRegisterOperator(BinaryExpression *expr, int32_t dst,
+    std::shared_ptr<InstructionBuilder> builder)
+{
+    int32_t lhs, rhs;
+    double number = 0.0;
+
+    if (!RegisterOperand(expr->lhs().get(), builder, lhs, number)
+            || !RegisterOperand(expr->rhs().get(), builder, rhs, number)
+            || (lhs < 0 && rhs < 0))
+        return false;
+
+    auto instr = InstructionBuilder::Create<Instructions::binr>();
+    instr->data_type_ = d_num;
+    instr->number_ = number;
+    instr->op_ = BinaryOperatorKind(expr->op());
+    instr->reg_[0] = dst;
+    instr->reg_[1] = lhs;
+    instr->reg_[2] = rhs;
+    builder->AddInstruction(std::move(instr));
+    return true;
+}
+
+/// IndexTarget ::= the last member of `a[i]` or `a.b[i]`, nullptr when
+/// the expression doesn't end with an index
+static IndexMemberExpression *IndexTarget(Expression *expr)
+{
+    auto member = dynamic_cast<MemberExpression*>(expr);
+    if (!member || member->members().size() < 2)
+        return nullptr;
+    return dynamic_cast<IndexMemberExpression*>(
+        member->members().back().get());
+}
+
+/// EmitIndexOperands ::= emits the object and the index of `a[i]` without
+/// indexing, the keyed instruction which follows does that
+static void EmitIndexOperands(Expression *expr,
+    std::shared_ptr<InstructionBuilder> builder)
+{
+    auto &members = static_cast<MemberExpression*>(expr)->members();
+    for (size_t i = 0; i + 1 < members.size(); i++)
+        members[i]->emit(builder);
+    static_cast<IndexMemberExpression*>(members.back().get())
+        ->expr()->emit(builder);
+}
+
+/// EmitIndexStore ::= emits `a[i] = v` as a single `stidx` after the
+/// object and the index, the value has already been emitted
+static void EmitIndexStore(Expression *expr,
+    std::shared_ptr<InstructionBuilder> builder)
+{
+    EmitIndexOperands(expr, builder);
+
+    auto instr = InstructionBuilder::Create<Instructions::stidx>();
+    instr->data_type_ = d_null;
+    builder->AddInstruction(std::move(instr));
+}
+
+/// EmitIndexUpdate ::= emits `++a[i]`, `a[i]--` etc. as a single `updidx`
+/// so that elements without a handle of their own can be updated too
+static void EmitIndexUpdate(Expression *expr, bool prefix, double step,
+    std::shared_ptr<InstructionBuilder> builder)
+{
+    EmitIndexOperands(expr, builder);
+
+    auto instr = InstructionBuilder::Create<Instructions::updidx>();
     instr->data_type_ = d_null;
+    instr->boolean_ = prefix;
+    instr->number_ = step;
     builder->AddInstruction(std::move(instr));
 }
 
@@ -145,6 +240,10 @@ void PrefixExpression::emit(std::shared_ptr<InstructionBuilder> builder)
         throw ReferenceError("can't apply prefix operator on "
             "r-value");
 
+    if (IndexTarget(expr_.get()) && (tok_ == INC || tok_ == DEC)) {
+        EmitIndexUpdate(expr_.get(), true, tok_ == INC ? 1 : -1, builder);
+        return;
+    }
     expr_->emit(builder);
     if (tok_ == INC) {
         auto instr = InstructionBuilder::Create<Instructions::inc>();
@@ -167,6 +266,10 @@ void PostfixExpression::emit(std::shared_ptr<InstructionBuilder> builder)
         throw ReferenceError("can't apply postfix operator on "
             "r-value");
 
+    if (IndexTarget(expr_.get()) && (tok_ == INC || tok_ == DEC)) {
+        EmitIndexUpdate(expr_.get(), false, tok_ == INC ? 1 : -1, builder);
+        return;
+    }
     expr_->emit(builder);
     if (tok_ == INC) {
         auto instr = InstructionBuilder::Create<Instructions::pinc>();
@@ -179,6 +282,9 @@ void PostfixExpression::emit(std::shared_ptr<InstructionBuilder> builder)
 
 void BinaryExpression::emit(std::shared_ptr<InstructionBuilder> builder)
 {
+    if (EmitRegisterOperator(this, -1, builder))
+        return;
+
     lhs_->emit(builder);
     rhs_->emit(builder);
 
@@ -187,21 +293,41 @@ void BinaryExpression::emit(std::shared_ptr<InstructionBuilder> builder)
 
 void AssignExpression::emit(std::shared_ptr<InstructionBuilder> builder)
 {
+    // first we check whether the lhs_ is an Identifier
+    auto maybe = dynamic_cast<Identifier*>(lhs_.get());
+
+    // `a = b + c` on registers is done by one instruction, the local
+    // already exists so there is nothing to declare
+    size_t slot;
+    auto binary = dynamic_cast<BinaryExpression*>(rhs_.get());
+    if (maybe && binary && builder->LookupRegister(maybe->GetName(), slot)
+            && slot <= INT16_MAX
+            && EmitRegisterOperator(binary, static_cast<int32_t>(slot),
+                builder))
+        return;
+
     // generate code for rhs
     rhs_->emit(builder);
 
     if (lhs_->ProduceRValue())
         throw ReferenceError("can't assign to an rvalue");
 
-    // first we check whether the lhs_ is an Identifier
-    auto maybe = dynamic_cast<Identifier*>(lhs_.get());
-
     if (maybe) {
+        size_t hops, index;
         auto ns = InstructionBuilder::Create<Instructions::news>();
         ns->data_type_ = d_name;
         ns->str_ = maybe->GetName();
+        if (!builder->LookupLocal(ns->str_, slot)
+                && builder->LookupCaptured(ns->str_, hops, index)) {
+            ns->kind_ = Instructions::newse;
+            ns->number_ = static_cast<double>(index);
+            ns->reg_[0] = static_cast<int32_t>(hops);
+        }
         builder->AddInstruction(std::move(ns));
         lhs_->emit(builder);
+    } else if (IndexTarget(lhs_.get())) {
+        EmitIndexStore(lhs_.get(), builder);
+        return;
     } else {
         lhs_->emit(builder);
     }
@@ -227,6 +353,7 @@ void TernaryExpression::emit(std::shared_ptr<InstructionBuilder> builder)
 
     // now create a block that will handle the instructions for second_
     builder->CreateBlock();
+    builder->BeginConditional();
     second_->emit(builder);
 
     // add jmp instruction at the end of current block
@@ -239,6 +366,7 @@ void TernaryExpression::emit(std::shared_ptr<InstructionBuilder> builder)
     // create another block for third_
     builder->CreateBlock();
     third_->emit(builder);
+    builder->EndConditional();
     builder->EndBlockForJump();
 
     // end the block
@@ -267,7 +395,9 @@ void IfStatement::emit(std::shared_ptr<InstructionBuilder> builder)
 
     // create a block that will hold if body
     builder->CreateBlock();
+    builder->BeginConditional();
     body_->emit(builder);
+    builder->EndConditional();
     builder->EndBlockForJump();
 }
 
@@ -289,6 +419,7 @@ void IfElseStatement::emit(std::shared_ptr<InstructionBuilder> builder)
 
     // now create a block that will hold instruction for `if` body
     builder->CreateBlock();
+    builder->BeginConditional();
     body_->emit(builder);
 
     // add jmp instruction at the end of current block used for skipping `else`
@@ -301,6 +432,7 @@ void IfElseStatement::emit(std::shared_ptr<InstructionBuilder> builder)
     // create another block for `else` body
     builder->CreateBlock();
     else_->emit(builder);
+    builder->EndConditional();
     builder->EndBlockForJump();
 
     // end the block
@@ -312,6 +444,10 @@ void ForStatement::emit(std::shared_ptr<InstructionBuilder> builder)
     // init code for `for`
     init_->emit(builder);
 
+    // values left by the iterations are dropped down to here
+    auto enter = InstructionBuilder::Create<Instructions::enterl>();
+    builder->AddInstruction(std::move(enter));
+
     // start of the condition_ instructions
     auto cmp_blk_start = builder->CurrentLength();
     condition_->emit(builder);
@@ -330,11 +466,13 @@ void ForStatement::emit(std::shared_ptr<InstructionBuilder> builder)
     // end of the condition instructions
     auto cmp_blk_end = builder->CurrentLength();
 
+    builder->BeginConditional();
     body_->emit(builder);
     update_->emit(builder);
+    builder->EndConditional();
 
-    popinstr = InstructionBuilder::Create<Instructions::pop>();
-    builder->AddInstruction(std::move(popinstr));
+    auto next = InstructionBuilder::Create<Instructions::nextl>();
+    builder->AddInstruction(std::move(next));
     
     // insert a jmp back instruction
     instr = InstructionBuilder::Create<Instructions::jmp>();
@@ -345,6 +483,8 @@ void ForStatement::emit(std::shared_ptr<InstructionBuilder> builder)
 
     // mark the end of the for loop
     auto for_loop_end = builder->CurrentLength();
+    auto exit = InstructionBuilder::Create<Instructions::exitl>();
+    builder->AddInstruction(std::move(exit));
 
     // update the jump instructions
     instr_ptr->jmp_addr_ = for_loop_end - cmp_blk_end;
@@ -353,6 +493,9 @@ void ForStatement::emit(std::shared_ptr<InstructionBuilder> builder)
 
 void WhileStatement::emit(std::shared_ptr<InstructionBuilder> builder)
 {
+    auto enter = InstructionBuilder::Create<Instructions::enterl>();
+    builder->AddInstruction(std::move(enter));
+
     // start of the condition_ instructions
     auto cmp_blk_start = builder->CurrentLength();
     condition_->emit(builder);
@@ -372,10 +515,12 @@ void WhileStatement::emit(std::shared_ptr<InstructionBuilder> builder)
     auto cmp_blk_end = builder->CurrentLength();
 
     // generate code for while's body
+    builder->BeginConditional();
     body_->emit(builder);
+    builder->EndConditional();
 
-    popinstr = InstructionBuilder::Create<Instructions::pop>();
-    builder->AddInstruction(std::move(popinstr));
+    auto next = InstructionBuilder::Create<Instructions::nextl>();
+    builder->AddInstruction(std::move(next));
 
     // insert a jmp back instruction
     instr = InstructionBuilder::Create<Instructions::jmp>();
@@ -386,6 +531,8 @@ void WhileStatement::emit(std::shared_ptr<InstructionBuilder> builder)
 
     // mark the end of the while loop
     auto loop_end = builder->CurrentLength();
+    auto exit = InstructionBuilder::Create<Instructions::exitl>();
+    builder->AddInstruction(std::move(exit));
 
     // update the jump instructions
     instr_ptr->jmp_addr_ = loop_end - cmp_blk_end;
@@ -394,16 +541,19 @@ void WhileStatement::emit(std::shared_ptr<InstructionBuilder> builder)
 
 void DoWhileStatement::emit(std::shared_ptr<InstructionBuilder> builder)
 {
+    auto enter = InstructionBuilder::Create<Instructions::enterl>();
+    builder->AddInstruction(std::move(enter));
+
     auto cmp_blk_start = builder->CurrentLength();
 
     // generate code for body
     body_->emit(builder);
 
-    auto popinstr = InstructionBuilder::Create<Instructions::pop>();
-    builder->AddInstruction(std::move(popinstr));
+    auto next = InstructionBuilder::Create<Instructions::nextl>();
+    builder->AddInstruction(std::move(next));
 
     condition_->emit(builder);
-    popinstr = InstructionBuilder::Create<Instructions::pop>();
+    auto popinstr = InstructionBuilder::Create<Instructions::pop>();
     builder->AddInstruction(std::move(popinstr));
 
     // insert a jmp back instruction
@@ -417,6 +567,9 @@ void DoWhileStatement::emit(std::shared_ptr<InstructionBuilder> builder)
     auto loop_end = builder->CurrentLength();
 
     jmp_back_ptr->jmp_addr_ = -(loop_end - cmp_blk_start);
+
+    auto exit = InstructionBuilder::Create<Instructions::exitl>();
+    builder->AddInstruction(std::move(exit));
 }
 
 void BlockStatement::emit(std::shared_ptr<InstructionBuilder> builder)
@@ -511,6 +664,8 @@ void MemberExpression::emit(std::shared_ptr<InstructionBuilder> builder)
     }
 }
 
+/// A call whose result is returned is a tail call. The `ret` after it is
+/// still emitted, it returns when the call can't take over the frame
 void ReturnStatement::emit(std::shared_ptr<InstructionBuilder> builder)
 {
     if (builder->InsideFunction())
@@ -518,6 +673,10 @@ void ReturnStatement::emit(std::shared_ptr<InstructionBuilder> builder)
     else 
         throw TypeError("return statement was not inside function");
 
+    auto last = builder->LastInstruction();
+    if (last && last->kind_ == Instructions::call)
+        last->kind_ = Instructions::tcall;
+
     auto ret = InstructionBuilder::Create<Instructions::ret>();
     builder->AddInstruction(std::move(ret));
 }
@@ -537,15 +696,46 @@ void Declaration::emit(std::shared_ptr<InstructionBuilder> builder)
     if (init_) {
         init_->emit(builder);
     }
-    auto ns = InstructionBuilder::Create<Instructions::news>();
+
+    // a captured variable lives in the environment of the call, where the
+    // closures find it after the call has returned
+    size_t index;
+    if (builder->LookupOwnCaptured(name_, index)) {
+        auto ns = InstructionBuilder::Create<Instructions::newse>();
+        ns->data_type_ = d_name;
+        ns->str_ = name_;
+        ns->number_ = static_cast<double>(index);
+        ns->reg_[0] = 0;
+        builder->AddInstruction(ns);
+
+        auto instr = std::make_shared<Instruction>(*ns);
+        instr->kind_ = Instructions::fetche;
+        builder->AddInstruction(std::move(instr));
+
+        instr = InstructionBuilder::Create<Instructions::pushim>();
+        instr->data_type_ = d_null;
+        builder->AddInstruction(std::move(instr));
+
+        instr = InstructionBuilder::Create<Instructions::store>();
+        instr->data_type_ = d_null;
+        builder->AddInstruction(std::move(instr));
+        return;
+    }
+
+    // the variable gets its slot only after the initializer, which may
+    // refer to a variable of the same name from some other scope
+    auto slot = static_cast<double>(builder->DeclareLocal(name_));
+    auto ns = InstructionBuilder::Create<Instructions::newsl>();
     ns->data_type_ = d_name;
     ns->str_ = name_;
-    ns->number_ = 1;
+    ns->number_ = slot;
     builder->AddInstruction(std::move(ns));
+    builder->MarkAssigned(static_cast<size_t>(slot));
 
-    auto instr = InstructionBuilder::Create<Instructions::fetch>();
+    auto instr = InstructionBuilder::Create<Instructions::fetchl>();
     instr->data_type_ = d_name;
     instr->str_ = name_;
+    instr->number_ = slot;
 
     builder->AddInstruction(std::move(instr));
 
@@ -2,6 +2,7 @@
 #include "parser/functionstatement.h"
 #include "vm/instruction-builder.h"
 #include "vm/instruction.h"
+#include "vm/var-store.h"
 
 namespace grok {
 namespace parser {
@@ -12,25 +13,55 @@ using namespace grok::obj;
 /// emits code for function definition
 /// We don't generate the code for the body now but defer it until
 /// it is required i.e. when a call is placed to this function during
-/// execution
+/// execution. A function referring to a variable captured by one of the
+/// functions it is nested in is created as a closure by `clos`
 void FunctionStatement::emit(std::shared_ptr<InstructionBuilder> builder)
 {
     std::string Name = proto_->GetName();
+    size_t hops, index;
+    bool closure = false;
+    for (const auto &name : free_) {
+        if (builder->LookupCaptured(name, hops, index)) {
+            closure = true;
+            break;
+        }
+    }
+
     auto F = CreateFunction(std::move(body_), std::move(proto_));
+    F->as<Function>()->SetScope(captured_, free_, builder->Scope());
+
+    // scopes are dynamic, the name may refer to a variable of a caller
+    for (const auto &name : free_)
+        VStore::MarkFreeName(AtomTable::Intern(name));
 
     auto instr = InstructionBuilder::Create<Instructions::push>();
+    instr->kind_ = closure ? Instructions::clos : Instructions::push;
     instr->data_type_ = d_obj;
     instr->data_ = (F);
 
     builder->AddInstruction(std::move(instr));
-    instr = InstructionBuilder::Create<Instructions::news>();
-    instr->data_type_ = d_name;
-    instr->str_ = Name;
-    builder->AddInstruction(std::move(instr));
-    
-    instr = InstructionBuilder::Create<Instructions::fetch>();
+
+    // the declaration is bound in the call which runs it, like a `var`,
+    // a recursive call must not overwrite the binding of its caller
+    size_t slot = 0;
+    instr = InstructionBuilder::Create<Instructions::newsl>();
     instr->data_type_ = d_name;
     instr->str_ = Name;
+    if (builder->LookupOwnCaptured(Name, index)) {
+        instr->kind_ = Instructions::newse;
+        instr->number_ = static_cast<double>(index);
+        instr->reg_[0] = 0;
+    } else {
+        slot = builder->DeclareLocal(Name);
+        instr->number_ = static_cast<double>(slot);
+    }
+    builder->AddInstruction(instr);
+    if (instr->kind_ == Instructions::newsl)
+        builder->MarkAssigned(slot);
+
+    instr = std::make_shared<Instruction>(*instr);
+    instr->kind_ = instr->kind_ == Instructions::newse
+        ? Instructions::fetche : Instructions::fetchl;
     builder->AddInstruction(std::move(instr));
 
     instr = InstructionBuilder::Create<Instructions::pushim>();
@@ -4,6 +4,8 @@
 #include "parser/blockstatement.h"
 #include "parser/functionstatement.h"
 #include "parser/returnstatement.h"
+#include "parser/constant-folding.h"
+#include "parser/scope-analysis.h"
 #include "lexer/token.h"
 
 #include "common/exceptions.h"
@@ -664,8 +666,11 @@ std::unique_ptr<Expression> GrokParser::ParseFunction()
     auto proto = ParsePrototype();
     auto body = ParseStatement();
 
-    return std::make_unique<FunctionStatement>(std::move(proto),
+    auto function = std::make_unique<FunctionStatement>(std::move(proto),
         std::move(body));
+    ConstantFolding::Fold(function->body());
+    ScopeAnalysis::Analyse(function.get());
+    return std::move(function);
 }
 
 std::unique_ptr<Expression> GrokParser::ParseBlockStatement()
@@ -816,7 +821,9 @@ bool GrokParser::ParseExpression()
     expr_ast_ = std::make_shared<BlockStatement>(std::move(exprs));
     try {
         while (!(lex_->peek() == EOS)) {
-            expr_ast_->PushExpression(ParseStatement());
+            auto stmt = ParseStatement();
+            ConstantFolding::Fold(stmt);
+            expr_ast_->PushExpression(std::move(stmt));
         }
     } catch (std::exception &e) {
         std::cerr << e.what() << ", got '"
@@ -21,6 +21,8 @@ public:
     void emit(std::shared_ptr<grok::vm::InstructionBuilder>) override;
 #endif
     void Accept(ASTVisitor *visitor) override;
+
+    std::unique_ptr<Expression> &expr() { return expr_; }
 private:
     std::unique_ptr<Expression> expr_;
 };
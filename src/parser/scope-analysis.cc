@@ -0,0 +1,200 @@
+#include "parser/scope-analysis.h"
+
+namespace grok {
+namespace parser {
+
+void ScopeAnalysis::Analyse(FunctionStatement *function)
+{
+    ScopeAnalysis analysis;
+    for (const auto &param : function->proto()->GetArgs())
+        analysis.declared_.insert(param);
+    analysis.Visit(function->body());
+
+    // a variable is captured by the innermost function declaring it, so
+    // a nested function never sees the one of an outer function of the
+    // same name
+    auto &captured = function->captured();
+    auto &free = function->free_names();
+    for (const auto &name : analysis.inner_) {
+        if (analysis.declared_.count(name))
+            captured.push_back(name);
+        else
+            free.insert(name);
+    }
+    for (const auto &name : analysis.referred_) {
+        if (!analysis.declared_.count(name))
+            free.insert(name);
+    }
+}
+
+void ScopeAnalysis::Visit(NullLiteral *) { }
+
+void ScopeAnalysis::Visit(ThisHolder *) { }
+
+void ScopeAnalysis::Visit(IntegralLiteral *) { }
+
+void ScopeAnalysis::Visit(StringLiteral *) { }
+
+void ScopeAnalysis::Visit(ArrayLiteral *a)
+{
+    for (auto &expr : a->exprs())
+        Visit(expr);
+}
+
+void ScopeAnalysis::Visit(ObjectLiteral *o)
+{
+    for (auto &prop : o->proxy())
+        Visit(prop.second);
+}
+
+void ScopeAnalysis::Visit(Identifier *id)
+{
+    referred_.insert(id->GetName());
+}
+
+void ScopeAnalysis::Visit(BooleanLiteral *) { }
+
+void ScopeAnalysis::Visit(ArgumentList *a)
+{
+    for (auto &expr : a->args())
+        Visit(expr);
+}
+
+void ScopeAnalysis::Visit(FunctionCallExpression *f)
+{
+    for (auto &expr : f->args())
+        Visit(expr);
+    Visit(f->func());
+}
+
+void ScopeAnalysis::Visit(CallExpression *c)
+{
+    for (auto &expr : c->members())
+        Visit(expr);
+    Visit(c->func());
+}
+
+// the identifier after a dot is the name of a property
+void ScopeAnalysis::Visit(DotMemberExpression *) { }
+
+void ScopeAnalysis::Visit(IndexMemberExpression *i)
+{
+    Visit(i->expr());
+}
+
+void ScopeAnalysis::Visit(MemberExpression *m)
+{
+    for (auto &expr : m->members())
+        Visit(expr);
+}
+
+void ScopeAnalysis::Visit(NewExpression *n)
+{
+    Visit(n->member());
+}
+
+void ScopeAnalysis::Visit(PrefixExpression *p)
+{
+    Visit(p->expr());
+}
+
+void ScopeAnalysis::Visit(PostfixExpression *p)
+{
+    Visit(p->expr());
+}
+
+void ScopeAnalysis::Visit(BinaryExpression *b)
+{
+    Visit(b->lhs());
+    Visit(b->rhs());
+}
+
+void ScopeAnalysis::Visit(AssignExpression *a)
+{
+    Visit(a->lhs());
+    Visit(a->rhs());
+}
+
+void ScopeAnalysis::Visit(TernaryExpression *t)
+{
+    Visit(t->first());
+    Visit(t->second());
+    Visit(t->third());
+}
+
+void ScopeAnalysis::Visit(CommaExpression *c)
+{
+    for (auto &expr : c->exprs())
+        Visit(expr);
+}
+
+void ScopeAnalysis::Visit(Declaration *d)
+{
+    declared_.insert(d->name());
+    Visit(d->expr());
+}
+
+void ScopeAnalysis::Visit(DeclarationList *d)
+{
+    for (auto &decl : d->exprs())
+        Visit(decl.get());
+}
+
+void ScopeAnalysis::Visit(IfStatement *i)
+{
+    Visit(i->condition());
+    Visit(i->body());
+}
+
+void ScopeAnalysis::Visit(IfElseStatement *i)
+{
+    Visit(i->condition());
+    Visit(i->body());
+    Visit(i->els());
+}
+
+void ScopeAnalysis::Visit(ForStatement *f)
+{
+    Visit(f->init());
+    Visit(f->condition());
+    Visit(f->update());
+    Visit(f->body());
+}
+
+void ScopeAnalysis::Visit(WhileStatement *w)
+{
+    Visit(w->condition());
+    Visit(w->body());
+}
+
+void ScopeAnalysis::Visit(DoWhileStatement *d)
+{
+    Visit(d->condition());
+    Visit(d->body());
+}
+
+void ScopeAnalysis::Visit(BlockStatement *b)
+{
+    for (auto &stmt : b->statements())
+        Visit(stmt);
+}
+
+void ScopeAnalysis::Visit(FunctionPrototype *) { }
+
+/// a nested function has already been analysed, its name is declared in
+/// the function enclosing it
+void ScopeAnalysis::Visit(FunctionStatement *f)
+{
+    auto &name = f->proto()->GetName();
+    if (name.size())
+        declared_.insert(name);
+    inner_.insert(f->free_names().begin(), f->free_names().end());
+}
+
+void ScopeAnalysis::Visit(ReturnStatement *r)
+{
+    Visit(r->expr());
+}
+
+} // parser
+} // grok
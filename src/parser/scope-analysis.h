@@ -0,0 +1,40 @@
+#ifndef SCOPE_ANALYSIS_H_
+#define SCOPE_ANALYSIS_H_
+
+#include "parser/astvisitor.h"
+
+#include <set>
+#include <string>
+
+namespace grok {
+namespace parser {
+
+/// ScopeAnalysis ::= finds the names a function refers to and which of
+/// its own variables are captured by the functions nested in it. The
+/// nested functions are parsed first, so they have been analysed when
+/// the function enclosing them is
+class ScopeAnalysis : public ASTVisitor {
+public:
+    /// Analyse ::= sets captured() and free_names() of the function
+    static void Analyse(FunctionStatement *function);
+
+#define DECLARE_VISIT(type) void Visit(type *) override;
+AST_NODE_LIST(DECLARE_VISIT)
+#undef DECLARE_VISIT
+
+private:
+    void Visit(std::unique_ptr<Expression> &expr)
+    {
+        if (expr)
+            expr->Accept(this);
+    }
+
+    std::set<std::string> declared_;
+    std::set<std::string> referred_;    // by the function itself
+    std::set<std::string> inner_;       // by the nested functions
+};
+
+} // parser
+} // grok
+
+#endif // scope-analysis.h
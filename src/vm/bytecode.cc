@@ -0,0 +1,108 @@
+#include "vm/bytecode.h"
+
+#include <iomanip>
+#include <sstream>
+
+namespace grok {
+namespace vm {
+
+using grok::obj::AtomTable;
+using grok::obj::atom_empty;
+
+static bool NeedsOperand(const Instruction &instr)
+{
+    switch (instr.GetKind()) {
+    case replprop:
+    case index:
+    case stidx:
+    case updidx:
+    case getprop:
+    case getpropl:
+        return true;
+    default:
+        return instr.str_.length() || instr.data_;
+    }
+}
+
+Code::Code(const InstructionList &list)
+    : code_(list.size()), operands_{ }
+{
+    size_t count = 0;
+    for (const auto &instr : list) {
+        if (NeedsOperand(*instr))
+            count++;
+    }
+    // operands are referred by pointer, so they must never move
+    operands_.reserve(count);
+
+    auto code = code_.begin();
+    for (const auto &instr : list) {
+        code->kind_ = static_cast<uint8_t>(instr->kind_);
+        code->data_type_ = static_cast<uint8_t>(instr->data_type_);
+        code->boolean_ = instr->boolean_;
+        code->op_ = static_cast<uint8_t>(instr->op_);
+        for (int i = 0; i < 3; i++)
+            code->reg_[i] = static_cast<int16_t>(instr->reg_[i]);
+        code->feedback_ = fb_none;
+        code->jmp_addr_ = instr->jmp_addr_;
+        code->number_ = instr->number_;
+        code->operand_ = nullptr;
+
+        if (NeedsOperand(*instr)) {
+            auto atom = instr->data_type_ == d_name
+                ? AtomTable::Intern(instr->str_) : atom_empty;
+            auto prop_atom = instr->prop_.length()
+                ? AtomTable::Intern(instr->prop_) : atom_empty;
+            operands_.push_back(Operand{ instr->str_, instr->data_, nullptr,
+                instr->prop_, atom, prop_atom });
+            code->operand_ = &operands_.back();
+        }
+        ++code;
+    }
+}
+
+std::shared_ptr<Code> Assemble(const InstructionList &list)
+{
+    return std::make_shared<Code>(list);
+}
+
+std::string InstructionToString(const Bytecode &instr)
+{
+    std::ostringstream out;
+    out << std::left << std::setw(10) << instr_to_string[instr.GetKind()];
+    out << std::setw(5) << instr.GetJumpLength();
+
+    switch (instr.GetDataType()) {
+    default:
+        out << "Null";
+        break;
+    case Datatypes::d_num:
+        out << std::to_string(instr.GetNumber());
+        break;
+    case Datatypes::d_str:
+    case Datatypes::d_name:
+        out << instr.GetString();
+        break;
+    case Datatypes::d_bool:
+        out << (instr.GetBoolean() ? "true" : "false");
+        break;
+    case Datatypes::d_obj:
+        out << "[ object Object ]";
+        break;
+    }
+    if (instr.GetOperator() != noop)
+        out << " " << instr_to_string[instr.GetOperator()];
+    if (instr.GetKind() == binr || instr.GetKind() == binrjz) {
+        out << " @" << instr.GetRegister(0) << " @" << instr.GetRegister(1)
+            << " @" << instr.GetRegister(2);
+    }
+    if (instr.GetKind() == fetche || instr.GetKind() == newse) {
+        out << " ^" << instr.GetRegister(0) << " #" << instr.GetNumber();
+    }
+    if (instr.GetProperty().length())
+        out << " ." << instr.GetProperty();
+    return out.str();
+}
+
+} // vm
+} // grok
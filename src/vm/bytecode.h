@@ -0,0 +1,143 @@
+#ifndef BYTECODE_H_
+#define BYTECODE_H_
+
+#include "object/atom.h"
+#include "vm/inline-cache.h"
+#include "vm/instruction-list.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace grok {
+namespace vm {
+
+/// Operand ::= the parts of an instruction which are too large to be
+/// packed in it, only the instructions which need them have an operand
+struct Operand {
+    std::string str_;
+    std::shared_ptr<grok::obj::Object> data_;
+    std::shared_ptr<InlineCache> cache_; // for property access sites
+    std::string prop_; // property read by getprop and getpropl
+    grok::obj::Atom atom_; // str_ interned when it is a name
+    grok::obj::Atom prop_atom_; // prop_ interned
+};
+
+/// TypeFeedback ::= operand types seen by a binary operator, the bits
+/// of both operands of every execution are or'ed together
+enum TypeFeedback : uint8_t {
+    fb_none = 0,
+    fb_int = 1,
+    fb_double = 2,
+    fb_string = 4,
+    fb_other = 8
+};
+
+/// Bytecode ::= packed form of an Instruction which the VM executes.
+/// Opcode, data type and the jump are packed in the first 8 bytes,
+/// strings, objects and caches are kept in the operand pool of the Code
+class Bytecode {
+public:
+    auto GetKind() const { return kind_; }
+    auto GetDataType() const { return data_type_; }
+    auto GetNumber() const { return number_; }
+    bool GetBoolean() const { return boolean_; }
+    int32_t GetJumpLength() const { return jmp_addr_; }
+
+    /// GetOperator ::= kind of the operator of a register instruction
+    auto GetOperator() const { return op_; }
+
+    /// GetRegister ::= slot number of a register instruction operand,
+    /// 0 is the destination and 1, 2 are the sources
+    int32_t GetRegister(int i) const { return reg_[i]; }
+
+    const std::string &GetString() const
+    {
+        static const std::string empty;
+        return operand_ ? operand_->str_ : empty;
+    }
+
+    /// GetProperty ::= name of the property read by getprop and getpropl
+    const std::string &GetProperty() const
+    {
+        static const std::string empty;
+        return operand_ ? operand_->prop_ : empty;
+    }
+
+    /// GetAtom ::= atom of the name of a variable or a property
+    grok::obj::Atom GetAtom() const
+    {
+        return operand_ ? operand_->atom_ : grok::obj::atom_empty;
+    }
+
+    /// GetPropertyAtom ::= atom of the property read by getprop, getpropl
+    grok::obj::Atom GetPropertyAtom() const
+    {
+        return operand_ ? operand_->prop_atom_ : grok::obj::atom_empty;
+    }
+
+    std::shared_ptr<grok::obj::Object> GetData() const
+    {
+        return operand_ ? operand_->data_ : nullptr;
+    }
+
+    /// GetCache ::= returns the inline cache of a property access site
+    std::shared_ptr<InlineCache> &GetCache() { return operand_->cache_; }
+
+    /// GetFeedback ::= type feedback of the operator of the instruction
+    uint8_t GetFeedback() const { return feedback_; }
+    void AddFeedback(uint8_t types) { feedback_ |= types; }
+
+    /// RewriteOperator ::= replaces the operator `from` by `to`, it is
+    /// either the instruction itself or the operator of a fused one
+    void RewriteOperator(int32_t from, int32_t to)
+    {
+        if (kind_ == from)
+            kind_ = static_cast<uint8_t>(to);
+        else if (op_ == from)
+            op_ = static_cast<uint8_t>(to);
+    }
+
+private:
+    friend class Code;
+
+    uint8_t kind_;
+    uint8_t data_type_;
+    bool boolean_;
+    uint8_t op_;
+    int32_t jmp_addr_;
+    int16_t reg_[3];
+    uint8_t feedback_;
+    double number_;
+    Operand *operand_;
+};
+
+/// Code ::= bytecode of a script or a function stored contiguously
+/// along with the pool of operands, instructions are executed by pointer
+class Code {
+public:
+    explicit Code(const InstructionList &list);
+
+    Code(const Code &) = delete;
+    Code &operator=(const Code &) = delete;
+
+    Bytecode *begin() { return code_.data(); }
+    Bytecode *end() { return code_.data() + code_.size(); }
+
+    size_t size() const { return code_.size(); }
+
+private:
+    std::vector<Bytecode> code_;
+    std::vector<Operand> operands_;
+};
+
+/// Assemble ::= packs the instructions into bytecode
+extern std::shared_ptr<Code> Assemble(const InstructionList &list);
+
+extern std::string InstructionToString(const Bytecode &instr);
+
+} // vm
+} // grok
+
+#endif // bytecode.h
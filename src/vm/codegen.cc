@@ -31,5 +31,12 @@ std::shared_ptr<InstructionList> CodeGenerator::GetIR()
     return IR;
 }
 
+std::shared_ptr<Code> CodeGenerator::GetCode()
+{
+    if (!IR)
+        return nullptr;
+    return Assemble(*IR);
+}
+
 }
 }
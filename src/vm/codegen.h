@@ -3,6 +3,7 @@
 
 #include "parser/expression.h"
 #include "vm/instruction.h"
+#include "vm/bytecode.h"
 #include "vm/instruction-list.h"
 #include "vm/instruction-builder.h"
 
@@ -22,7 +23,32 @@ public:
     /// GetIR ::= returns IR
     std::shared_ptr<InstructionList> GetIR();
 
+    /// GetCode ::= returns the IR packed into bytecode
+    std::shared_ptr<Code> GetCode();
+
     void SetInsideFunction() { Builder->SetInsideFunction(); }
+
+    /// SetScope ::= lexical scope of the function being generated
+    void SetScope(std::shared_ptr<LexicalScope> scope)
+    {
+        Builder->SetScope(scope);
+    }
+
+    /// SetParams ::= params of the function being generated, they live
+    /// in the first slots of the frame
+    void SetParams(const std::vector<std::string> &params)
+    {
+        Builder->DeclareParams(params);
+    }
+
+    /// GetFrameSize ::= number of local slots used by the generated code
+    size_t GetFrameSize() const { return Builder->FrameSize(); }
+
+    /// GetLocals ::= names of the variables resolved to slots
+    const std::map<std::string, size_t> &GetLocals() const
+    {
+        return Builder->Locals();
+    }
 private:
     std::shared_ptr<InstructionList> IR;
     std::shared_ptr<InstructionBuilder> Builder;
@@ -1,13 +1,13 @@
 #ifndef COUNTER_H_
 #define COUNTER_H_
 
-#include "vm/instruction-list.h"
+#include "vm/bytecode.h"
 
 namespace grok {
 namespace vm {
 
 /// Counter ::= similar to program counter in processor
-using Counter = InstructionList::iterator;
+using Counter = Bytecode*;
 
 }
 }
@@ -0,0 +1,92 @@
+#include "vm/inline-cache.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace grok {
+namespace vm {
+
+static const char *state_to_string[] = {
+    "uninitialized",
+    "monomorphic",
+    "polymorphic",
+    "megamorphic"
+};
+
+void InlineCache::Update(const grok::obj::Shape *shape,
+    grok::obj::Atom name, size_t slot)
+{
+    if (state_ == State::megamorphic)
+        return;
+
+    if (size_ == MaxEntries) {
+        state_ = State::megamorphic;
+        size_ = 0;
+        return;
+    }
+
+    entries_[size_].shape = shape;
+    entries_[size_].name = name;
+    entries_[size_].slot = slot;
+    size_++;
+    state_ = size_ == 1 ? State::monomorphic : State::polymorphic;
+}
+
+void InlineCache::Print(std::ostream &os) const
+{
+    auto total = hits_ + misses_;
+    os << site_ << ": " << state_to_string[static_cast<int>(state_)]
+        << ", " << hits_ << "/" << total << " hits";
+    if (total)
+        os << " (" << (100 * hits_) / total << "%)";
+    os << std::endl;
+}
+
+// the caches are owned by the instructions of their code, the registry
+// only refers to them so that they die with the code
+static std::vector<std::weak_ptr<InlineCache>> &Caches()
+{
+    static std::vector<std::weak_ptr<InlineCache>> caches;
+    return caches;
+}
+
+// drops the caches whose code is gone once the registry has doubled
+static void PruneCaches()
+{
+    static size_t limit = 1024;
+    auto &caches = Caches();
+    if (caches.size() < limit)
+        return;
+
+    caches.erase(std::remove_if(caches.begin(), caches.end(),
+        [](const std::weak_ptr<InlineCache> &cache) {
+            return cache.expired();
+        }), caches.end());
+    limit = std::max(limit, 2 * caches.size());
+}
+
+std::shared_ptr<InlineCache> CreateInlineCache(const std::string &site)
+{
+    auto cache = std::make_shared<InlineCache>(site);
+    PruneCaches();
+    Caches().push_back(cache);
+    return cache;
+}
+
+void PrintInlineCacheStats(std::ostream &os)
+{
+    bool header = false;
+    for (const auto &weak : Caches()) {
+        auto cache = weak.lock();
+        if (!cache)
+            continue;
+        if (!header) {
+            os << "[ Inline caches ]" << std::endl;
+            header = true;
+        }
+        cache->Print(os);
+    }
+}
+
+} // vm
+} // grok
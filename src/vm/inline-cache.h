@@ -0,0 +1,94 @@
+#ifndef INLINE_CACHE_H_
+#define INLINE_CACHE_H_
+
+#include "object/atom.h"
+
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <string>
+
+namespace grok {
+namespace obj {
+class Shape;
+}
+
+namespace vm {
+
+/// InlineCache ::= remembers the slots in which a property access site
+/// found own properties of objects, keyed by the shape of the object.
+/// A site starts uninitialized, becomes monomorphic after the first
+/// object it sees and polymorphic with upto MaxEntries shapes. Seeing
+/// more shapes than that makes it megamorphic, from then on the site
+/// never caches again and always takes the generic lookup.
+/// Only shapes from the transition tree are cached, they are never freed
+/// and never change so a hit can't return a stale slot.
+class InlineCache {
+public:
+    static constexpr size_t MaxEntries = 4;
+
+    enum class State {
+        uninitialized,
+        monomorphic,
+        polymorphic,
+        megamorphic
+    };
+
+    InlineCache(const std::string &site)
+        : site_{ site }, size_{ 0 }, state_{ State::uninitialized },
+          hits_{ 0 }, misses_{ 0 }
+    { }
+
+    /// Lookup ::= returns true and sets slot if shape and name are cached
+    bool Lookup(const grok::obj::Shape *shape, grok::obj::Atom name,
+        size_t &slot)
+    {
+        for (size_t i = 0; i < size_; i++) {
+            if (entries_[i].shape == shape && entries_[i].name == name) {
+                slot = entries_[i].slot;
+                hits_++;
+                return true;
+            }
+        }
+        misses_++;
+        return false;
+    }
+
+    /// Update ::= caches the slot of the property for the shape
+    void Update(const grok::obj::Shape *shape, grok::obj::Atom name,
+        size_t slot);
+
+    State GetState() const { return state_; }
+    bool IsMegamorphic() const { return state_ == State::megamorphic; }
+
+    /// Print ::= prints the hit rate of the site
+    void Print(std::ostream &os) const;
+
+private:
+    struct Entry {
+        const grok::obj::Shape *shape;
+        grok::obj::Atom name;
+        size_t slot;
+    };
+
+    std::string site_;
+    Entry entries_[MaxEntries];
+    size_t size_;
+    State state_;
+    size_t hits_;
+    size_t misses_;
+};
+
+/// CreateInlineCache ::= creates a cache for the site and registers it
+/// so that its counters can be printed later, the caller owns the cache
+/// and the registry forgets it once it is destroyed
+extern std::shared_ptr<InlineCache> CreateInlineCache(const std::string &site);
+
+/// PrintInlineCacheStats ::= prints the counters of every site executed
+/// whose code is still alive
+extern void PrintInlineCacheStats(std::ostream &os);
+
+} // vm
+} // grok
+
+#endif // inline-cache.h
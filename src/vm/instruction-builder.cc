@@ -91,6 +91,7 @@ std::unique_ptr<InstructionList> InstructionBuilder::ReleaseInstructionList()
     if (!good_state_)
         throw std::runtime_error("forgot to call Finalize()?");
     auto ret = working_block_->ReleaseBlock();
+    FuseInstructions(*ret);
     return ret;
 }
 
@@ -102,6 +103,242 @@ void InstructionBuilder::UpdateStackedJump()
     last_block->UpdateStackedJump(size);
 }
 
+// number of fused instructions created of each kind
+static std::map<int32_t, size_t> fusion_counts;
+
+static bool HasJumpLength(int32_t kind)
+{
+    switch (kind) {
+    default:
+        return false;
+    case jmp:
+    case jmpz:
+    case jmpnz:
+    case loopz:
+    case cmpjz:
+    case binijz:
+    case binrjz:
+        return true;
+    }
+}
+
+static bool IsBinaryOperator(int32_t kind)
+{
+    switch (kind) {
+    default:
+        return false;
+    case lts: case ltes: case gts: case gtes: case eqs: case neqs:
+    case adds: case subs: case muls: case divs: case shls: case shrs:
+    case rems: case bors: case bands: case ors: case ands: case xors:
+        return true;
+    }
+}
+
+/// Matches ::= checks whether the kinds of instructions starting at pos
+/// are same as kinds
+static bool Matches(const InstructionList &list, size_t pos,
+    std::initializer_list<int32_t> kinds)
+{
+    if (pos + kinds.size() > list.size())
+        return false;
+    for (auto kind : kinds) {
+        if (list[pos++]->kind_ != kind)
+            return false;
+    }
+    return true;
+}
+
+/// FuseAt ::= returns the fused instruction for the sequence starting at
+/// pos and the number of instructions it replaces, nullptr if nothing
+/// can be fused there. Longer sequences are tried first
+static std::shared_ptr<Instruction> FuseAt(const InstructionList &list,
+    size_t pos, size_t &length)
+{
+    auto first = list[pos];
+    auto fused = std::make_shared<Instruction>(*first);
+    auto is_fetch = first->kind_ == fetch || first->kind_ == fetchl;
+    auto is_immediate = first->kind_ == push && first->data_type_ == d_num
+        && pos + 1 < list.size() && IsBinaryOperator(list[pos + 1]->kind_);
+
+    if (is_fetch && Matches(list, pos + 1, { pushim, replprop })) {
+        fused->kind_ = first->kind_ == fetch ? getprop : getpropl;
+        fused->prop_ = list[pos + 2]->str_;
+        length = 3;
+    } else if (is_fetch && Matches(list, pos + 1, { pushim })) {
+        fused->kind_ = first->kind_ == fetch ? fetchp : fetchlp;
+        length = 2;
+    } else if (is_immediate && Matches(list, pos + 2, { pop, jmpz })) {
+        fused->kind_ = binijz;
+        fused->op_ = list[pos + 1]->kind_;
+        fused->jmp_addr_ = list[pos + 3]->jmp_addr_;
+        length = 4;
+    } else if (is_immediate) {
+        fused->kind_ = bini;
+        fused->op_ = list[pos + 1]->kind_;
+        length = 2;
+    } else if (IsBinaryOperator(first->kind_)
+            && Matches(list, pos + 1, { pop, jmpz })) {
+        fused->kind_ = cmpjz;
+        fused->op_ = first->kind_;
+        fused->jmp_addr_ = list[pos + 2]->jmp_addr_;
+        length = 3;
+    } else if (first->kind_ == binr && first->reg_[0] < 0
+            && Matches(list, pos + 1, { pop, jmpz })) {
+        fused->kind_ = binrjz;
+        fused->jmp_addr_ = list[pos + 2]->jmp_addr_;
+        length = 3;
+    } else {
+        return nullptr;
+    }
+    return fused;
+}
+
+void InstructionBuilder::FuseInstructions(InstructionList &list)
+{
+    auto size = list.size();
+
+    // jumps are relative, the instruction after the jump is at 0
+    std::vector<bool> is_target(size + 1, false);
+    for (size_t i = 0; i < size; i++) {
+        if (!HasJumpLength(list[i]->kind_))
+            continue;
+        auto target = static_cast<long>(i) + list[i]->jmp_addr_ + 1;
+        if (target >= 0 && target <= static_cast<long>(size))
+            is_target[target] = true;
+    }
+
+    InstructionList result;
+    std::vector<size_t> new_index(size + 1, 0);
+    std::vector<long> old_target; // old target of each jump in result
+
+    for (size_t i = 0; i < size; ) {
+        size_t length = 1;
+        auto fused = FuseAt(list, i, length);
+
+        for (size_t j = i + 1; fused && j < i + length; j++) {
+            if (is_target[j])
+                fused = nullptr;
+        }
+        if (!fused)
+            length = 1;
+
+        auto instr = fused ? fused : list[i];
+        auto last = i + length - 1;
+        new_index[i] = result.size();
+        old_target.push_back(HasJumpLength(instr->kind_)
+            ? static_cast<long>(last) + list[last]->jmp_addr_ + 1 : -1);
+        result.push_back(instr);
+        if (fused)
+            fusion_counts[fused->kind_]++;
+        i += length;
+    }
+    new_index[size] = result.size();
+
+    for (size_t i = 0; i < result.size(); i++) {
+        if (old_target[i] < 0 || old_target[i] > static_cast<long>(size))
+            continue;
+        result[i]->jmp_addr_ = static_cast<int>(new_index[old_target[i]])
+            - static_cast<int>(i) - 1;
+    }
+    list = std::move(result);
+}
+
+void PrintFusionStats(std::ostream &os)
+{
+    os << "[ Fused instructions ]" << std::endl;
+    for (const auto &count : fusion_counts)
+        os << instr_to_string[count.first] << ": " << count.second << std::endl;
+}
+
+void InstructionBuilder::DeclareParams(const std::vector<std::string> &params)
+{
+    // a repeated param name refers to the last one, same as it would
+    // in the scope where each of them is stored one after another
+    for (auto &param : params) {
+        if (scope_ && scope_->captured.count(param))
+            locals_.erase(param);
+        else
+            locals_[param] = frame_size_;
+        frame_size_++;
+    }
+    // arguments are stored in the slots before the function starts
+    assigned_.assign(frame_size_, true);
+}
+
+size_t InstructionBuilder::DeclareLocal(const std::string &name)
+{
+    auto local = locals_.find(name);
+    if (local != locals_.end())
+        return local->second;
+    return locals_[name] = frame_size_++;
+}
+
+void InstructionBuilder::MarkAssigned(size_t slot)
+{
+    if (conditional_)
+        return;
+    if (slot >= assigned_.size())
+        assigned_.resize(slot + 1, false);
+    assigned_[slot] = true;
+}
+
+bool InstructionBuilder::LookupRegister(const std::string &name,
+    size_t &slot) const
+{
+    if (!LookupLocal(name, slot))
+        return false;
+    return slot < assigned_.size() && assigned_[slot];
+}
+
+bool InstructionBuilder::LookupLocal(const std::string &name,
+    size_t &slot) const
+{
+    auto local = locals_.find(name);
+    if (local == locals_.end())
+        return false;
+    slot = local->second;
+    return true;
+}
+
+bool InstructionBuilder::LookupOwnCaptured(const std::string &name,
+    size_t &index) const
+{
+    if (!scope_)
+        return false;
+    auto captured = scope_->captured.find(name);
+    if (captured == scope_->captured.end())
+        return false;
+    index = captured->second;
+    return true;
+}
+
+bool InstructionBuilder::LookupCaptured(const std::string &name,
+    size_t &hops, size_t &index) const
+{
+    if (LookupOwnCaptured(name, index)) {
+        hops = 0;
+        return true;
+    }
+
+    // a variable the function declares itself is never captured by one
+    // of the functions it is nested in
+    if (!scope_ || !scope_->free.count(name))
+        return false;
+
+    hops = scope_->captured.empty() ? 0 : 1;
+    for (auto scope = scope_->outer.get(); scope; scope = scope->outer.get()) {
+        if (scope->captured.empty())
+            continue;
+
+        auto captured = scope->captured.find(name);
+        if (captured != scope->captured.end()) {
+            index = captured->second;
+            return true;
+        }
+        hops++;
+    }
+    return false;
+}
 
 } // vm
 } // grok
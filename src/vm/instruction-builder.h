@@ -6,10 +6,26 @@
 #include "common/util.h"
 
 #include <list> // needed for stack operations
+#include <map>
+#include <set>
 
 namespace grok {
 namespace vm {
 
+/// PrintFusionStats ::= prints how many fused instructions were created
+/// of each kind so far
+extern void PrintFusionStats(std::ostream &os);
+
+/// LexicalScope ::= variables of a function which are captured by the
+/// functions nested in it and their slots in its environment, free are
+/// the names it refers to without declaring them and outer is the scope
+/// of the function the function is nested in
+struct LexicalScope {
+    std::map<std::string, size_t> captured;
+    std::set<std::string> free;
+    std::shared_ptr<LexicalScope> outer;
+};
+
 /// BlockStack ::= class representing stacks for storing the blocks
 using BlockStack = std::list<std::shared_ptr<InstructionBlock>>;
 
@@ -51,12 +67,22 @@ public:
     /// Finalize ::= finalizes the InstructionList
     void Finalize();
 
-    /// ReleaseInstructionList ::= releases the finalized instruction list
+    /// ReleaseInstructionList ::= releases the finalized instruction list,
+    /// common sequences of instructions in it are fused into one
     std::unique_ptr<InstructionList> ReleaseInstructionList();
 
+    /// FuseInstructions ::= peephole pass replacing the sequences which
+    /// are generated all the time by a single fused instruction, jumps
+    /// are adjusted and sequences with a jump target inside are left alone
+    static void FuseInstructions(InstructionList &list);
+
     /// CurrentLength() ::= returns the length of the working block
     auto CurrentLength() const { return working_block_->Length(); }
 
+    /// LastInstruction ::= returns the instruction added last to the
+    /// working block, nullptr if it is empty
+    auto LastInstruction() const { return working_block_->Last(); }
+
     static std::unique_ptr<InstructionBuilder> CreateBuilder()
     {
         std::unique_ptr<InstructionBuilder> builder{ new InstructionBuilder() };
@@ -67,8 +93,62 @@ public:
 
     void SetInsideFunction() { function_ = true; }
     bool InsideFunction() { return function_; }
+
+    /// SetScope ::= scope of the function being built, must be set before
+    /// its params are declared
+    void SetScope(std::shared_ptr<LexicalScope> scope) { scope_ = scope; }
+    std::shared_ptr<LexicalScope> Scope() const { return scope_; }
+
+    /// LookupCaptured ::= returns true if the name was resolved to a slot
+    /// of an environment, hops is the number of environments to go out
+    /// from the one of the current call. Only the scopes which capture
+    /// something get an environment
+    bool LookupCaptured(const std::string &name, size_t &hops,
+        size_t &index) const;
+
+    /// LookupOwnCaptured ::= returns true if the name is a variable of the
+    /// function being built which is captured, index is its slot in the
+    /// environment of the call
+    bool LookupOwnCaptured(const std::string &name, size_t &index) const;
+
+    /// DeclareParams ::= reserves first slots of the frame for the params,
+    /// the i-th argument of a call is always stored in the i-th slot. The
+    /// captured params get their slot but are only found in the environment
+    void DeclareParams(const std::vector<std::string> &params);
+
+    /// DeclareLocal ::= reserves a frame slot for a variable declared
+    /// with `var` and returns it, redeclarations share the same slot
+    size_t DeclareLocal(const std::string &name);
+
+    /// LookupLocal ::= returns true if the name was resolved to a slot
+    bool LookupLocal(const std::string &name, size_t &slot) const;
+
+    /// FrameSize ::= number of slots needed by the code being built
+    size_t FrameSize() const { return frame_size_; }
+
+    /// Locals ::= names of the variables resolved to slots and their slots
+    const std::map<std::string, size_t> &Locals() const { return locals_; }
+
+    /// BeginConditional ::= code generated until EndConditional() may not
+    /// be executed i.e. bodies of loops and branches of conditionals
+    void BeginConditional() { conditional_++; }
+    void EndConditional() { conditional_--; }
+
+    /// MarkAssigned ::= the `var` statement of the slot has been generated,
+    /// if it always runs the slot holds a value in all the code after it
+    void MarkAssigned(size_t slot);
+
+    /// LookupRegister ::= returns true if the name was resolved to a slot
+    /// which is never empty at this point, such slots are used as
+    /// registers by the register instructions
+    bool LookupRegister(const std::string &name, size_t &slot) const;
 private:
     bool function_ = false;
+    size_t frame_size_ = 0;
+    size_t conditional_ = 0;
+    std::map<std::string, size_t> locals_;
+    std::shared_ptr<LexicalScope> scope_;
+    std::vector<bool> assigned_;
     bool good_state_; // 0 for not good, 1 for good
     BlockStack blockstack_;
     std::shared_ptr<InstructionBlock> working_block_;
@@ -1,5 +1,7 @@
 #include "vm/instruction-list.h"
 
+#include <stdexcept>
+
 namespace grok {
 namespace vm {
 
@@ -49,6 +51,13 @@ std::size_t InstructionBlock::Length() const
     return list_->size();
 }
 
+std::shared_ptr<Instruction> InstructionBlock::Last() const
+{
+    if (list_->empty())
+        return nullptr;
+    return list_->back();
+}
+
 void InstructionBlock::UpdateStackedJump(std::size_t size)
 {
     auto instr = list_->back().get();
@@ -43,6 +43,9 @@ public:
     /// Length ::= returns the length of the block
     std::size_t Length() const;
 
+    /// Last ::= returns the last instruction, nullptr if the block is empty
+    std::shared_ptr<Instruction> Last() const;
+
     /// UpdateStackedJump ::= updated the length of jump to size
     void UpdateStackedJump(std::size_t size);
 private:
@@ -53,6 +53,16 @@ std::string InstructionToString(const RawInstruction<int> &instr)
     out << std::left << std::setw(10) << instr_to_string[instr.kind_];
     out << std::setw(5) << instr.jmp_addr_;
     out << InstrDataToString(instr);
+    if (instr.op_ != noop)
+        out << " " << instr_to_string[instr.op_];
+    if (instr.kind_ == binr || instr.kind_ == binrjz) {
+        out << " @" << instr.reg_[0] << " @" << instr.reg_[1]
+            << " @" << instr.reg_[2];
+    }
+    if (instr.kind_ == fetche || instr.kind_ == newse)
+        out << " ^" << instr.reg_[0] << " #" << instr.number_;
+    if (instr.prop_.length())
+        out << " ." << instr.prop_;
     return out.str();
 }
 
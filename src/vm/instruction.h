@@ -11,6 +11,7 @@ namespace vm {
 #define INSTRUCTION_LIST_FOR_EACH(op)    \
     op(noop, Noop)   \
     op(fetch, Fetch)   \
+    op(fetchl, FetchLocal)   \
     op(store, Store)   \
     op(markst, Markst)   \
     op(push, Push)   \
@@ -20,8 +21,14 @@ namespace vm {
     op(poprop, PopProp)   \
     op(replprop, ReplProp)   \
     op(index, Index)   \
+    op(stidx, StoreIndex)   \
+    op(updidx, UpdateIndex)   \
     op(res, Res)   \
     op(news, News)   \
+    op(newsl, NewsLocal)   \
+    op(fetche, FetchEnv)   \
+    op(newse, NewsEnv)   \
+    op(clos, Closure)   \
     op(cpya, CopyA)   \
     op(maps, Maps)   \
     op(inc, Inc)  \
@@ -48,9 +55,26 @@ namespace vm {
     op(ors, Ors)   \
     op(ands, Ands)   \
     op(xors, Xors)   \
+    op(binr, BinaryRegister)   \
+    op(fetchp, FetchPush)   \
+    op(fetchlp, FetchLocalPush)   \
+    op(getprop, GetProp)   \
+    op(getpropl, GetPropLocal)   \
+    op(bini, BinaryImmediate)   \
+    op(cmpjz, CompareJump)   \
+    op(binijz, BinaryImmediateJump)   \
+    op(binrjz, BinaryRegisterJump)   \
+    op(adds_dd, AddsDouble)   \
+    op(adds_ss, AddsString)   \
+    op(subs_dd, SubsDouble)   \
+    op(lts_dd, LtsDouble)   \
     op(loopz, Loopz)   \
+    op(enterl, EnterLoop)   \
+    op(nextl, NextIteration)   \
+    op(exitl, ExitLoop)   \
     op(jmp, Jmp)   \
     op(call, Call)   \
+    op(tcall, TailCall)   \
     op(ret, Ret)    \
     op(jmpz, Jmpz)   \
     op(jmpnz, Jmpnz)   \
@@ -89,6 +113,18 @@ struct RawInstruction {
     T jmp_addr_;
     std::shared_ptr<grok::obj::Object> data_;
 
+    // register instructions only, op_ is the kind of the stack instruction
+    // computing the result, reg_[0] is the slot receiving the result and
+    // reg_[1], reg_[2] are the slots of operands. Slot -1 stands for
+    // the number_ as an operand or for pushing the result on the stack.
+    // fetche and newse keep the number of environments to go out in reg_[0]
+    int32_t op_ = noop;
+    int32_t reg_[3] = { -1, -1, -1 };
+
+    // name of the property read by getprop and getpropl, str_ is taken
+    // by the name of the variable holding the object
+    std::string prop_;
+
     auto GetKind() const { return kind_; }
     auto GetDataType() const { return data_type_; }
     auto GetData() const { return data_; }
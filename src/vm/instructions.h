@@ -227,6 +227,307 @@ public:
     const std::string& name() const { return name_; }
 };
 
+// SlotInstruction ::= base for instructions which address a local variable
+// by its slot in the frame of the running function, the name is kept for
+// the cases when the slot is still empty
+class SlotInstruction : public NoopInstruction {
+private:
+    std::string name_;
+    size_t slot_;
+public:
+    SlotInstruction(const std::string &name, size_t slot)
+        : name_{ name }, slot_{ slot }
+    { }
+
+    const std::string& name() const { return name_; }
+    size_t slot() const { return slot_; }
+};
+
+// fetchl ::= same as fetch but for variables resolved to a frame slot
+class FetchLocalInstruction : public SlotInstruction {
+public:
+    FetchLocalInstruction(const std::string &name, size_t slot)
+        : SlotInstruction(name, slot)
+    { }
+
+    DEFINE_INSTRUCTION(FetchLocalInstruction, fetchl)
+
+    static FetchLocalInstruction *Create(const std::string &name, size_t slot)
+    {
+        return new FetchLocalInstruction(name, slot);
+    }
+};
+
+// newsl ::= declares a local variable and binds it to its frame slot
+class NewsLocalInstruction : public SlotInstruction {
+public:
+    NewsLocalInstruction(const std::string &name, size_t slot)
+        : SlotInstruction(name, slot)
+    { }
+
+    DEFINE_INSTRUCTION(NewsLocalInstruction, newsl)
+
+    static NewsLocalInstruction *Create(const std::string &name, size_t slot)
+    {
+        return new NewsLocalInstruction(name, slot);
+    }
+};
+
+// EnvInstruction ::= base for instructions which address a variable
+// captured by closures by its slot in an environment, hops is the number
+// of environments to go out from the one of the running call
+class EnvInstruction : public NoopInstruction {
+private:
+    std::string name_;
+    size_t hops_;
+    size_t slot_;
+public:
+    EnvInstruction(const std::string &name, size_t hops, size_t slot)
+        : name_{ name }, hops_{ hops }, slot_{ slot }
+    { }
+
+    const std::string& name() const { return name_; }
+    size_t hops() const { return hops_; }
+    size_t slot() const { return slot_; }
+};
+
+// fetche ::= same as fetch but for variables captured by closures
+class FetchEnvInstruction : public EnvInstruction {
+public:
+    FetchEnvInstruction(const std::string &name, size_t hops, size_t slot)
+        : EnvInstruction(name, hops, slot)
+    { }
+
+    DEFINE_INSTRUCTION(FetchEnvInstruction, fetche)
+
+    static FetchEnvInstruction *Create(const std::string &name, size_t hops,
+        size_t slot)
+    {
+        return new FetchEnvInstruction(name, hops, slot);
+    }
+};
+
+// newse ::= declares a variable captured by closures unless its slot
+// already holds one
+class NewsEnvInstruction : public EnvInstruction {
+public:
+    NewsEnvInstruction(const std::string &name, size_t hops, size_t slot)
+        : EnvInstruction(name, hops, slot)
+    { }
+
+    DEFINE_INSTRUCTION(NewsEnvInstruction, newse)
+
+    static NewsEnvInstruction *Create(const std::string &name, size_t hops,
+        size_t slot)
+    {
+        return new NewsEnvInstruction(name, hops, slot);
+    }
+};
+
+// clos ::= pushes a closure of the function over the environment of the
+// running call
+class ClosureInstruction : public NoopInstruction {
+public:
+    ClosureInstruction(grok::obj::Handle* obj)
+        : obj_{ obj }
+    { }
+
+    grok::obj::Handle *handle() { return obj_; }
+
+    DEFINE_INSTRUCTION(ClosureInstruction, clos)
+
+    static ClosureInstruction *Create(grok::obj::Handle *obj)
+    {
+        return new ClosureInstruction(obj);
+    }
+private:
+    grok::obj::Handle* obj_;
+};
+
+// binr ::= three address form of a binary operator whose operands are
+// frame slots or a number, the result is stored in a slot or pushed
+class BinaryRegisterInstruction : public NoopInstruction {
+private:
+    InstructionKind op_;
+    int dst_, lhs_, rhs_;
+public:
+    BinaryRegisterInstruction(InstructionKind op, int dst, int lhs, int rhs)
+        : op_{ op }, dst_{ dst }, lhs_{ lhs }, rhs_{ rhs }
+    { }
+
+    InstructionKind op() const { return op_; }
+    int dst() const { return dst_; }
+    int lhs() const { return lhs_; }
+    int rhs() const { return rhs_; }
+
+    DEFINE_INSTRUCTION(BinaryRegisterInstruction, binr)
+
+    static BinaryRegisterInstruction *Create(InstructionKind op, int dst,
+        int lhs, int rhs)
+    {
+        return new BinaryRegisterInstruction(op, dst, lhs, rhs);
+    }
+};
+
+// Fused instructions ::= created by the peephole pass of InstructionBuilder
+// out of the sequences which are generated all the time, each of them
+// does exactly what the sequence would have done
+
+// fetchp ::= fetch + pushim
+class FetchPushInstruction : public ReferenceInstruction {
+public:
+    FetchPushInstruction(const std::string &name)
+        : ReferenceInstruction(name)
+    { }
+
+    DEFINE_INSTRUCTION(FetchPushInstruction, fetchp)
+
+    static FetchPushInstruction *Create(const std::string &name)
+    {
+        return new FetchPushInstruction(name);
+    }
+};
+
+// fetchlp ::= fetchl + pushim
+class FetchLocalPushInstruction : public SlotInstruction {
+public:
+    FetchLocalPushInstruction(const std::string &name, size_t slot)
+        : SlotInstruction(name, slot)
+    { }
+
+    DEFINE_INSTRUCTION(FetchLocalPushInstruction, fetchlp)
+
+    static FetchLocalPushInstruction *Create(const std::string &name,
+        size_t slot)
+    {
+        return new FetchLocalPushInstruction(name, slot);
+    }
+};
+
+// getprop ::= fetch + pushim + replprop
+class GetPropInstruction : public ReferenceInstruction {
+private:
+    std::string prop_;
+public:
+    GetPropInstruction(const std::string &name, const std::string &prop)
+        : ReferenceInstruction(name), prop_{ prop }
+    { }
+
+    const std::string& prop() const { return prop_; }
+
+    DEFINE_INSTRUCTION(GetPropInstruction, getprop)
+
+    static GetPropInstruction *Create(const std::string &name,
+        const std::string &prop)
+    {
+        return new GetPropInstruction(name, prop);
+    }
+};
+
+// getpropl ::= fetchl + pushim + replprop
+class GetPropLocalInstruction : public SlotInstruction {
+private:
+    std::string prop_;
+public:
+    GetPropLocalInstruction(const std::string &name, size_t slot,
+        const std::string &prop)
+        : SlotInstruction(name, slot), prop_{ prop }
+    { }
+
+    const std::string& prop() const { return prop_; }
+
+    DEFINE_INSTRUCTION(GetPropLocalInstruction, getpropl)
+
+    static GetPropLocalInstruction *Create(const std::string &name,
+        size_t slot, const std::string &prop)
+    {
+        return new GetPropLocalInstruction(name, slot, prop);
+    }
+};
+
+// bini ::= push of a number + binary operator
+class BinaryImmediateInstruction : public NoopInstruction {
+private:
+    InstructionKind op_;
+    double number_;
+public:
+    BinaryImmediateInstruction(InstructionKind op, double number)
+        : op_{ op }, number_{ number }
+    { }
+
+    InstructionKind op() const { return op_; }
+    double number() const { return number_; }
+
+    DEFINE_INSTRUCTION(BinaryImmediateInstruction, bini)
+
+    static BinaryImmediateInstruction *Create(InstructionKind op,
+        double number)
+    {
+        return new BinaryImmediateInstruction(op, number);
+    }
+};
+
+// cmpjz ::= comparison + pop + jmpz
+class CompareJumpInstruction : public CountInstruction {
+private:
+    InstructionKind op_;
+public:
+    CompareJumpInstruction(InstructionKind op, size_t count)
+        : CountInstruction(count), op_{ op }
+    { }
+
+    InstructionKind op() const { return op_; }
+
+    DEFINE_INSTRUCTION(CompareJumpInstruction, cmpjz)
+
+    static CompareJumpInstruction *Create(InstructionKind op, size_t count)
+    {
+        return new CompareJumpInstruction(op, count);
+    }
+};
+
+// binijz ::= bini + pop + jmpz
+class BinaryImmediateJumpInstruction : public BinaryImmediateInstruction {
+private:
+    size_t count_;
+public:
+    BinaryImmediateJumpInstruction(InstructionKind op, double number,
+        size_t count)
+        : BinaryImmediateInstruction(op, number), count_{ count }
+    { }
+
+    size_t count() const { return count_; }
+
+    DEFINE_INSTRUCTION(BinaryImmediateJumpInstruction, binijz)
+
+    static BinaryImmediateJumpInstruction *Create(InstructionKind op,
+        double number, size_t count)
+    {
+        return new BinaryImmediateJumpInstruction(op, number, count);
+    }
+};
+
+// binrjz ::= binr + pop + jmpz
+class BinaryRegisterJumpInstruction : public BinaryRegisterInstruction {
+private:
+    size_t count_;
+public:
+    BinaryRegisterJumpInstruction(InstructionKind op, int lhs, int rhs,
+        size_t count)
+        : BinaryRegisterInstruction(op, -1, lhs, rhs), count_{ count }
+    { }
+
+    size_t count() const { return count_; }
+
+    DEFINE_INSTRUCTION(BinaryRegisterJumpInstruction, binrjz)
+
+    static BinaryRegisterJumpInstruction *Create(InstructionKind op,
+        int lhs, int rhs, size_t count)
+    {
+        return new BinaryRegisterJumpInstruction(op, lhs, rhs, count);
+    }
+};
+
 class MapsInstruction : public ReferenceInstruction {
 public:
     MapsInstruction(const std::string &str)
@@ -283,6 +584,22 @@ public:
     }
 };
 
+// tcall ::= call of `return f(...)`, the callee takes over the frame of the
+// running function and returns straight to its caller
+class TailCallInstruction : public CountInstruction {
+public:
+    TailCallInstruction(size_t count)
+        : CountInstruction(count)
+    { }
+
+    DEFINE_INSTRUCTION(TailCallInstruction, tcall)
+
+    static TailCallInstruction *Create(size_t count)
+    {
+        return new TailCallInstruction(count);
+    }
+};
+
 class JmpzInstruction : public CountInstruction {
 public:
     JmpzInstruction(size_t count)
@@ -344,6 +661,8 @@ public:  \
 ZERO_OPERAND_INSTRUCTION(PopInstruction, pop);
 ZERO_OPERAND_INSTRUCTION(PushimInstruction, pushim);
 ZERO_OPERAND_INSTRUCTION(PushThisInstruction, pushthis);
+ZERO_OPERAND_INSTRUCTION(StoreIndexInstruction, stidx);
+ZERO_OPERAND_INSTRUCTION(UpdateIndexInstruction, updidx);
 ZERO_OPERAND_INSTRUCTION(IncInstruction, inc);
 ZERO_OPERAND_INSTRUCTION(DecInstruction, dec);
 ZERO_OPERAND_INSTRUCTION(BNotInstruction, bnot);
@@ -368,10 +687,25 @@ ZERO_OPERAND_INSTRUCTION(BandsInstruction, bands);
 ZERO_OPERAND_INSTRUCTION(OrsInstruction, ors);
 ZERO_OPERAND_INSTRUCTION(AndsInstruction, ands);
 ZERO_OPERAND_INSTRUCTION(XorsInstruction, xors);
+
+// quickened operators are never emitted, the VM rewrites the generic
+// operator into one of them once it has seen the operand types
+ZERO_OPERAND_INSTRUCTION(AddsDoubleInstruction, adds_dd);
+ZERO_OPERAND_INSTRUCTION(AddsStringInstruction, adds_ss);
+ZERO_OPERAND_INSTRUCTION(SubsDoubleInstruction, subs_dd);
+ZERO_OPERAND_INSTRUCTION(LtsDoubleInstruction, lts_dd);
 ZERO_OPERAND_INSTRUCTION(MemCallInstruction, mem_call);
 ZERO_OPERAND_INSTRUCTION(LeaveInstruction, leave);
 ZERO_OPERAND_INSTRUCTION(RetInstruction, ret);
 
+// statements leave their values on the stack, a loop drops the values of
+// every iteration so that the stack doesn't grow with the iterations.
+// enterl marks the height of the stack before the first iteration, nextl
+// brings the stack back to it after each iteration and exitl forgets it
+ZERO_OPERAND_INSTRUCTION(EnterLoopInstruction, enterl);
+ZERO_OPERAND_INSTRUCTION(NextIterationInstruction, nextl);
+ZERO_OPERAND_INSTRUCTION(ExitLoopInstruction, exitl);
+
 #undef ZERO_OPERAND_INSTRUCTION
 
 }
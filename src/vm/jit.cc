@@ -0,0 +1,175 @@
+#include "vm/jit.h"
+#include "vm/vm.h"
+
+#include <sys/mman.h>
+#include <cstring>
+
+#ifdef GROK_BASELINE_JIT
+
+namespace grok {
+namespace vm {
+
+namespace {
+
+/// Assembler ::= just enough of an x86-64 assembler for the JIT, jumps
+/// are always rel32 and get patched once the labels are bound
+class Assembler {
+public:
+    explicit Assembler(size_t labels)
+        : labels_(labels, -1)
+    { }
+
+    void Byte(uint8_t b) { code_.push_back(b); }
+
+    void Bytes(std::initializer_list<uint8_t> bytes)
+    {
+        code_.insert(code_.end(), bytes);
+    }
+
+    void Imm32(int32_t imm)
+    {
+        for (int i = 0; i < 4; i++)
+            Byte(static_cast<uint8_t>(imm >> (8 * i)));
+    }
+
+    void Imm64(uint64_t imm)
+    {
+        for (int i = 0; i < 8; i++)
+            Byte(static_cast<uint8_t>(imm >> (8 * i)));
+    }
+
+    void Bind(size_t label) { labels_[label] = code_.size(); }
+
+    /// Jump ::= jmp (cond == 0) or jcc with the condition code to a label
+    void Jump(size_t label, uint8_t cond = 0)
+    {
+        if (cond)
+            Bytes({ 0x0F, cond });
+        else
+            Byte(0xE9);
+        fixups_.push_back({ code_.size(), label });
+        Imm32(0);
+    }
+
+    /// CallStub ::= stub(vm, instr), the VM is kept in rbx
+    void CallStub(JitStub stub, Bytecode *instr)
+    {
+        Bytes({ 0x48, 0x89, 0xDF });                    // mov rdi, rbx
+        Bytes({ 0x48, 0xBE });                          // mov rsi, instr
+        Imm64(reinterpret_cast<uint64_t>(instr));
+        Bytes({ 0x48, 0xB8 });                          // mov rax, stub
+        Imm64(reinterpret_cast<uint64_t>(stub));
+        Bytes({ 0xFF, 0xD0 });                          // call rax
+    }
+
+    /// Finish ::= resolves the jumps and returns the code
+    const std::vector<uint8_t> &Finish()
+    {
+        for (auto &fixup : fixups_) {
+            auto rel = static_cast<int32_t>(labels_[fixup.second])
+                - static_cast<int32_t>(fixup.first + 4);
+            std::memcpy(&code_[fixup.first], &rel, sizeof(rel));
+        }
+        return code_;
+    }
+
+private:
+    std::vector<uint8_t> code_;
+    std::vector<long> labels_;
+    std::vector<std::pair<size_t, size_t>> fixups_;
+};
+
+constexpr uint8_t je = 0x84;
+constexpr uint8_t jne = 0x85;
+constexpr uint8_t ja = 0x87;
+
+bool IsJump(int kind)
+{
+    switch (kind) {
+    default:
+        return false;
+    case jmp:
+    case jmpz:
+    case jmpnz:
+    case cmpjz:
+    case binijz:
+    case binrjz:
+        return true;
+    }
+}
+
+}
+
+JitCode::~JitCode()
+{
+    munmap(memory_, size_);
+}
+
+std::shared_ptr<JitCode> JitCode::Compile(Code &code)
+{
+    auto size = code.size();
+    auto begin = code.begin();
+
+    // label i is the i-th instruction, label `size` is the exit
+    Assembler masm{ size + 1 };
+    auto exit = size;
+
+    masm.Byte(0x53);                                    // push rbx
+    masm.Bytes({ 0x48, 0x89, 0xFB });                   // mov rbx, rdi
+
+    for (size_t i = 0; i < size; i++) {
+        auto instr = begin + i;
+        auto kind = instr->GetKind();
+        masm.Bind(i);
+
+        if (kind == noop || kind == loopz)
+            continue;
+
+        if (!IsJump(kind)) {
+            masm.CallStub(VM::GetJitStub(kind), instr);
+            if (kind == ret || kind == leave) {
+                masm.Jump(exit);
+            } else {
+                masm.Bytes({ 0x85, 0xC0 });             // test eax, eax
+                masm.Jump(exit, jne);
+            }
+            continue;
+        }
+
+        auto target = static_cast<long>(i) + instr->GetJumpLength() + 1;
+        if (target < 0 || target >= static_cast<long>(size))
+            return nullptr;
+
+        // forward jumps don't need the safe point of JmpOP
+        if (kind == jmp && target > static_cast<long>(i)) {
+            masm.Jump(static_cast<size_t>(target));
+            continue;
+        }
+        masm.CallStub(VM::GetJitStub(kind), instr);
+        masm.Bytes({ 0x83, 0xF8, jit_jump });           // cmp eax, jit_jump
+        masm.Jump(static_cast<size_t>(target), je);
+        masm.Jump(exit, ja);
+    }
+
+    masm.Bind(exit);
+    masm.Byte(0x5B);                                    // pop rbx
+    masm.Byte(0xC3);                                    // ret
+
+    const auto &bytes = masm.Finish();
+    auto memory = mmap(nullptr, bytes.size(), PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED)
+        return nullptr;
+
+    std::memcpy(memory, bytes.data(), bytes.size());
+    if (mprotect(memory, bytes.size(), PROT_READ | PROT_EXEC)) {
+        munmap(memory, bytes.size());
+        return nullptr;
+    }
+    return std::shared_ptr<JitCode>(new JitCode(memory, bytes.size()));
+}
+
+} // vm
+} // grok
+
+#endif // GROK_BASELINE_JIT
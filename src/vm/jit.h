@@ -0,0 +1,66 @@
+#ifndef JIT_H_
+#define JIT_H_
+
+#include "vm/bytecode.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace grok {
+namespace vm {
+
+class VM;
+
+/// JitStatus ::= value returned by the runtime stubs to the compiled code
+/// and by the compiled code to the VM
+enum JitStatus {
+    jit_continue = 0,   // go on with the next instruction
+    jit_jump = 1,       // the instruction has jumped
+    jit_error = 2       // the instruction has thrown, VM holds the exception
+};
+
+/// JitStub ::= runtime function called by the compiled code for executing
+/// an instruction, it gets the VM and the instruction
+using JitStub = int (*)(VM *vm, Bytecode *instr);
+
+/// JitCode ::= x86-64 machine code of a function produced by the call
+/// threaded tier. Every instruction is translated into a call to its
+/// runtime stub, which runs the handler of the VM, so the dispatch of the
+/// interpreter loop is gone but the work of each handler isn't: no
+/// arithmetic, comparison or load of a local is emitted inline. Jumps are
+/// native jumps between the translated instructions. The code runs from
+/// the start of the function until its `ret` and returns the JitStatus of
+/// the last stub.
+class JitCode {
+public:
+    using Entry = int (*)(VM *vm);
+
+    JitCode(const JitCode &) = delete;
+    JitCode &operator=(const JitCode &) = delete;
+    ~JitCode();
+
+    /// Compile ::= translates the code, returns nullptr when the code
+    /// can't be compiled i.e. a jump leaves the function
+    static std::shared_ptr<JitCode> Compile(Code &code);
+
+    int Run(VM *vm) const { return entry_(vm); }
+
+    size_t Size() const { return size_; }
+
+private:
+    JitCode(void *memory, size_t size)
+        : memory_{ memory }, size_{ size },
+          entry_{ reinterpret_cast<Entry>(memory) }
+    { }
+
+    void *memory_;
+    size_t size_;
+    Entry entry_;
+};
+
+} // vm
+} // grok
+
+#endif // jit.h
@@ -0,0 +1,86 @@
+#ifndef NAN_BOX_H_
+#define NAN_BOX_H_
+
+#include <cstdint>
+#include <cstring>
+
+namespace grok {
+namespace vm {
+
+/// nanbox ::= 64-bit encoding of the immediate values which the VM keeps
+/// on its stack without allocating. Doubles are stored as they are (every
+/// NaN is canonicalized to one quiet NaN), the remaining kinds live in the
+/// negative quiet NaN space which no arithmetic result can produce, the
+/// upper 16 bits tell them apart.
+namespace nanbox {
+
+constexpr uint64_t TagMask = 0xFFFF000000000000ULL;
+constexpr uint64_t PayloadMask = 0x0000FFFFFFFFFFFFULL;
+constexpr uint64_t CanonicalNaN = 0x7FF8000000000000ULL;
+
+constexpr uint64_t Int32Tag = 0xFFF9000000000000ULL;
+constexpr uint64_t NullTag = 0xFFFA000000000000ULL;
+constexpr uint64_t UndefinedTag = 0xFFFB000000000000ULL;
+constexpr uint64_t CellTag = 0xFFFC000000000000ULL;
+
+static inline uint64_t EncodeDouble(double num)
+{
+    if (num != num)
+        return CanonicalNaN;
+    uint64_t bits;
+    std::memcpy(&bits, &num, sizeof(bits));
+    return bits;
+}
+
+static inline double DecodeDouble(uint64_t bits)
+{
+    double num;
+    std::memcpy(&num, &bits, sizeof(num));
+    return num;
+}
+
+static inline uint64_t EncodeInt32(int32_t num)
+{
+    return Int32Tag | static_cast<uint32_t>(num);
+}
+
+static inline int32_t DecodeInt32(uint64_t bits)
+{
+    return static_cast<int32_t>(static_cast<uint32_t>(bits));
+}
+
+static inline uint64_t EncodeCell(const void *cell)
+{
+    return CellTag | (reinterpret_cast<uintptr_t>(cell) & PayloadMask);
+}
+
+static inline bool IsDouble(uint64_t bits)
+{
+    return bits < Int32Tag;
+}
+
+static inline bool IsInt32(uint64_t bits)
+{
+    return (bits & TagMask) == Int32Tag;
+}
+
+static inline bool IsNull(uint64_t bits)
+{
+    return (bits & TagMask) == NullTag;
+}
+
+static inline bool IsUndefined(uint64_t bits)
+{
+    return (bits & TagMask) == UndefinedTag;
+}
+
+static inline bool IsCell(uint64_t bits)
+{
+    return (bits & TagMask) == CellTag;
+}
+
+} // nanbox
+} // vm
+} // grok
+
+#endif // nan-box.h
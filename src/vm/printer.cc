@@ -23,6 +23,8 @@ PRINT_ZERO_OPERAND_INSTRUCTION(NoopInstruction, noop)
 PRINT_ZERO_OPERAND_INSTRUCTION(PopInstruction, pop)
 PRINT_ZERO_OPERAND_INSTRUCTION(PushimInstruction, pushim)
 PRINT_ZERO_OPERAND_INSTRUCTION(PushThisInstruction, pushthis)
+PRINT_ZERO_OPERAND_INSTRUCTION(StoreIndexInstruction, stidx)
+PRINT_ZERO_OPERAND_INSTRUCTION(UpdateIndexInstruction, updidx)
 PRINT_ZERO_OPERAND_INSTRUCTION(IncInstruction, inc)
 PRINT_ZERO_OPERAND_INSTRUCTION(DecInstruction, dec)
 PRINT_ZERO_OPERAND_INSTRUCTION(BNotInstruction, bnot)
@@ -47,10 +49,17 @@ PRINT_ZERO_OPERAND_INSTRUCTION(BandsInstruction, bands)
 PRINT_ZERO_OPERAND_INSTRUCTION(OrsInstruction, ors)
 PRINT_ZERO_OPERAND_INSTRUCTION(AndsInstruction, ands)
 PRINT_ZERO_OPERAND_INSTRUCTION(XorsInstruction, xors)
+PRINT_ZERO_OPERAND_INSTRUCTION(AddsDoubleInstruction, adds_dd)
+PRINT_ZERO_OPERAND_INSTRUCTION(AddsStringInstruction, adds_ss)
+PRINT_ZERO_OPERAND_INSTRUCTION(SubsDoubleInstruction, subs_dd)
+PRINT_ZERO_OPERAND_INSTRUCTION(LtsDoubleInstruction, lts_dd)
 PRINT_ZERO_OPERAND_INSTRUCTION(MemCallInstruction, mem_call)
 PRINT_ZERO_OPERAND_INSTRUCTION(LeaveInstruction, leave)
 PRINT_ZERO_OPERAND_INSTRUCTION(MarkstInstruction, martst)
 PRINT_ZERO_OPERAND_INSTRUCTION(RetInstruction, ret)
+PRINT_ZERO_OPERAND_INSTRUCTION(EnterLoopInstruction, enterl)
+PRINT_ZERO_OPERAND_INSTRUCTION(NextIterationInstruction, nextl)
+PRINT_ZERO_OPERAND_INSTRUCTION(ExitLoopInstruction, exitl)
 
 void InstructionPrinter::Visit(FetchInstruction *instr)
 {
@@ -81,6 +90,7 @@ PRINT_COUNT_INSTRUCTION(JmpInstruction, jmp)
 PRINT_COUNT_INSTRUCTION(JmpzInstruction, jmpz)
 PRINT_COUNT_INSTRUCTION(JmpnzInstruction, jmpnz)
 PRINT_COUNT_INSTRUCTION(CallInstruction, call)
+PRINT_COUNT_INSTRUCTION(TailCallInstruction, tcall)
 #undef PRINT_COUNT_INSTRUCTION
 
 #define PRINT_NAME_INSTRUCTION(Instr, kind)    \
@@ -93,6 +103,88 @@ PRINT_NAME_INSTRUCTION(ReplPropInstruction, replprop)
 PRINT_NAME_INSTRUCTION(MapsInstruction, maps)
 PRINT_NAME_INSTRUCTION(NewsInstruction, news)
 
+#define PRINT_SLOT_INSTRUCTION(Instr, kind)    \
+void InstructionPrinter::Visit(Instr *instr)   \
+{   \
+    os() << #kind "\t" << instr->name() << " @" << instr->slot() \
+        << std::endl; \
+}
+
+PRINT_SLOT_INSTRUCTION(FetchLocalInstruction, fetchl)
+PRINT_SLOT_INSTRUCTION(NewsLocalInstruction, newsl)
+#undef PRINT_SLOT_INSTRUCTION
+
+#define PRINT_ENV_INSTRUCTION(Instr, kind)    \
+void InstructionPrinter::Visit(Instr *instr)   \
+{   \
+    os() << #kind "\t" << instr->name() << " ^" << instr->hops() \
+        << " #" << instr->slot() << std::endl; \
+}
+
+PRINT_ENV_INSTRUCTION(FetchEnvInstruction, fetche)
+PRINT_ENV_INSTRUCTION(NewsEnvInstruction, newse)
+#undef PRINT_ENV_INSTRUCTION
+
+void InstructionPrinter::Visit(ClosureInstruction *instr)
+{
+    os() << "clos\t" << std::ios::hex << instr->handle() << std::endl;
+}
+
+void InstructionPrinter::Visit(FetchPushInstruction *instr)
+{
+    os() << "fetchp\t" << instr->name() << std::endl;
+}
+
+void InstructionPrinter::Visit(FetchLocalPushInstruction *instr)
+{
+    os() << "fetchlp\t" << instr->name() << " @" << instr->slot()
+        << std::endl;
+}
+
+void InstructionPrinter::Visit(GetPropInstruction *instr)
+{
+    os() << "getprop\t" << instr->name() << "." << instr->prop()
+        << std::endl;
+}
+
+void InstructionPrinter::Visit(GetPropLocalInstruction *instr)
+{
+    os() << "getpropl\t" << instr->name() << " @" << instr->slot() << "."
+        << instr->prop() << std::endl;
+}
+
+void InstructionPrinter::Visit(BinaryImmediateInstruction *instr)
+{
+    os() << "bini\t" << instr_to_string[instr->op()] << " "
+        << instr->number() << std::endl;
+}
+
+void InstructionPrinter::Visit(CompareJumpInstruction *instr)
+{
+    os() << "cmpjz\t" << instr_to_string[instr->op()] << " "
+        << instr->count() << std::endl;
+}
+
+void InstructionPrinter::Visit(BinaryImmediateJumpInstruction *instr)
+{
+    os() << "binijz\t" << instr_to_string[instr->op()] << " "
+        << instr->number() << " " << instr->count() << std::endl;
+}
+
+void InstructionPrinter::Visit(BinaryRegisterJumpInstruction *instr)
+{
+    os() << "binrjz\t" << instr_to_string[instr->op()] << " @"
+        << instr->lhs() << " @" << instr->rhs() << " " << instr->count()
+        << std::endl;
+}
+
+void InstructionPrinter::Visit(BinaryRegisterInstruction *instr)
+{
+    os() << "binr\t" << instr_to_string[instr->op()] << " @"
+        << instr->dst() << " @" << instr->lhs() << " @" << instr->rhs()
+        << std::endl;
+}
+
 
 #undef PRINT_ZERO_OPERAND_INSTRUCTION
 
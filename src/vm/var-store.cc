@@ -1,60 +1,174 @@
 #include "vm/var-store.h"
 #include "common/exceptions.h"
+#include "object/jsnumber.h"
+
 namespace grok {
 namespace vm {
 
+using namespace grok::obj;
+
+/// null was never falsy in grok because JSNull doesn't override IsTrue,
+/// immediates keep answering the same way as their boxed counterparts
+bool Value::IsTrue() const
+{
+    if (IsDouble())
+        return AsDouble();
+    if (IsInt32())
+        return AsInt32();
+    if (nanbox::IsUndefined(Bits))
+        return false;
+    if (nanbox::IsNull(Bits))
+        return true;
+    return O->get<JSObject>()->IsTrue();
+}
+
+std::shared_ptr<Object> Value::Box() const
+{
+    if (IsCell())
+        return O;
+    if (IsDouble())
+        return CreateJSNumber(AsDouble());
+    if (IsInt32()) {
+        auto N = AllocateShared<JSNumber>(AsInt32());
+        return AllocateShared<Object>(N);
+    }
+    if (nanbox::IsNull(Bits))
+        return CreateJSNull();
+    return CreateUndefinedObject();
+}
+
+std::shared_ptr<Object> Value::Copy() const
+{
+    if (IsCell())
+        return CreateCopy(O);
+    // CreateCopy() has always turned a JSNumber into a JSDouble
+    if (IsInt32())
+        return CreateJSNumber(AsInt32());
+    return Box();
+}
+
+std::vector<bool> VStore::free_names_;
+
+void VStore::MarkFreeName(Atom name)
+{
+    if (name >= free_names_.size())
+        free_names_.resize(name + 1, false);
+    free_names_[name] = true;
+}
+
+bool VStore::CanDropScope()
+{
+    auto &S = VS.Top();
+    if (S.Named)
+        return false;
+    if (!S.Names)
+        return true;
+    for (const auto &Local : *S.Names) {
+        if (Local.first < free_names_.size() && free_names_[Local.first])
+            return false;
+    }
+    return true;
+}
+
 VStore::VStore()
-    : MV{}, VS{}
+    : VS{}
 {
-    MV = std::make_shared<MappedValues>();
-    VS.push_back(MV);
+    VS.Push({ std::make_shared<MappedValues>(), nullptr, nullptr, 0 });
+}
+
+const std::shared_ptr<Object> *VStore::Find(const Scope &S, Atom N)
+{
+    if (S.Named) {
+        if (auto Slot = S.Named->FindSlot(N))
+            return Slot;
+    }
+    if (!S.Names)
+        return nullptr;
+
+    // a slot is empty until the `var` statement of the variable has run
+    for (const auto &Local : *S.Names) {
+        if (Local.first != N)
+            continue;
+        auto Slot = S.Base + Local.second;
+        if (Slot < S.Slots->size() && (*S.Slots)[Slot])
+            return &(*S.Slots)[Slot];
+        return nullptr;
+    }
+    return nullptr;
 }
 
 Value VStore::GetValue(const std::string &N)
 {
-    if (N == "this") {
+    return GetValue(AtomTable::Intern(N));
+}
+
+Value VStore::GetValue(Atom N)
+{
+    if (N == atom_this) {
         auto W = (This());
         return Value(W);
     }
-    if (MV->HasProperty(N))
-        return Value(MV->GetProperty(N));
-
     return TryForOtherScopes(N);
 }
 
 void VStore::StoreValue(const std::string &N, Value V)
 {
-    MV->AddProperty(N, V.O);
+    StoreValue(AtomTable::Intern(N), V);
+}
+
+void VStore::StoreValue(Atom N, Value V)
+{
+    auto &S = VS.Top();
+    if (!S.Named)
+        S.Named = std::make_shared<MappedValues>();
+    S.Named->AddProperty(N, V.O);
+}
+
+void VStore::StoreLocal(Atom N, Value V)
+{
+    if (!VS.Top().Names)
+        StoreValue(N, V);
 }
 
 void VStore::CreateScope()
 {
-    VS.Push(MV);
-    MV = std::make_shared<MappedValues>();
+    VS.Push({ nullptr, nullptr, nullptr, 0 });
+}
+
+void VStore::CreateScope(const LocalNames &names, const LocalSlots &slots,
+    size_t base)
+{
+    VS.Push({ nullptr, &names, &slots, base });
 }
 
 void VStore::RemoveScope()
 {
-    MV = VS.Pop();
+    VS.Pop();
 }
 
-Value VStore::TryForOtherScopes(const std::string &Name)
+/// scopes of grok are dynamic, a name which isn't a variable of the
+/// current call is looked up in the scopes of its callers
+Value VStore::TryForOtherScopes(Atom Name)
 {
     for (auto i = VS.rbegin(); i != VS.rend(); i++) {
-        if ((*i)->HasProperty(Name))
-            return Value((*i)->GetProperty(Name));
+        if (auto Slot = Find(*i, Name))
+            return Value(*Slot);
     }
 
     throw ReferenceError(std::string() + "no variable named '"
-        + Name + "'");
+        + AtomTable::Name(Name) + "'");
 }
 
 bool VStore::HasValue(const std::string &name)
 {
-    if (MV->HasProperty(name))
-        return true;
+    Atom A;
+    return AtomTable::Find(name, A) && HasValue(A);
+}
+
+bool VStore::HasValue(Atom name)
+{
     for (auto i = VS.rbegin(); i != VS.rend(); i++) {
-        if ((*i)->HasProperty(name))
+        if (Find(*i, name))
             return true;
     }
     return false;
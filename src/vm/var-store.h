@@ -1,32 +1,88 @@
 #ifndef VAR_STORE_H_
 #define VAR_STORE_H_
 
+#include "object/atom.h"
 #include "object/object.h"
 #include "common/generic-stack.h"
 #include "object/jsbasicobject.h"
+#include "vm/nan-box.h"
 
 #include <vector>
 
 namespace grok {
 namespace vm {
 
-/// Value ::= Value stored in map
+/// Value ::= Value stored in map. Numbers, null and undefined produced
+/// by the VM are kept unboxed in `Bits` (see nan-box.h) and only get a heap
+/// cell when they escape into an object, a variable or a native function.
+/// For everything else `Bits` is tagged as a cell and `O` holds the handle.
+/// `A` is the name of a property of an object literal, set by `maps`.
+/// So a Value is not one NaN-boxed word: it takes 32 bytes, and copying
+/// or dropping a cell still changes the reference count of its handle.
+/// The operators of jsobject.cc, used whenever an operand isn't a number,
+/// work on boxed handles too.
 struct Value {
     std::shared_ptr<grok::obj::Object> O;
-    std::shared_ptr<std::string> S;
+    grok::obj::Atom A;
+    uint64_t Bits;
 
-    Value(std::shared_ptr<grok::obj::Object> O,
-        std::string S = "")
-        : O{ O }, S{ std::make_shared<std::string>(S) }
+    Value(std::shared_ptr<grok::obj::Object> O)
+        : O{ O }, A{ 0 }, Bits{ nanbox::EncodeCell(O.get()) }
     { }
 
-    Value() = default;
+    Value()
+        : O{ }, A{ 0 }, Bits{ nanbox::EncodeCell(nullptr) }
+    { }
+
+    static Value Number(double num)
+    {
+        return Value(nanbox::EncodeDouble(num));
+    }
+
+    static Value Int32(int32_t num)
+    {
+        return Value(nanbox::EncodeInt32(num));
+    }
+
+    static Value Null()
+    {
+        return Value(nanbox::NullTag);
+    }
+
+    static Value Undefined()
+    {
+        return Value(nanbox::UndefinedTag);
+    }
+
+    bool IsCell() const { return nanbox::IsCell(Bits); }
+    bool IsImmediate() const { return !IsCell(); }
+    bool IsDouble() const { return nanbox::IsDouble(Bits); }
+    bool IsInt32() const { return nanbox::IsInt32(Bits); }
+
+    double AsDouble() const { return nanbox::DecodeDouble(Bits); }
+    int32_t AsInt32() const { return nanbox::DecodeInt32(Bits); }
+
+    /// IsTrue ::= truthiness of the value without boxing it
+    bool IsTrue() const;
+
+    /// Box ::= returns the handle of the value, immediates get a freshly
+    /// allocated object every time this is called
+    std::shared_ptr<grok::obj::Object> Box() const;
+
+    /// Copy ::= same as CreateCopy() of the boxed value but doesn't box
+    /// an immediate twice
+    std::shared_ptr<grok::obj::Object> Copy() const;
+
+private:
+    explicit Value(uint64_t bits)
+        : O{ }, A{ 0 }, Bits{ bits }
+    { }
 };
 
 template <typename T>
 static decltype(auto) GetObjectPointer(Value V)
 {
-    auto obj = V.O;
+    auto obj = V.Box();
     auto pointer = obj->as<T>();
     return pointer;
 }
@@ -34,7 +90,24 @@ static decltype(auto) GetObjectPointer(Value V)
 /// MappedValues ::= value mapped to string
 using MappedValues = grok::obj::JSObject;
 using MappedValuesHandle = std::shared_ptr<MappedValues>;
-using VStoreInternalStack = GenericStack<MappedValuesHandle>;
+
+/// LocalSlots ::= slots of the variables resolved at code generation
+using LocalSlots = std::vector<std::shared_ptr<grok::obj::Object>>;
+
+/// LocalNames ::= names of the slots of a function and their slots
+using LocalNames = std::vector<std::pair<grok::obj::Atom, size_t>>;
+
+/// Scope ::= variables of a call of a function. Those resolved to slots
+/// of its frame are found through the names of the slots, only the rest
+/// are stored by name in Named which is created for the first of them
+struct Scope {
+    MappedValuesHandle Named;
+    const LocalNames *Names;
+    const LocalSlots *Slots;
+    size_t Base;
+};
+
+using VStoreInternalStack = GenericStack<Scope>;
 
 /// VStore ::= class for storing the variables and functions
 /// where each of these variables can be accessed using there names
@@ -44,30 +117,52 @@ public:
 
     /// GetValue ::= returns the Value from the store
     Value GetValue(const std::string &N);
+    Value GetValue(grok::obj::Atom N);
 
     /// StoreValue ::= stores the value from the string
     void StoreValue(const std::string &N, Value V);
+    void StoreValue(grok::obj::Atom N, Value V);
+
+    /// StoreLocal ::= stores the variable of a slot by its name, unless
+    /// the current scope already finds it through the names of its slots
+    void StoreLocal(grok::obj::Atom N, Value V);
 
     /// CreateScope ::= start a new scope
     void CreateScope();
 
-    /// CreateScope ::= start a new scope and loads `this`
-    void CreateScope(std::shared_ptr<grok::obj::JSObject> obj);
+    /// CreateScope ::= start a new scope for a frame which starts at base
+    /// in slots, names must live as long as the scope
+    void CreateScope(const LocalNames &names, const LocalSlots &slots,
+        size_t base);
 
     /// RemoveScope ::= remove the scope and associated variables
     void RemoveScope();
 
-    Value TryForOtherScopes(const std::string &N);
+    Value TryForOtherScopes(grok::obj::Atom N);
 
     auto This()
     {
-        return std::make_shared<grok::obj::Object>(VS[0]);
+        return std::make_shared<grok::obj::Object>(VS[0].Named);
     }
 
     bool HasValue(const std::string &name);
+    bool HasValue(grok::obj::Atom name);
+
+    /// MarkFreeName ::= some function refers to the name without declaring
+    /// it, so a variable of that name may be looked up by a callee
+    static void MarkFreeName(grok::obj::Atom name);
+
+    /// CanDropScope ::= true if no function can look up a variable of the
+    /// current scope by name, the scope may then go before its call ends
+    bool CanDropScope();
 private:
-    MappedValuesHandle MV;
+    /// Find ::= the variable of the scope, nullptr if it has none
+    static const std::shared_ptr<grok::obj::Object> *Find(const Scope &S,
+        grok::obj::Atom N);
+
     VStoreInternalStack VS;
+
+    static std::vector<bool> free_names_;
 };
 
 } // vm
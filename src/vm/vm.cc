@@ -2,12 +2,16 @@
 #include "object/jsbasicobject.h"
 #include "object/jsobject.h"
 #include "object/array.h"
+#include "object/typed-array.h"
 #include "object/object.h"
 #include "object/function.h"
+#include "object/environment.h"
+#include "object/gc.h"
 #include "object/prototype.h"
 
 #include <algorithm>
 #include <bitset>
+#include <limits>
 
 namespace grok {
 namespace vm {
@@ -28,11 +32,10 @@ void VM::ShutDown()
     Current = Start;
 
     Stack.clear();
-    TStack.clear();
-    this_helper.clear();
-    HelperStack.clear();
-    CStack.clear();
-    FStack.clear();
+    Frames.clear();
+    Locals.clear();
+    Loops.clear();
+    frame_base_ = 0;
 }
 
 void VM::Reset()
@@ -40,18 +43,18 @@ void VM::Reset()
     Current = Start;
 
     Stack.clear();
-    TStack.clear();
-    this_helper.clear();
-    HelperStack.clear();
-    CStack.clear();
-    FStack.clear();
+    Frames.clear();
+    Locals.clear();
+    Loops.clear();
+    frame_base_ = 0;
 }
 
 void VM::SetContext(VMContext *context)
 {
     Context = context;
     auto V = GetVStore(Context);
-    js_this_ = (V->This());
+    global_this_ = V->This();
+    js_this_ = global_this_;
 }
 
 Value VM::GetResult()
@@ -60,6 +63,8 @@ Value VM::GetResult()
         return CreateUndefinedObject();
     }
     auto V = Stack.Pop();
+    if (V.IsImmediate())
+        return Value(V.Box());
     return V;
 }
 
@@ -70,8 +75,7 @@ void VM::SetThis(std::shared_ptr<grok::obj::Handle> obj)
 
 void VM::SetThisGlobal()
 {
-    auto V = GetVStore(Context);
-    js_this_ = (V->This());
+    js_this_ = global_this_;
 }
 
 bool VM::IsConstructorCall()
@@ -102,8 +106,8 @@ void VM::RequestInterrupt(Counter start, Counter end)
 
 /// When a function call takes place we have to save the current position
 /// of our instruction register, current instruction we are executing,
-/// flags and a size of stack before the function call because stack grows
-/// in execution of each expression i.e. result is never popped from the 
+/// flags, `this` and a size of stack before the function call because stack
+/// grows in execution of each expression i.e. result is never popped from the 
 /// stack. Consider for example.
 ///             a + b;
 /// as usual instruction generated will be
@@ -113,26 +117,36 @@ void VM::RequestInterrupt(Counter start, Counter end)
 /// Even we don't need to save the result after the statement has been executed
 /// But still the result will remain in stack thus eating up RAM. We can save
 /// bit of RAM by removing the result when function has returned by resizing
-/// the stack to its previous size when it was before function call. That size
-/// is saved in HelperStack
+/// the stack to its previous size when it was before function call. All of
+/// it is saved in a single Frame
+void VM::PushFrame(VMStack::size_type stack_base)
+{
+    Frames.Push({ Current, End, Flags, stack_base, Loops.size(), frame_base_,
+        js_this_, env_, nullptr });
+}
+
+void VM::PopFrame()
+{
+    auto &Caller = Frames.Top();
+    End = Caller.End;
+    Current = Caller.Return;
+    Flags = Caller.Flags;
+    Stack.resize(Caller.StackBase);
+    Loops.resize(Caller.LoopsBase);
+    frame_base_ = Caller.LocalsBase;
+    js_this_ = std::move(Caller.This);
+    env_ = std::move(Caller.Env);
+    Frames.resize(Frames.size() - 1);
+}
+
 void VM::SaveState()
 {
-    CStack.Push(Current);
-    CStack.Push(End);
-    FStack.Push(Flags);
-    HelperStack.Push(Stack.size());
-    this_helper.Push(TStack.size());
+    PushFrame(Stack.size());
 }
 
-/// RestoreState restores the state of the stacks & counters after function
-/// call
 void VM::RestoreState()
 {
-    End = CStack.Pop();
-    Current = CStack.Pop();
-    Flags = FStack.Pop();
-    Stack.resize(HelperStack.Pop());
-    TStack.resize(this_helper.Pop());
+    PopFrame();
 }
 
 void VM::SetAC(Value v)
@@ -151,9 +165,9 @@ void VM::NoOP()
 void VM::FetchOP()
 {
     VStore *V = GetVStore(Context);
-    auto name = GetCurrent()->GetString();
+    auto name = GetCurrent()->GetAtom();
 
-    if (name == "this") {
+    if (name == atom_this) {
         SetAC(GetThis());
         return;
     }
@@ -161,6 +175,20 @@ void VM::FetchOP()
     SetAC(TheValue);
 }
 
+/// fetchl reads the variable straight from the frame. Until the `var`
+/// statement of the variable has been executed the slot is empty and
+/// the name might still refer to a variable from some other scope
+void VM::FetchLocalOP()
+{
+    auto Slot = frame_base_ + static_cast<size_t>(GetCurrent()->GetNumber());
+
+    if (Slot < Locals.size() && Locals[Slot]) {
+        SetAC(Locals[Slot]);
+        return;
+    }
+    FetchOP();
+}
+
 /// Stores the value at the top - 1 position of the stack into the
 /// top position. We also check whether or not the object we are 
 /// wrting is writable or not. Thus supporting const like objects
@@ -168,8 +196,11 @@ void VM::StoreOP()
 {
     auto LHS = Stack.Pop();
     auto RHS = Stack.Pop();
-    if (LHS.O->as<JSObject>()->IsWritable())
-        LHS.O->Reset(*CreateCopy(RHS.O));
+    if (LHS.IsImmediate())
+        LHS = Value(LHS.Box());
+
+    if (LHS.O->get<JSObject>()->IsWritable())
+        LHS.O->Reset(*RHS.Copy());
     Stack.Push(LHS);
     SetFlags();
 }
@@ -187,8 +218,13 @@ std::shared_ptr<grok::obj::Object> VM::GetThis()
 
 void VM::PushNumber(double number)
 {
-    auto V_N_ = CreateJSNumber(number);
-    Stack.Push(V_N_);
+    Stack.Push(Value::Number(number));
+    SetFlags();
+}
+
+void VM::PushInt32(int32_t number)
+{
+    Stack.Push(Value::Int32(number));
     SetFlags();
 }
 
@@ -201,16 +237,14 @@ void VM::PushString(const std::string &str)
 
 void VM::PushNull()
 {
-    auto N = std::make_shared<JSNull>();
-    auto V_N_ = std::make_shared<Handle>(N);
-    Stack.Push(V_N_);
+    Stack.Push(Value::Null());
     SetFlags();
 }
 
 void VM::PushBool(bool boolean)
 {
-    auto V_B_ = CreateJSNumber(boolean);
-    Stack.Push(V_B_);
+    // booleans have always been doubles in grok
+    Stack.Push(Value::Number(boolean));
     SetFlags();
 }
 
@@ -227,7 +261,7 @@ void VM::PushOP()
         break;
 
     case d_bool:
-        PushBool(GetCurrent()->boolean_);
+        PushBool(GetCurrent()->GetBoolean());
         break;
     case d_null:
         PushNull();
@@ -251,10 +285,10 @@ void VM::PushimOP()
     SetFlags();
 }
 
-/// `this` always lies in TStack 
+/// `this` of the caller always lies in its frame
 void VM::PushthisOP()
 {
-    Stack.Push((TStack.Pop()));
+    Stack.Push(Frames.Top().This);
 }
 
 /// opopopopopop
@@ -265,67 +299,281 @@ void VM::PoppropOP()
     auto Sz = static_cast<std::size_t>(GetCurrent()->GetNumber());
     for (decltype(Sz) i = 0; i < Sz; i++) {
         auto Prop = Stack.Pop();
-        if (Prop.S->length() == 0)
+        if (Prop.A == atom_empty)
             throw std::runtime_error("Property name length was 0");
-        Obj->AddProperty(*Prop.S, Prop.O);
+        Obj->AddProperty(Prop.A, Prop.Box());
     }
 
     Stack.Push(O);
     SetFlags();
 }
 
+/// LoadProperty ::= reads a property through the inline cache of the
+/// current instruction. Only plain objects are cached, arrays, strings
+/// and functions answer some names before looking at own properties.
+/// GetProperty always prefers own properties, so whenever the object
+/// has the property after the lookup its slot can be cached
+std::shared_ptr<Handle> VM::LoadProperty(JSObject *Obj, Atom Name)
+{
+    if (Obj->GetType() != ObjectType::_object)
+        return Obj->GetProperty(AtomTable::Name(Name));
+
+    auto &Cache = GetCurrent()->GetCache();
+    if (!Cache) {
+        Cache = CreateInlineCache(
+            std::string(instr_to_string[GetCurrent()->GetKind()]) + " "
+            + AtomTable::Name(Name));
+    }
+
+    size_t Slot;
+    if (Cache->Lookup(Obj->GetShape(), Name, Slot))
+        return Obj->GetSlot(Slot);
+
+    auto Prop = Obj->GetProperty(AtomTable::Name(Name));
+    auto Shape = Obj->GetShape();
+    if (!Cache->IsMegamorphic() && !Shape->IsDictionary()
+            && Shape->Lookup(Name, Slot))
+        Cache->Update(Shape, Name, Slot);
+    return Prop;
+}
+
 void VM::ReplpropOP()
 {
-    auto MayBeObject = Stack.Pop();
-    auto Obj = GetObjectPointer<JSObject>(MayBeObject);
-    auto Name = GetCurrent()->GetString();
+    ReplaceByProperty(Stack.Pop(), GetCurrent()->GetAtom());
+}
 
-    auto Prop = Obj->GetProperty(Name);
+/// ReplaceByProperty ::= pushes the property of the object, the object
+/// becomes `this` of a member call which may follow
+void VM::ReplaceByProperty(Value MayBeObject, Atom Name)
+{
+    auto Boxed = MayBeObject.Box();
+    auto Prop = LoadProperty(Boxed->get<JSObject>(), Name);
     Stack.Push(Prop);
-    member_ = MayBeObject.O;
+    member_ = Boxed;
     SetFlags();
 }
 
-void VM::IndexArray(std::shared_ptr<JSArray> arr, std::shared_ptr<Handle> obj)
+/// ElementNumber ::= the number of a value if it is one
+static bool ElementNumber(const Value &V, double &Number)
 {
-    auto prop = obj->as<JSObject>()->ToString();
-    auto val = arr->At(prop);
-    Stack.Push(val);
+    if (V.IsDouble()) {
+        Number = V.AsDouble();
+        return true;
+    } else if (V.IsInt32()) {
+        Number = V.AsInt32();
+        return true;
+    } else if (!V.IsCell() || !V.O) {
+        return false;
+    }
+
+    switch (V.O->get<JSObject>()->GetType()) {
+    case ObjectType::_number:
+        Number = V.O->get<JSNumber>()->GetValue();
+        return true;
+    case ObjectType::_double:
+        Number = V.O->get<JSDouble>()->GetValue();
+        return true;
+    default:
+        return false;
+    }
 }
 
-void VM::IndexObject(std::shared_ptr<JSObject> obj, std::shared_ptr<Handle> idx)
+/// ElementIndex ::= the index of an element if the value is a number
+/// which can be one
+static bool ElementIndex(const Value &V, size_t &Idx)
 {
+    double Number;
+    if (!ElementNumber(V, Number) || !(Number >= 0) || Number > 1e15)
+        return false;
+    Idx = static_cast<size_t>(Number);
+    return Idx == Number;
+}
+
+/// IndexArray ::= pushes the element, numbers of an array of doubles are
+/// pushed as immediates. Only an index which isn't an integer is turned
+/// into a string
+void VM::IndexArray(std::shared_ptr<JSArray> arr, Value idx)
+{
+    size_t Idx;
+    if (!ElementIndex(idx, Idx)) {
+        auto prop = idx.Box()->as<JSObject>()->ToString();
+        Stack.Push(arr->At(prop));
+        return;
+    }
+
+    if (arr->HasDoubleElements() && Idx < arr->Size()) {
+        auto Element = arr->Doubles()[Idx];
+        Stack.Push(JSArray::IsHole(Element) ? Value::Undefined()
+            : Value::Number(Element));
+        return;
+    }
+    Stack.Push(arr->At(Idx));
+}
+
+/// reading a computed key of a plain object never adds the property, a
+/// missing one is undefined. Only a store adds it, the object interns the
+/// key only while its shape is in the tree so the keys of dictionaries
+/// don't grow the atom table which is never freed. Keys which have an
+/// atom go through the inline cache. Other objects resolve their keys by
+/// themselves
+void VM::IndexObject(std::shared_ptr<JSObject> obj, std::shared_ptr<Handle> idx,
+    bool Store)
+{
+    Atom Name;
     auto prop = idx->as<JSObject>()->ToString();
-    auto val = obj->GetProperty(prop);
-    Stack.Push(val);
+    if (obj->GetType() != ObjectType::_object) {
+        Stack.Push(obj->GetProperty(prop));
+        return;
+    }
+
+    auto Interned = AtomTable::Find(prop, Name);
+    if (Interned && (Store || obj->FindSlot(Name))) {
+        Stack.Push(LoadProperty(obj.get(), Name));
+    } else if (Store) {
+        Stack.Push(obj->GetProperty(prop));
+    } else if (auto val = obj->FindProperty(prop)) {
+        Stack.Push(val);
+    } else {
+        Stack.Push(Value::Undefined());
+    }
 }
 
 void VM::IndexOP()
 {
-    auto index = Stack.Pop().O;
-    auto Unknown = Stack.Pop().O;
+    Index(false);
+}
 
+/// Index ::= pushes the element or the property, Store is true if the
+/// handle pushed is going to be stored into
+void VM::Index(bool Store)
+{
+    auto index = Stack.Pop();
+    auto Unknown = Stack.Pop().Box();
+
+    size_t Idx;
     if (IsJSArray(Unknown)) {
         auto Array = GetObjectPointer<JSArray>(Unknown);
         IndexArray(Array, index);
+    } else if (IsTypedArray(Unknown) && ElementIndex(index, Idx)) {
+        auto Array = GetObjectPointer<TypedArray>(Unknown);
+        if (Idx < Array->Length())
+            Stack.Push(Value::Number(Array->Get(Idx)));
+        else
+            Stack.Push(Value::Undefined());
     } else {
         auto Object = GetObjectPointer<JSObject>(Unknown);
-        IndexObject(Object, index);
+        IndexObject(Object, index.Box(), Store);
     }
     member_ = Unknown;
     SetFlags();
 }
 
+/// stidx ::= `a[i] = v`, a number stored into an array of doubles goes
+/// straight into its storage and the value is left on the stack. Other
+/// values are stored into the handle of the element, the array becomes
+/// generic first unless the element is out of its range. Numbers stored
+/// into a typed array are converted to its element type, stores out of its
+/// range are dropped. Stores to anything else are done by `index` and
+/// `store`
+void VM::StoreIndexOP()
+{
+    auto index = Stack.Pop();
+    auto Unknown = Stack.Pop().Box();
+
+    size_t Idx;
+    if (IsTypedArray(Unknown) && ElementIndex(index, Idx)) {
+        auto Array = GetObjectPointer<TypedArray>(Unknown);
+        double Number;
+        if (!ElementNumber(Stack.Top(), Number))
+            Number = ToElementNumber(Stack.Top().Box());
+        if (Idx < Array->Length())
+            Array->Set(Idx, Number);
+        SetFlags();
+        return;
+    }
+
+    if (IsJSArray(Unknown)) {
+        auto Array = GetObjectPointer<JSArray>(Unknown);
+        double Number;
+        bool IsElement = ElementIndex(index, Idx);
+
+        if (Array->HasDoubleElements() && IsElement && Idx < Array->Size()
+                && ElementNumber(Stack.Top(), Number)) {
+            Array->StoreDouble(Idx, Number);
+            SetFlags();
+            return;
+        }
+        if (!IsElement || Idx < Array->Size())
+            Array->Generalize();
+        if (IsElement) {
+            Stack.Push(Array->At(Idx));
+            StoreOP();
+            return;
+        }
+    }
+
+    Stack.Push(Unknown);
+    Stack.Push(index);
+    Index(true);
+    StoreOP();
+}
+
+/// updidx ::= `++a[i]` (boolean is set) or `a[i]--`, number is the step.
+/// Elements of arrays of doubles and of typed arrays are updated where they
+/// are, anything else is indexed for `inc`, `dec`, `pinc` or `pdec` which
+/// need the handle of the element
+void VM::UpdateIndexOP()
+{
+    auto Step = GetCurrent()->GetNumber();
+    auto Prefix = GetCurrent()->GetBoolean();
+    auto index = Stack.Pop();
+    auto Unknown = Stack.Pop().Box();
+
+    size_t Idx;
+    double Number;
+    if (IsTypedArray(Unknown) && ElementIndex(index, Idx)) {
+        auto Array = GetObjectPointer<TypedArray>(Unknown);
+        Number = Idx < Array->Length() ? Array->Get(Idx)
+            : std::numeric_limits<double>::quiet_NaN();
+        if (Idx < Array->Length())
+            Array->Set(Idx, Number + Step);
+        PushNumber(Prefix ? Number + Step : Number);
+        return;
+    }
+
+    if (IsJSArray(Unknown)) {
+        auto Array = GetObjectPointer<JSArray>(Unknown);
+        if (Array->HasDoubleElements() && ElementIndex(index, Idx)
+                && Idx < Array->Size()
+                && !JSArray::IsHole(Array->Doubles()[Idx])) {
+            Number = Array->Doubles()[Idx];
+            Array->StoreDouble(Idx, Number + Step);
+            PushNumber(Prefix ? Number + Step : Number);
+            return;
+        }
+        Array->Generalize();
+    }
+
+    Stack.Push(Unknown);
+    Stack.Push(index);
+    Index(true);
+    if (Prefix)
+        Step > 0 ? IncOP() : DecOP();
+    else
+        Step > 0 ? PincOP() : PdecOP();
+}
+
 void VM::ResOP()
 {
     auto Sz = static_cast<size_t>(GetCurrent()->GetNumber());
-    auto Array = CreateArray(Sz);
+    auto Array = CreateArray(0);
+    Array->as<JSArray>()->Reserve(Sz);
     SetAC(Array);
 }
 
 void VM::NewsOP()
 {
-    auto name = GetCurrent()->GetString();
+    auto name = GetCurrent()->GetAtom();
     auto var = CreateUndefinedObject();
     auto V = GetVStore(Context);
 
@@ -334,267 +582,613 @@ void VM::NewsOP()
     V->StoreValue(name, var);
 }
 
+/// newsl always creates a new variable like `news` does for `var`
+/// statements. The variable is also stored by its name because scopes
+/// of grok are dynamic, functions called from here may refer to it
+void VM::NewsLocalOP()
+{
+    auto var = CreateUndefinedObject();
+    auto Slot = frame_base_ + static_cast<size_t>(GetCurrent()->GetNumber());
+
+    if (Slot >= Locals.size())
+        Locals.resize(Slot + 1);
+    Locals[Slot] = var;
+    GetVStore(Context)->StoreLocal(GetCurrent()->GetAtom(), var);
+}
+
+/// GetEnvironment ::= the environment hops environments out from the one
+/// of the running call
+Environment *VM::GetEnvironment(size_t hops)
+{
+    auto Env = env_.get();
+    for (; Env && hops; hops--)
+        Env = Env->get<Environment>()->Outer().get();
+
+    if (!Env)
+        throw std::runtime_error("fatal: no environment");
+    return Env->get<Environment>();
+}
+
+/// fetche reads a captured variable from its environment, like fetchl it
+/// falls back to the name while the variable hasn't been declared
+void VM::FetchEnvOP()
+{
+    auto Env = GetEnvironment(GetCurrent()->GetRegister(0));
+    auto &Slot = Env->Slot(static_cast<size_t>(GetCurrent()->GetNumber()));
+
+    if (Slot) {
+        SetAC(Slot);
+        return;
+    }
+    FetchOP();
+}
+
+/// newse declares a captured variable once for each call, a `var`
+/// statement executed again in a loop keeps the variable the closures
+/// created by earlier iterations refer to
+void VM::NewsEnvOP()
+{
+    auto Env = GetEnvironment(GetCurrent()->GetRegister(0));
+    auto &Slot = Env->Slot(static_cast<size_t>(GetCurrent()->GetNumber()));
+
+    if (!Slot)
+        Slot = CreateUndefinedObject();
+}
+
+void VM::ClosureOP()
+{
+    auto F = GetCurrent()->GetData()->get<Function>();
+    Stack.Push(F->CreateClosure(env_));
+}
+
+/// CpyaOP ::= pushes the elements of an array literal into the array
+/// reserved by `res`, numbers are copied without boxing them
 void VM::CpyaOP()
 {
     auto Array = GetObjectPointer<JSArray>(AC);
 
     auto Sz = static_cast<size_t>(GetCurrent()->GetNumber());
-
-    for (decltype(Sz) i = Sz; i > 0; i--) {
-        Array->Assign(i - 1, Stack.Pop().O);
+    auto First = Stack.size() - Sz;
+    double Number;
+
+    for (auto i = First; i < First + Sz; i++) {
+        if (ElementNumber(Stack[i], Number))
+            Array->PushDouble(Number);
+        else
+            Array->Push(Stack[i].Box());
     }
+    Stack.resize(First);
 }
 
 void VM::MapsOP()
 {
-    auto S = std::make_shared<std::string>(GetCurrent()->GetString());
-    Stack.Top().S = S;
+    Stack.Top().A = GetCurrent()->GetAtom();
 }
 
 void VM::SetFlags()
 {
-    auto Obj = Stack.Top().O->as<JSObject>();
-
-    if (!Obj->IsTrue()) 
+    if (!Stack.Top().IsTrue())
         Flags |= zero_flag;
     else 
         Flags &= ~zero_flag;
 
 }
 
-void VM::AddsOP()
+/// NumericOperand ::= number read straight out of a stack value, it is
+/// either an immediate or a cell holding a JSNumber or a JSDouble
+struct NumericOperand {
+    bool is_int;
+    int32_t i;
+    double d;
+};
+
+static inline bool LoadNumeric(const Value &V, NumericOperand &N)
 {
-    auto RHS = *(Stack.Pop().O);
-    auto LHS = *(Stack.Pop().O);
-    auto Result = std::make_shared<Handle>(LHS + RHS);
-    Stack.Push(Result);
-    SetFlags();
+    if (V.IsDouble()) {
+        N.is_int = false;
+        N.d = V.AsDouble();
+        return true;
+    } else if (V.IsInt32()) {
+        N.is_int = true;
+        N.i = V.AsInt32();
+        N.d = N.i;
+        return true;
+    } else if (!V.IsCell() || !V.O) {
+        return false;
+    }
+
+    switch (V.O->get<JSObject>()->GetType()) {
+    case ObjectType::_number:
+        N.is_int = true;
+        N.i = V.O->get<JSNumber>()->GetValue();
+        N.d = N.i;
+        return true;
+    case ObjectType::_double:
+        N.is_int = false;
+        N.d = V.O->get<JSDouble>()->GetValue();
+        return true;
+    default:
+        return false;
+    }
 }
 
-void VM::SubsOP()
+/// NumericFeedback ::= type feedback of a numeric operand
+static inline uint8_t NumericFeedback(const NumericOperand &N)
 {
-    auto RHS = *(Stack.Pop().O);
-    auto LHS = *(Stack.Pop().O);
-    auto Result = std::make_shared<Handle>(LHS - RHS);
-    Stack.Push(Result);
-    SetFlags();
+    return N.is_int ? fb_int : fb_double;
 }
 
-void VM::MulsOP()
+/// OperandFeedback ::= type feedback of any operand, only needed when the
+/// operands weren't both numbers
+static uint8_t OperandFeedback(const Value &V)
 {
-    auto RHS = *(Stack.Pop().O);
-    auto LHS = *(Stack.Pop().O);
-    auto Result = std::make_shared<Handle>(LHS * RHS);
-    Stack.Push(Result);
-    SetFlags();
+    NumericOperand N;
+    if (LoadNumeric(V, N))
+        return NumericFeedback(N);
+    else if (V.IsCell() && V.O
+            && V.O->get<JSObject>()->GetType() == ObjectType::_string)
+        return fb_string;
+    return fb_other;
 }
 
-void VM::DivsOP()
+/// QuickenedOperator ::= variant of a generic operator for the feedback
+/// or noop when there is none. Only feedback of a single type is ever
+/// quickened, so an operator which has missed once stays generic
+static int32_t QuickenedOperator(int32_t Kind, uint8_t Feedback)
 {
-    auto RHS = *(Stack.Pop().O);
-    auto LHS = *(Stack.Pop().O);
-    auto Result = std::make_shared<Handle>(LHS / RHS);
-    Stack.Push(Result);
-    SetFlags();
+    switch (Kind) {
+    case Instructions::adds:
+        if (Feedback == fb_string)
+            return Instructions::adds_ss;
+        return Feedback == fb_double ? Instructions::adds_dd : noop;
+    case Instructions::subs:
+        return Feedback == fb_double ? Instructions::subs_dd : noop;
+    case Instructions::lts:
+        return Feedback == fb_double ? Instructions::lts_dd : noop;
+    default:
+        return noop;
+    }
 }
 
-void VM::RemsOP()
+/// RecordFeedback ::= adds the operand types to the feedback of the
+/// current instruction and quickens its operator if it became monomorphic
+void VM::RecordFeedback(int32_t Kind, uint8_t Types)
 {
-    auto RHS = *(Stack.Pop().O);
-    auto LHS = *(Stack.Pop().O);
-    auto Result = std::make_shared<Handle>(LHS % RHS);
-    Stack.Push(Result);
-    SetFlags();
+    auto Instr = GetCurrent();
+    if ((Instr->GetFeedback() | Types) == Instr->GetFeedback())
+        return;
+    Instr->AddFeedback(Types);
+    auto Quickened = QuickenedOperator(Kind, Instr->GetFeedback());
+    if (Quickened != noop)
+        Instr->RewriteOperator(Kind, Quickened);
 }
 
-void VM::GtsOP()
+static inline int32_t ToInt32(const NumericOperand &N)
 {
-    auto RHS = *(Stack.Pop().O);
-    auto LHS = *(Stack.Pop().O);
-    auto Result = std::make_shared<Handle>(LHS > RHS);
-    Stack.Push(Result);
-    SetFlags();
+    return N.is_int ? N.i : static_cast<int32_t>(N.d);
 }
 
-void VM::LtsOP()
+/// int32 arithmetic of JSNumber's wraps around, do it in 64 bits so that
+/// the overflow is well defined
+static inline int32_t WrapInt32(int64_t num)
 {
-    auto RHS = *(Stack.Pop().O);
-    auto LHS = *(Stack.Pop().O);
-    auto Result = std::make_shared<Handle>(LHS < RHS);
-    Stack.Push(Result);
+    return static_cast<int32_t>(static_cast<uint32_t>(num));
+}
+
+/// All the binary operators first try to operate on the numbers directly,
+/// the result has the same type as operators in jsobject.cc would have
+/// produced (JSNumber when both operands are JSNumber, else JSDouble for
+/// arithmetic and JSNumber for comparisons and bitwise operators). Anything
+/// else falls back to the generic operators on the boxed values.
+/// Arithmetic and comparisons also collect the type feedback.
+#define GENERIC_BINARY_OPERATOR(op) \
+    auto Result = AllocateShared<Handle>(*LHS.Box() op *RHS.Box()); \
+    Stack.Push(Result); \
     SetFlags();
+
+#define ARITHMETIC_OPERATOR(Name, instr, op) \
+void VM::Name() \
+{ \
+    auto RHS = Stack.Pop(); \
+    auto LHS = Stack.Pop(); \
+    NumericOperand L, R; \
+    if (LoadNumeric(LHS, L) && LoadNumeric(RHS, R)) { \
+        RecordFeedback(instr, NumericFeedback(L) | NumericFeedback(R)); \
+        if (L.is_int && R.is_int) \
+            PushInt32(WrapInt32(static_cast<int64_t>(L.i) op R.i)); \
+        else \
+            PushNumber(L.d op R.d); \
+        return; \
+    } \
+    RecordFeedback(instr, OperandFeedback(LHS) | OperandFeedback(RHS)); \
+    GENERIC_BINARY_OPERATOR(op) \
+}
+
+#define COMPARISON_OPERATOR(Name, instr, op) \
+void VM::Name() \
+{ \
+    auto RHS = Stack.Pop(); \
+    auto LHS = Stack.Pop(); \
+    NumericOperand L, R; \
+    if (LoadNumeric(LHS, L) && LoadNumeric(RHS, R)) { \
+        RecordFeedback(instr, NumericFeedback(L) | NumericFeedback(R)); \
+        PushInt32(L.d op R.d); \
+        return; \
+    } \
+    RecordFeedback(instr, OperandFeedback(LHS) | OperandFeedback(RHS)); \
+    GENERIC_BINARY_OPERATOR(op) \
+}
+
+#define INTEGER_OPERATOR(Name, op) \
+void VM::Name() \
+{ \
+    auto RHS = Stack.Pop(); \
+    auto LHS = Stack.Pop(); \
+    NumericOperand L, R; \
+    if (LoadNumeric(LHS, L) && LoadNumeric(RHS, R)) { \
+        PushInt32(ToInt32(L) op ToInt32(R)); \
+        return; \
+    } \
+    GENERIC_BINARY_OPERATOR(op) \
+}
+
+/// operators in jsobject.cc truncate a double on the left to int32 before
+/// testing it, but test a double on the right as it is unless the left one
+/// was a double too
+#define LOGICAL_OPERATOR(Name, op) \
+void VM::Name() \
+{ \
+    auto RHS = Stack.Pop(); \
+    auto LHS = Stack.Pop(); \
+    NumericOperand L, R; \
+    if (LoadNumeric(LHS, L) && LoadNumeric(RHS, R)) { \
+        bool LT = ToInt32(L) != 0; \
+        bool RT = L.is_int ? R.d != 0 : ToInt32(R) != 0; \
+        PushInt32(LT op RT); \
+        return; \
+    } \
+    GENERIC_BINARY_OPERATOR(op) \
+}
+
+ARITHMETIC_OPERATOR(AddsOP, adds, +)
+ARITHMETIC_OPERATOR(SubsOP, subs, -)
+ARITHMETIC_OPERATOR(MulsOP, muls, *)
+
+void VM::DivsOP()
+{
+    auto RHS = Stack.Pop();
+    auto LHS = Stack.Pop();
+    NumericOperand L, R;
+    if (LoadNumeric(LHS, L) && LoadNumeric(RHS, R)) {
+        if (!L.is_int || !R.is_int) {
+            PushNumber(L.d / R.d);
+            return;
+        } else if (R.i != 0 && !(R.i == -1 && L.i == INT32_MIN)) {
+            PushInt32(L.i / R.i);
+            return;
+        }
+    }
+    GENERIC_BINARY_OPERATOR(/)
 }
-void VM::GtesOP()
+
+void VM::RemsOP()
 {
-    auto RHS = *(Stack.Pop().O);
-    auto LHS = *(Stack.Pop().O);
-    auto Result = std::make_shared<Handle>(LHS >= RHS);
-    Stack.Push(Result);
-    SetFlags();
+    auto RHS = Stack.Pop();
+    auto LHS = Stack.Pop();
+    NumericOperand L, R;
+    if (LoadNumeric(LHS, L) && LoadNumeric(RHS, R)) {
+        auto Dividend = ToInt32(L);
+        auto Divisor = ToInt32(R);
+        if (Divisor != 0 && !(Divisor == -1 && Dividend == INT32_MIN)) {
+            PushInt32(Dividend % Divisor);
+            return;
+        }
+    }
+    GENERIC_BINARY_OPERATOR(%)
 }
 
-void VM::LtesOP()
+COMPARISON_OPERATOR(GtsOP, gts, >)
+COMPARISON_OPERATOR(LtsOP, lts, <)
+COMPARISON_OPERATOR(GtesOP, gtes, >=)
+COMPARISON_OPERATOR(LtesOP, ltes, <=)
+COMPARISON_OPERATOR(EqsOP, eqs, ==)
+COMPARISON_OPERATOR(NeqsOP, neqs, !=)
+
+INTEGER_OPERATOR(ShlsOP, <<)
+INTEGER_OPERATOR(ShrsOP, >>)
+INTEGER_OPERATOR(BorsOP, |)
+INTEGER_OPERATOR(BandsOP, &)
+INTEGER_OPERATOR(XorsOP, ^)
+
+LOGICAL_OPERATOR(OrsOP, ||)
+LOGICAL_OPERATOR(AndsOP, &&)
+
+/// LoadDouble ::= reads an operand of a quickened double operator
+static inline bool LoadDouble(const Value &V, double &D)
 {
-    auto RHS = *(Stack.Pop().O);
-    auto LHS = *(Stack.Pop().O);
-    auto Result = std::make_shared<Handle>(LHS <= RHS);
-    Stack.Push(Result);
+    if (V.IsDouble()) {
+        D = V.AsDouble();
+        return true;
+    } else if (!V.IsCell() || !V.O
+            || V.O->get<JSObject>()->GetType() != ObjectType::_double) {
+        return false;
+    }
+    D = V.O->get<JSDouble>()->GetValue();
+    return true;
+}
+
+/// LoadString ::= reads an operand of a quickened string operator
+static inline JSString *LoadString(const Value &V)
+{
+    if (!V.IsCell() || !V.O
+            || V.O->get<JSObject>()->GetType() != ObjectType::_string)
+        return nullptr;
+    return V.O->get<JSString>();
+}
+
+/// Quickened operators only check the operand types they were made for,
+/// on a miss the operator is rewritten back to the generic one, which
+/// runs on the operands still on the stack
+#define QUICKENED_DOUBLE_OPERATOR(Name, instr, generic, Generic, Push, op) \
+void VM::Name() \
+{ \
+    auto Size = Stack.size(); \
+    double L, R; \
+    if (Size >= 2 && LoadDouble(Stack[Size - 2], L) \
+            && LoadDouble(Stack[Size - 1], R)) { \
+        Stack.resize(Size - 2); \
+        Push(L op R); \
+        return; \
+    } \
+    GetCurrent()->RewriteOperator(instr, generic); \
+    Generic(); \
+}
+
+QUICKENED_DOUBLE_OPERATOR(AddsDoubleOP, adds_dd, adds, AddsOP, PushNumber, +)
+QUICKENED_DOUBLE_OPERATOR(SubsDoubleOP, subs_dd, subs, SubsOP, PushNumber, -)
+QUICKENED_DOUBLE_OPERATOR(LtsDoubleOP, lts_dd, lts, LtsOP, PushInt32, <)
+
+void VM::AddsStringOP()
+{
+    auto Size = Stack.size();
+    if (Size >= 2 && LoadString(Stack[Size - 2])
+            && LoadString(Stack[Size - 1])) {
+        auto Result = CreateJSRope(Stack[Size - 2].O->as<JSString>(),
+            Stack[Size - 1].O->as<JSString>());
+        Stack.resize(Size - 2);
+        Stack.Push(Result);
+        SetFlags();
+        return;
+    }
+    GetCurrent()->RewriteOperator(adds_ss, adds);
+    AddsOP();
+}
+
+#undef ARITHMETIC_OPERATOR
+#undef COMPARISON_OPERATOR
+#undef INTEGER_OPERATOR
+#undef LOGICAL_OPERATOR
+#undef QUICKENED_DOUBLE_OPERATOR
+#undef GENERIC_BINARY_OPERATOR
+
+/// binr does what the stack code for `a = b op c` or `b op c` would have
+/// done i.e. pushes the operands, runs the operator and stores the result
+/// like `store`, without fetching the locals by instructions. Registers
+/// are slots of the frame which are never empty when binr runs
+void VM::BinaryRegisterOP()
+{
+    auto Instr = GetCurrent();
+
+    for (int i = 1; i <= 2; i++) {
+        auto Reg = Instr->GetRegister(i);
+        if (Reg < 0)
+            Stack.Push(Value::Number(Instr->GetNumber()));
+        else
+            Stack.Push(Value(Locals[frame_base_ + Reg]));
+    }
+    BinaryOperator(Instr->GetOperator());
+
+    auto Dst = Instr->GetRegister(0);
+    if (Dst < 0)
+        return;
+
+    auto RHS = Stack.Pop();
+    auto LHS = Locals[frame_base_ + Dst];
+    if (LHS->get<JSObject>()->IsWritable())
+        LHS->Reset(*RHS.Copy());
+    Stack.Push(Value(LHS));
     SetFlags();
 }
 
-void VM::EqsOP()
+/// BinaryOperator ::= runs the handler of a binary operator instruction
+void VM::BinaryOperator(int32_t Kind)
 {
-    auto RHS = *(Stack.Pop().O);
-    auto LHS = *(Stack.Pop().O);
-    auto Result = std::make_shared<Handle>(LHS == RHS);
-    Stack.Push(Result);
-    SetFlags();
+    switch (Kind) {
+    default:
+        throw std::runtime_error("fatal: not a binary operator in binr");
+#define BINARY_OPERATOR_CASE(instr, Handler) \
+    case Instructions::instr: \
+        Handler(); \
+        break;
+    BINARY_OPERATOR_CASE(adds, AddsOP)
+    BINARY_OPERATOR_CASE(subs, SubsOP)
+    BINARY_OPERATOR_CASE(muls, MulsOP)
+    BINARY_OPERATOR_CASE(divs, DivsOP)
+    BINARY_OPERATOR_CASE(rems, RemsOP)
+    BINARY_OPERATOR_CASE(shls, ShlsOP)
+    BINARY_OPERATOR_CASE(shrs, ShrsOP)
+    BINARY_OPERATOR_CASE(lts, LtsOP)
+    BINARY_OPERATOR_CASE(ltes, LtesOP)
+    BINARY_OPERATOR_CASE(gts, GtsOP)
+    BINARY_OPERATOR_CASE(gtes, GtesOP)
+    BINARY_OPERATOR_CASE(eqs, EqsOP)
+    BINARY_OPERATOR_CASE(neqs, NeqsOP)
+    BINARY_OPERATOR_CASE(bands, BandsOP)
+    BINARY_OPERATOR_CASE(bors, BorsOP)
+    BINARY_OPERATOR_CASE(xors, XorsOP)
+    BINARY_OPERATOR_CASE(ands, AndsOP)
+    BINARY_OPERATOR_CASE(ors, OrsOP)
+    BINARY_OPERATOR_CASE(adds_dd, AddsDoubleOP)
+    BINARY_OPERATOR_CASE(adds_ss, AddsStringOP)
+    BINARY_OPERATOR_CASE(subs_dd, SubsDoubleOP)
+    BINARY_OPERATOR_CASE(lts_dd, LtsDoubleOP)
+#undef BINARY_OPERATOR_CASE
+    }
 }
 
-void VM::NeqsOP()
+/// The fused instructions below do exactly what their sequences would do,
+/// only the pushim + replprop of getprop skips the round trip through
+/// the stack
+void VM::FetchPushOP()
 {
-    auto RHS = *(Stack.Pop().O);
-    auto LHS = *(Stack.Pop().O);
-    auto Result = std::make_shared<Handle>(LHS != RHS);
-    Stack.Push(Result);
-    SetFlags();
+    FetchOP();
+    PushimOP();
 }
 
-void VM::ShlsOP()
+void VM::FetchLocalPushOP()
 {
-    auto RHS = *(Stack.Pop().O);
-    auto LHS = *(Stack.Pop().O);
-    auto Result = std::make_shared<Handle>(LHS << RHS);
-    Stack.Push(Result);
-    SetFlags();
+    FetchLocalOP();
+    PushimOP();
 }
 
-void VM::ShrsOP()
+void VM::GetPropOP()
 {
-    auto RHS = *(Stack.Pop().O);
-    auto LHS = *(Stack.Pop().O);
-    auto Result = std::make_shared<Handle>(LHS >> RHS);
-    Stack.Push(Result);
-    SetFlags();
+    FetchOP();
+    ReplaceByProperty(AC, GetCurrent()->GetPropertyAtom());
 }
 
-void VM::BorsOP()
+void VM::GetPropLocalOP()
 {
-    auto RHS = *(Stack.Pop().O);
-    auto LHS = *(Stack.Pop().O);
-    auto Result = std::make_shared<Handle>(LHS | RHS);
-    Stack.Push(Result);
-    SetFlags();
+    FetchLocalOP();
+    ReplaceByProperty(AC, GetCurrent()->GetPropertyAtom());
 }
 
-void VM::BandsOP()
+void VM::BinaryImmediateOP()
 {
-    auto RHS = *(Stack.Pop().O);
-    auto LHS = *(Stack.Pop().O);
-    auto Result = std::make_shared<Handle>(LHS & RHS);
-    Stack.Push(Result);
-    SetFlags();
+    Stack.Push(Value::Number(GetCurrent()->GetNumber()));
+    BinaryOperator(GetCurrent()->GetOperator());
 }
 
-void VM::OrsOP()
+void VM::CompareJumpOP()
 {
-    auto RHS = *(Stack.Pop().O);
-    auto LHS = *(Stack.Pop().O);
-    auto Result = std::make_shared<Handle>(LHS || RHS);
-    Stack.Push(Result);
-    SetFlags();
+    BinaryOperator(GetCurrent()->GetOperator());
+    Stack.Pop();
+    JmpzOP();
 }
 
-void VM::AndsOP()
+void VM::BinaryImmediateJumpOP()
 {
-    auto RHS = *(Stack.Pop().O);
-    auto LHS = *(Stack.Pop().O);
-    auto Result = std::make_shared<Handle>(LHS && RHS);
-    Stack.Push(Result);
-    SetFlags();
+    BinaryImmediateOP();
+    Stack.Pop();
+    JmpzOP();
 }
 
-void VM::XorsOP()
+void VM::BinaryRegisterJumpOP()
 {
-    auto RHS = *(Stack.Pop().O);
-    auto LHS = *(Stack.Pop().O);
-    auto Result = std::make_shared<Handle>(LHS ^ RHS);
-    Stack.Push(Result);
-    SetFlags();
+    BinaryRegisterOP();
+    Stack.Pop();
+    JmpzOP();
 }
 
+/// inc and dec modify the variable in place, so they still need the cell
 void VM::IncOP()
 {
-    auto RHS = Stack.Pop().O;
-    if (!IsJSNumber(RHS)) {
+    auto RHS = Stack.Pop();
+    NumericOperand N;
+    if (!LoadNumeric(RHS, N)) {
         throw ReferenceError("can't apply increment operator");
     }
-    auto num = RHS->as<JSDouble>();
-    ++num->GetNumber();
+
+    if (RHS.IsImmediate()) {
+        N.is_int ? PushInt32(WrapInt32(N.i + 1LL)) : PushNumber(N.d + 1);
+        return;
+    }
+
+    if (N.is_int)
+        ++RHS.O->get<JSNumber>()->GetNumber();
+    else
+        ++RHS.O->get<JSDouble>()->GetNumber();
     Stack.Push(RHS);
     SetFlags();
 }
 
 void VM::DecOP()
 {
-    auto RHS = Stack.Pop().O;
-    if (!IsJSNumber(RHS)) {
+    auto RHS = Stack.Pop();
+    NumericOperand N;
+    if (!LoadNumeric(RHS, N)) {
         throw ReferenceError("can't apply increment operator");
     }
-    auto num = RHS->as<JSDouble>();
-    --num->GetNumber();
+
+    if (RHS.IsImmediate()) {
+        N.is_int ? PushInt32(WrapInt32(N.i - 1LL)) : PushNumber(N.d - 1);
+        return;
+    }
+
+    if (N.is_int)
+        --RHS.O->get<JSNumber>()->GetNumber();
+    else
+        --RHS.O->get<JSDouble>()->GetNumber();
     Stack.Push(RHS);
     SetFlags();
 }
 
 void VM::SnotOP()
 {
-    auto RHS = Stack.Pop().O;
-    auto obj = RHS->as<JSObject>();
-    auto num = CreateJSNumber(!obj->IsTrue());
-    Stack.Push(num);
-    SetFlags();
+    auto RHS = Stack.Pop();
+    PushNumber(!RHS.IsTrue());
 }
 
 void VM::BnotOP()
 {
-    auto RHS = Stack.Pop().O;
-    if (!IsJSNumber(RHS)) {
+    auto RHS = Stack.Pop();
+    NumericOperand N;
+    if (!LoadNumeric(RHS, N)) {
         throw ReferenceError("can't apply '~' operator");
     }
-    auto num = RHS->as<JSDouble>();
-    auto res = CreateJSNumber(~(int32_t)num->GetNumber());
-    Stack.Push(res);
-    SetFlags();
+    PushNumber(~ToInt32(N));
 }
 
 void VM::PincOP()
 {
-    auto RHS = Stack.Pop().O;
-    if (!IsJSNumber(RHS)) {
+    auto RHS = Stack.Pop();
+    NumericOperand N;
+    if (!LoadNumeric(RHS, N)) {
         throw ReferenceError("can't apply '++' operator");
     }
-    auto num = RHS->as<JSDouble>();
-    auto res = CreateJSNumber(num->GetNumber()++);
-    Stack.Push(res);
-    SetFlags();
+
+    if (RHS.IsCell()) {
+        if (N.is_int)
+            RHS.O->get<JSNumber>()->GetNumber()++;
+        else
+            RHS.O->get<JSDouble>()->GetNumber()++;
+    }
+    PushNumber(N.d);
 }
 
 void VM::PdecOP()
 {
-    auto RHS = Stack.Pop().O;
-    if (!IsJSNumber(RHS)) {
+    auto RHS = Stack.Pop();
+    NumericOperand N;
+    if (!LoadNumeric(RHS, N)) {
         throw ReferenceError("can't apply '--' operator");
     }
-    auto num = RHS->as<JSDouble>();
-    auto res = CreateJSNumber(num->GetNumber()--);
-    Stack.Push(res);
-    SetFlags();
+
+    if (RHS.IsCell()) {
+        if (N.is_int)
+            RHS.O->get<JSNumber>()->GetNumber()--;
+        else
+            RHS.O->get<JSDouble>()->GetNumber()--;
+    }
+    PushNumber(N.d);
 }
 
 void VM::JmpOP()
 {
-    Current += GetCurrent()->jmp_addr_; 
+    auto Length = GetCurrent()->GetJumpLength();
+    if (Length < 0)
+        SafePoint();
+    Current += Length;
 }
 
 void VM::JmpzOP()
@@ -609,13 +1203,33 @@ void VM::JmpnzOP()
         JmpOP();
 }
 
+void VM::EnterLoopOP()
+{
+    Loops.push_back(Stack.size());
+}
+
+/// NextIterationOP ::= drops the values the statements of the iteration
+/// left on the stack, a declaration without a value pops one value more
+/// than it pushes so the stack might already be lower
+void VM::NextIterationOP()
+{
+    auto Height = Loops.back();
+    if (Stack.size() > Height)
+        Stack.resize(Height);
+}
+
+void VM::ExitLoopOP()
+{
+    Loops.pop_back();
+}
+
 PassedArguments VM::CreateArgumentList(size_t sz)
 {
     PassedArguments Args;
 
     Args.resize(sz);
     while (sz--) {
-        Args[sz] = CreateCopy(Stack.Pop().O);
+        Args[sz] = Stack.Pop().Copy();
     }
 
     return (Args);
@@ -626,91 +1240,172 @@ void VM::MarkstOP()
     Flags |= constructor_call;
 }
 
+/// CallNative ::= calls a native of the old calling convention, it gets
+/// no frame. A constructor gets a new object as `this`
 void VM::CallNative(std::shared_ptr<Handle> function_object,
     PassedArguments &Args)
 {
     auto function = function_object->as<Function>();
+    auto OldFlags = Flags;
+    auto Caller = js_this_;
 
-    auto This = GetThis();
-    auto ret = function->CallNative(Args, This);
-    Flags = FStack.Pop();
-    CStack.Pop();
-    CStack.Pop();
-    HelperStack.Pop();
+    if (IsConstructorCall()) {
+        auto newthis_wrapped = CreateJSObject();
+        auto newthis = newthis_wrapped->as<JSObject>();
+        newthis->AddProperty("constructor", function_object);
+        js_this_ = newthis_wrapped;
+    } else if (IsMemberCall()) {
+        js_this_ = member_;
+        EndMemberCall();
+    } else {
+        SetThisGlobal();
+    }
+
+    auto ret = function->CallNative(Args, GetThis());
+    Flags = OldFlags;
+    js_this_ = Caller;
 
     if (IsConstructorCall()) {
-        js_this_ = TStack.Pop();
         EndedConstructorCall();
     } else if (IsMemberCall()) {
-        js_this_ = TStack.Pop();
+        EndMemberCall();
+    }
+    Stack.Push(ret);
+    SetFlags();
+}
+
+/// CallFastNative ::= calls a native of the fast calling convention with
+/// its arguments where they are on the stack. It runs no code of the VM,
+/// so no state is saved and no Argument object is created
+void VM::CallFastNative(Function *function, size_t count)
+{
+    std::shared_ptr<Handle> This;
+    if (IsMemberCall()) {
+        This = member_;
         EndMemberCall();
     } else {
-        js_this_ = TStack.Pop();
+        This = GetVStore(Context)->This();
     }
+
+    auto First = Stack.size() - count;
+    NativeArgs Args{ Stack.data() + First, count, std::move(This) };
+    auto ret = function->CallFastNative(Args);
+
+    // the arguments and the function
+    Stack.resize(First - 1);
     Stack.Push(ret);
     SetFlags();
 }
 
-bool VM::CallPrologue()
+/// CallPrologue ::= transfers the control to the function called with
+/// the arguments on the stack. The arguments are copied straight from the
+/// stack into the slots of the new frame, returns false if the function
+/// was a native which has already returned. A tail call reuses the frame
+/// of the running function, which must have been checked by CanTailCall()
+bool VM::CallPrologue(bool Tail)
 {
-    auto Args = CreateArgumentList(GetCurrent()->GetNumber());
-    auto F = Stack.Pop();
+    auto Count = static_cast<size_t>(GetCurrent()->GetNumber());
+    auto First = Stack.size() - Count;
+    auto F = Stack[First - 1].O;
 
-    SaveState();
-    if (!IsFunction(F.O))
+    if (Stack[First - 1].IsImmediate() || !F || !IsFunction(F))
         throw std::runtime_error("fatal: not a function");
 
-    auto TheFunction = F.O->as<Function>();
+    auto TheFunction = F->get<Function>();
+
+    // constructors always get the old calling convention
+    if (TheFunction->IsFastNative() && !IsConstructorCall()) {
+        CallFastNative(TheFunction, Count);
+        return false;
+    }
+
+    if (TheFunction->IsNative()) {
+        auto Args = CreateArgumentList(Count);
+        Stack.Pop();
+        CallNative(F, Args);
+        return false;
+    }
+
     TheFunction->PrepareFunction();
 
-    if (Flags & constructor_call) {
+    // the code of the running function may go away with its Callee, it
+    // isn't used after this
+    std::shared_ptr<Handle> Running;
+    if (Tail) {
+        Running = std::move(Frames.Top().Callee);
+        Locals.resize(frame_base_);
+        Loops.resize(Frames.Top().LoopsBase);
+        GetVStore(Context)->RemoveScope();
+    } else {
+        PushFrame(First - 1);
+    }
+    Frames.Top().Callee = F;
+
+    if (IsConstructorCall()) {
         auto newthis_wrapped = CreateJSObject();
 
         // we now copy the properties of the constuctor.prototype
         // native functions have to copy the properies by their own
         auto newthis = newthis_wrapped->as<JSObject>();
         // AddPropertiesFromPrototype(TheFunction.get(), newthis.get());
-        newthis->AddProperty("constructor", F.O);
-        TStack.Push(js_this_);
+        newthis->AddProperty("constructor", F);
         js_this_ = newthis_wrapped;
     } else if (IsMemberCall()) {
-        TStack.Push(js_this_);
         js_this_ = member_;
         EndMemberCall(); // original flags are not effected
     } else {
-        TStack.Push(js_this_);
         SetThisGlobal();
     }
 
-    if (TheFunction->IsNative()) {
-        CallNative(F.O, Args);
-        return false;
-    }
-
     EndedConstructorCall();
-    // all the variables for this function will lie in a new scope
-    auto V = GetVStore(Context);
-    V->CreateScope();
 
-    // initialize parameters of the function
-    auto Params = TheFunction->GetParams();
+    // initialize parameters of the function, i-th param lives in the
+    // i-th slot of the new frame
+    auto PSz = TheFunction->GetParamAtoms().size();
+    auto Sz = std::min(PSz, Count);
 
-    auto PSz = Params.size();
-    auto ASz = Args.size();
-    auto Sz = std::min(PSz, ASz);
+    if (!Tail)
+        frame_base_ = Locals.size();
+    Locals.resize(frame_base_ + std::max(PSz, TheFunction->GetFrameSize()));
 
-    for (auto i = decltype(Sz)(0); i < Sz; ++i) {
-        V->StoreValue(Params[i], Args[i]);
-    }
+    for (auto i = decltype(Sz)(0); i < Sz; ++i)
+        Locals[frame_base_ + i] = Stack[First + i].Copy();
+
+    while (PSz > Sz)
+        Locals[frame_base_ + Sz++] = CreateUndefinedObject();
 
-    while (PSz > Sz) {
-        V->StoreValue(Params[Sz++], CreateUndefinedObject());
+    // a function whose variables are captured gets a new environment for
+    // each call, the captured params share their handles with the slots
+    if (auto EnvSize = TheFunction->GetEnvSize()) {
+        env_ = CreateEnvironment(EnvSize, TheFunction->GetClosure());
+        auto Env = env_->get<Environment>();
+        for (const auto &Param : TheFunction->GetCapturedParams())
+            Env->Slot(Param.second) = Locals[frame_base_ + Param.first];
+    } else {
+        env_ = TheFunction->GetClosure();
     }
 
+    // the callee and its arguments, a tail call drops the stack of the
+    // running function too
+    Stack.resize(Tail ? Frames.Top().StackBase : First - 1);
+
+    // all the variables for this function will lie in a new scope, which
+    // finds the ones in the slots by the names of the slots
+    GetVStore(Context)->CreateScope(TheFunction->GetLocalNames(), Locals,
+        frame_base_);
+
     // now we are in position to transfer the control
     // to the function
     Current = TheFunction->GetAddress();
     End = TheFunction->GetEnd();
+
+#ifdef GROK_BASELINE_JIT
+    // hot functions run as machine code until they have returned
+    if (jit_threshold_ && jit_depth_ < MaxJitDepth) {
+        if (auto Compiled = TheFunction->GetHotCode(jit_threshold_))
+            RunCompiled(*Compiled);
+    }
+#endif
     return true;
 }
 
@@ -731,28 +1426,49 @@ void VM::EndMemberCall()
 
 void VM::CallOP()
 {
+    SafePoint();
     CallPrologue();
 }
 
+/// CanTailCall ::= the callee of tcall can take over the frame of the
+/// running function if both are plain calls of functions of the VM and
+/// no function refers to a variable of the running one by name
+bool VM::CanTailCall()
+{
+    if (Frames.empty() || !Frames.Top().Callee || IsConstructorCall()
+            || (Frames.Top().Flags & constructor_call)
+            || !GetVStore(Context)->CanDropScope())
+        return false;
+
+    auto Count = static_cast<size_t>(GetCurrent()->GetNumber());
+    auto &F = Stack[Stack.size() - Count - 1];
+    return F.IsCell() && F.O && IsFunction(F.O)
+        && !F.O->get<Function>()->IsNative();
+}
+
+/// TailCallOP ::= the running function is left by the call, its frame is
+/// reused so that recursion in tail position runs in constant space. When
+/// it can't be, this is a call and the `ret` after it returns
+void VM::TailCallOP()
+{
+    SafePoint();
+    CallPrologue(CanTailCall());
+}
+
 void VM::RetOP()
 {
     // save the returned result
     auto ReturnedValue = Stack.Pop();
     
-    auto V = GetVStore(Context);
-    std::shared_ptr<Handle> This;
     // we check that whether we called a constructor
     // if yes then we will save the object created on to stack
-    int32_t old_flags = FStack.Top();
-    if (old_flags & constructor_call) {
-        This = (GetThis());
-        js_this_ = TStack.Pop();
-    } else if (old_flags & member_call) {
-        js_this_ = TStack.Pop();
-    } else {
-        js_this_ = TStack.Pop();
-    }
-    RestoreState();
+    std::shared_ptr<Handle> This;
+    if (Frames.Top().Flags & constructor_call)
+        This = GetThis();
+
+    // drop the frame of the returning function
+    Locals.resize(frame_base_);
+    PopFrame();
 
     if (IsConstructorCall()) {
         Stack.Push(This);
@@ -764,7 +1480,7 @@ void VM::RetOP()
     if (IsMemberCall()) {
         EndMemberCall();
     }
-    V->RemoveScope();
+    GetVStore(Context)->RemoveScope();
     SetFlags();
 }
 
@@ -779,157 +1495,197 @@ void VM::PrintCurrentState()
     std::cout << (Flags & zero_flag ? "Z " : " ") << std::endl;
 }
 
-void VM::ExecuteInstruction(std::shared_ptr<Instruction> &instr)
+/// VM_HANDLER_LIST ::= member function executing each instruction, both
+/// dispatch loops are generated from this list
+#define VM_HANDLER_LIST(op) \
+    op(noop, NoOP) \
+    op(fetch, FetchOP) \
+    op(fetchl, FetchLocalOP) \
+    op(store, StoreOP) \
+    op(markst, MarkstOP) \
+    op(push, PushOP) \
+    op(pop, PopOP) \
+    op(pushim, PushimOP) \
+    op(pushthis, PushthisOP) \
+    op(poprop, PoppropOP) \
+    op(replprop, ReplpropOP) \
+    op(index, IndexOP) \
+    op(stidx, StoreIndexOP) \
+    op(updidx, UpdateIndexOP) \
+    op(res, ResOP) \
+    op(news, NewsOP) \
+    op(newsl, NewsLocalOP) \
+    op(fetche, FetchEnvOP) \
+    op(newse, NewsEnvOP) \
+    op(clos, ClosureOP) \
+    op(cpya, CpyaOP) \
+    op(maps, MapsOP) \
+    op(inc, IncOP) \
+    op(dec, DecOP) \
+    op(snot, SnotOP) \
+    op(bnot, BnotOP) \
+    op(pinc, PincOP) \
+    op(pdec, PdecOP) \
+    op(lts, LtsOP) \
+    op(ltes, LtesOP) \
+    op(gts, GtsOP) \
+    op(gtes, GtesOP) \
+    op(eqs, EqsOP) \
+    op(neqs, NeqsOP) \
+    op(adds, AddsOP) \
+    op(subs, SubsOP) \
+    op(muls, MulsOP) \
+    op(divs, DivsOP) \
+    op(shls, ShlsOP) \
+    op(shrs, ShrsOP) \
+    op(rems, RemsOP) \
+    op(bors, BorsOP) \
+    op(bands, BandsOP) \
+    op(ors, OrsOP) \
+    op(ands, AndsOP) \
+    op(xors, XorsOP) \
+    op(binr, BinaryRegisterOP) \
+    op(fetchp, FetchPushOP) \
+    op(fetchlp, FetchLocalPushOP) \
+    op(getprop, GetPropOP) \
+    op(getpropl, GetPropLocalOP) \
+    op(bini, BinaryImmediateOP) \
+    op(cmpjz, CompareJumpOP) \
+    op(binijz, BinaryImmediateJumpOP) \
+    op(binrjz, BinaryRegisterJumpOP) \
+    op(adds_dd, AddsDoubleOP) \
+    op(adds_ss, AddsStringOP) \
+    op(subs_dd, SubsDoubleOP) \
+    op(lts_dd, LtsDoubleOP) \
+    op(loopz, NoOP) \
+    op(enterl, EnterLoopOP) \
+    op(nextl, NextIterationOP) \
+    op(exitl, ExitLoopOP) \
+    op(jmp, JmpOP) \
+    op(call, CallOP) \
+    op(tcall, TailCallOP) \
+    op(ret, RetOP) \
+    op(jmpz, JmpzOP) \
+    op(jmpnz, JmpnzOP) \
+    op(mem_call, MarkCallOP) \
+    op(leave, LeaveOP)
+
+namespace {
+
+// the threaded dispatch indexes its labels with the kind of the
+// instruction, so the handlers must be in the order of the instructions
+constexpr Instructions HandlerKinds[] = {
+#define HANDLER_KIND(instr, Handler) Instructions::instr,
+VM_HANDLER_LIST(HANDLER_KIND)
+#undef HANDLER_KIND
+};
+
+constexpr size_t HandlerCount = sizeof(HandlerKinds) / sizeof(*HandlerKinds);
+
+constexpr bool HandlersInOrder()
+{
+    for (size_t i = 0; i < HandlerCount; i++) {
+        if (HandlerKinds[i] != static_cast<Instructions>(i))
+            return false;
+    }
+    return true;
+}
+
+static_assert(HandlerCount == Instructions::leave + 1,
+    "VM_HANDLER_LIST must have a handler for every instruction");
+static_assert(HandlersInOrder(),
+    "VM_HANDLER_LIST must be in the order of INSTRUCTION_LIST_FOR_EACH");
+
+}
+
+void VM::ExecuteInstruction(Bytecode *instr)
 {
     I = instr;
 
     if (debug_execution_)
         PrintCurrentState();
     switch (instr->GetKind()) {
-    case Instructions::noop:
-        NoOP();
-        break;
-    case Instructions::fetch:
-        FetchOP();
-        break;
-    case Instructions::store:
-        StoreOP();
-        break;
-    case Instructions::push:
-        PushOP();
-        break;
-    case Instructions::pop:
-        PopOP();
-        break;
-    case Instructions::pushim:
-        PushimOP();
-        break;
-    case Instructions::poprop:
-        PoppropOP();
-        break;
-    case Instructions::replprop:
-        ReplpropOP();
-        break;
-    case Instructions::index:
-        IndexOP();
-        break;
-    case Instructions::res:
-        ResOP();
-        break;
-    case Instructions::news:
-        NewsOP();
-        break;
-    case Instructions::cpya:
-        CpyaOP();
-        break;
-    case Instructions::maps:
-        MapsOP();
-        break;
-    case Instructions::lts:
-        LtsOP();
-        break;
-    case Instructions::gts:
-        GtsOP();
-        break;
-    case Instructions::ltes:
-        LtesOP();
-        break;
-    case Instructions::gtes:
-        GtesOP();
-        break;
-    case Instructions::eqs:
-        EqsOP();
-        break;
-    case Instructions::neqs:
-        NeqsOP();
-        break;
-    case Instructions::adds:
-        AddsOP();
-        break;
-    case Instructions::subs:
-        SubsOP();
-        break;
-    case Instructions::muls:
-        MulsOP();
-        break;
-    case Instructions::divs:
-        DivsOP();
-        break;
-    case Instructions::shls:
-        ShlsOP();
-        break;
-    case Instructions::shrs:
-        ShrsOP();
-        break;
-    case Instructions::rems:
-        RemsOP();
-        break;
-    case Instructions::bors:
-        BorsOP();
-        break;
-    case Instructions::bands:
-        BandsOP();
-        break;
-    case Instructions::ors:
-        OrsOP();
-        break;
-    case Instructions::ands:
-        AndsOP();
-        break;
-    case Instructions::xors:
-        XorsOP();
-        break;
-    case Instructions::loopz:
-        
-        break;
-    case Instructions::jmp:
-        JmpOP();
-        break;
-    case Instructions::call:
-        CallOP();
-        break;
-    case Instructions::ret:
-        RetOP();
-        break;
-    case Instructions::jmpz:
-        JmpzOP();
-        break;
-    case Instructions::leave:
-        LeaveOP();
-        break;
-    case Instructions::markst:
-        MarkstOP();
-        break;
-    case Instructions::pushthis:
-        PushthisOP();
-        break;
-    case Instructions::inc:
-        IncOP();
-        break;
-    case Instructions::dec:
-        DecOP();
-        break;
-    case Instructions::snot:
-        SnotOP();
-        break;
-    case Instructions::bnot:
-        BnotOP();
-        break;
-    case Instructions::pinc:
-        PincOP();
-        break;
-    case Instructions::pdec:
-        PdecOP();
-        break;
-    case Instructions::jmpnz:
-        JmpnzOP();
-        break;
-    case Instructions::mem_call:
-        MarkCallOP();
+#define HANDLER_CASE(instr, Handler)    \
+    case Instructions::instr:   \
+        Handler();  \
         break;
+VM_HANDLER_LIST(HANDLER_CASE)
+#undef HANDLER_CASE
+    }
+}
+
+#ifdef GROK_BASELINE_JIT
+/// JitStep ::= executes an instruction for the compiled code, exceptions
+/// can't unwind through the machine code so they are held by the VM until
+/// the compiled code has returned
+template <void (VM::*Handler)()>
+int VM::JitStep(VM *vm, Bytecode *instr)
+{
+    vm->Current = vm->I = instr;
+    if (vm->debug_execution_)
+        vm->PrintCurrentState();
+    try {
+        (vm->*Handler)();
+    } catch (...) {
+        vm->jit_error_ = std::current_exception();
+        return jit_error;
+    }
+    return vm->Current == instr ? jit_continue : jit_jump;
+}
+
+/// JitCall ::= calls the function and returns after the callee has
+/// returned, a callee which isn't compiled is interpreted here
+int VM::JitCall(VM *vm, Bytecode *instr)
+{
+    vm->Current = vm->I = instr;
+    if (vm->debug_execution_)
+        vm->PrintCurrentState();
+    try {
+        auto Depth = vm->Frames.size();
+        vm->CallOP();
+        while (vm->Frames.size() > Depth) {
+            vm->ExecuteInstruction(vm->Current);
+            ++vm->Current;
+        }
+    } catch (...) {
+        vm->jit_error_ = std::current_exception();
+        return jit_error;
+    }
+    return jit_continue;
+}
+
+JitStub VM::GetJitStub(int kind)
+{
+    // compiled code returns on the C++ stack, it can't leave its frame to
+    // the callee
+    if (kind == Instructions::call || kind == Instructions::tcall)
+        return &VM::JitCall;
+
+    switch (kind) {
+    default:
+        throw std::runtime_error("fatal: no stub for the instruction");
+#define JIT_STUB_CASE(instr, Handler)    \
+    case Instructions::instr:   \
+        return &VM::JitStep<&VM::Handler>;
+VM_HANDLER_LIST(JIT_STUB_CASE)
+#undef JIT_STUB_CASE
     }
 }
 
+void VM::RunCompiled(const JitCode &Compiled)
+{
+    jit_depth_++;
+    auto Status = Compiled.Run(this);
+    jit_depth_--;
+
+    if (Status == jit_error) {
+        auto Error = jit_error_;
+        jit_error_ = nullptr;
+        std::rethrow_exception(Error);
+    }
+}
+#endif
+
 void VM::HandleInterrupt()
 {
     if (IsInterruptAcknowledging()) {
@@ -956,19 +1712,82 @@ void VM::HandleInterrupt()
     ClearAck();
 }
 
+/// Interrupts and garbage collection are only polled at backward jumps
+/// and calls, every loop and every recursion passes through one of them
+void VM::SafePoint()
+{
+    // a handled interrupt runs other code which clobbers `I`
+    auto Saved = I;
+    if (Interrupt()) {
+        HandleInterrupt();
+    }
+    if (Heap::ShouldCollect()) {
+        Heap::Collect();
+    }
+    I = Saved;
+}
+
 void VM::Run()
+{
+    auto WasRunning = IsRunning();
+    SetBusy();
+    SafePoint();
+
+#ifdef GROK_THREADED_DISPATCH
+    if (threaded_)
+        RunThreaded();
+    else
+#endif
+        RunSwitch();
+
+    if (!WasRunning)
+        Flags &= ~is_running;
+}
+
+void VM::RunSwitch()
 {
     // main loop
     while (Current != End) {
-        SetBusy();
-        if (Interrupt()) {
-            HandleInterrupt();
-        }
-        ExecuteInstruction(*Current);
+        ExecuteInstruction(Current);
         ++Current;
     }
-    Flags &= ~is_running;
 }
 
+#ifdef GROK_THREADED_DISPATCH
+/// RunThreaded ::= same as RunSwitch but every handler jumps straight
+/// to the handler of the next instruction through a table of labels
+void VM::RunThreaded()
+{
+    static void *Labels[] = {
+#define HANDLER_LABEL(instr, Handler) &&do_##instr,
+VM_HANDLER_LIST(HANDLER_LABEL)
+#undef HANDLER_LABEL
+    };
+    static_assert(sizeof(Labels) / sizeof(*Labels) == Instructions::leave + 1,
+        "every instruction needs a label");
+
+#define DISPATCH()  \
+    do {    \
+        if (Current == End) \
+            return; \
+        I = Current;    \
+        if (debug_execution_)   \
+            PrintCurrentState();    \
+        goto *Labels[Current->GetKind()];   \
+    } while (0)
+
+    DISPATCH();
+
+#define HANDLER_BODY(instr, Handler)  \
+do_##instr: \
+    Handler();  \
+    ++Current;  \
+    DISPATCH();
+VM_HANDLER_LIST(HANDLER_BODY)
+#undef HANDLER_BODY
+#undef DISPATCH
+}
+#endif
+
 } // vm
 } // grok
@@ -5,6 +5,7 @@
 #include "vm/vm_interrupts.h"
 #include "vm/counter.h"
 #include "vm/var-store.h"
+#include "vm/jit.h"
 #include "common/generic-stack.h"
 #include "vm/context.h"
 #include "grok/context.h"
@@ -13,16 +14,34 @@
 #include <vector>
 #include <type_traits>
 
+namespace grok {
+namespace obj {
+class Function;
+class Environment;
+}
+}
+
 namespace grok {
 namespace vm {
 
 using VMStack = GenericStack<Value>;
-using CallStack = GenericStack<Counter>;
-using FlagStack = GenericStack<int32_t>;
 using PassedArguments = std::vector<Value>;
-using ThisStack = GenericStack<std::shared_ptr<grok::obj::Object>>;
-using VMStackHelper = GenericStack<VMStack::size_type>;
-using ThisStackHelper = GenericStack<ThisStack::size_type>;
+
+/// Frame ::= state of the caller saved by a call and restored when the
+/// callee returns, one record per call
+struct Frame {
+    Counter Return;     // the call instruction
+    Counter End;
+    int32_t Flags;
+    VMStack::size_type StackBase;   // stack without the callee and its args
+    std::vector<VMStack::size_type>::size_type LoopsBase;   // loops of the caller
+    LocalSlots::size_type LocalsBase;   // frame_base_ of the caller
+    std::shared_ptr<grok::obj::Object> This;    // `this` of the caller
+    std::shared_ptr<grok::obj::Object> Env;     // env_ of the caller
+    std::shared_ptr<grok::obj::Object> Callee;  // keeps its code alive
+};
+
+using FrameStack = GenericStack<Frame>;
 
 class VM;
 extern std::unique_ptr<VM> CreateVM(VMContext *context);
@@ -36,9 +55,14 @@ class VM {
 
     VM()
         : Context{ nullptr }, AC{ }, Current{ }, End{ },
-        Flags{ DEFAULT_VM_FLAG }, stack_level_{ 0 }, Stack{ }
+        Flags{ DEFAULT_VM_FLAG }, stack_level_{ 0 }, Stack{ },
+        Frames{ }, Locals{ }, frame_base_{ 0 }
     {
+        Frames.reserve(InitialFrames);
+        Locals.reserve(InitialFrames * 8);
         debug_execution_ = grok::GetContext()->DebugExecution();
+        threaded_ = grok::GetContext()->ThreadedDispatch();
+        jit_threshold_ = grok::GetContext()->JitThreshold();
     }
 
 public:
@@ -68,18 +92,29 @@ public:
     /// Run ::= run the VM
     void Run();
 
-    /// SaveState ::= saves the state i.e. flags and Counter
+    /// SafePoint ::= handles pending interrupts and collects garbage
+    void SafePoint();
+
+    /// SaveState ::= pushes a frame with the counters, flags, `this` and
+    /// the size of the stack
     void SaveState();
 
+    /// RestoreState ::= pops the frame pushed by SaveState
     void RestoreState();
 
-    inline auto GetCurrent()
+    inline Bytecode *GetCurrent()
     {
         return I;
     }
 
     /// ExecuteInstruction ::= Execute the given instruction
-    void ExecuteInstruction(std::shared_ptr<Instruction> &instr);
+    void ExecuteInstruction(Bytecode *instr);
+
+#ifdef GROK_BASELINE_JIT
+    /// GetJitStub ::= runtime stub which executes the instruction for
+    /// the compiled code
+    static JitStub GetJitStub(int kind);
+#endif
 
     /// GetThis ::= return the value of `this`
     std::shared_ptr<grok::obj::Object> GetThis();
@@ -127,16 +162,20 @@ public:
         member_ = obj;
     }
 private:
-    void IndexArray(std::shared_ptr<grok::obj::JSArray> arr,
-        std::shared_ptr<grok::obj::Object> obj);
+    void IndexArray(std::shared_ptr<grok::obj::JSArray> arr, Value idx);
     void IndexObject(std::shared_ptr<grok::obj::JSObject> obj,
-        std::shared_ptr<grok::obj::Object> idx);
+        std::shared_ptr<grok::obj::Object> idx, bool Store);
+    void Index(bool Store);
+    std::shared_ptr<grok::obj::Handle> LoadProperty(grok::obj::JSObject *obj,
+        grok::obj::Atom name);
     void PrintCurrentState();
     void SetAC(Value v);
     void NoOP();
     void FetchOP();
+    void FetchLocalOP();
     void StoreOP();
     void PushNumber(double number);
+    void PushInt32(int32_t number);
     void PushString(const std::string &str);
     void PushNull();
     void PushBool(bool boolean);
@@ -145,9 +184,17 @@ private:
     void PushimOP();
     void PoppropOP();
     void ReplpropOP();
+    void ReplaceByProperty(Value Object, grok::obj::Atom Name);
     void IndexOP();
+    void StoreIndexOP();
+    void UpdateIndexOP();
     void ResOP();
     void NewsOP();
+    void NewsLocalOP();
+    grok::obj::Environment *GetEnvironment(size_t hops);
+    void FetchEnvOP();
+    void NewsEnvOP();
+    void ClosureOP();
     void CpyaOP();
     void MapsOP();
     void SetFlags();
@@ -159,8 +206,14 @@ private:
     void JmpOP();
     void JmpzOP();
     void JmpnzOP();
+    void EnterLoopOP();
+    void NextIterationOP();
+    void ExitLoopOP();
     PassedArguments CreateArgumentList(size_t sz);
+    void PushFrame(VMStack::size_type stack_base);
+    void PopFrame();
     void CallOP();
+    void TailCallOP();
     void RetOP();
     void LeaveOP();
     void GtsOP();
@@ -176,6 +229,21 @@ private:
     void OrsOP();
     void AndsOP();
     void XorsOP();
+    void BinaryRegisterOP();
+    void BinaryOperator(int32_t Kind);
+    void FetchPushOP();
+    void FetchLocalPushOP();
+    void GetPropOP();
+    void GetPropLocalOP();
+    void BinaryImmediateOP();
+    void CompareJumpOP();
+    void BinaryImmediateJumpOP();
+    void BinaryRegisterJumpOP();
+    void AddsDoubleOP();
+    void AddsStringOP();
+    void SubsDoubleOP();
+    void LtsDoubleOP();
+    void RecordFeedback(int32_t Kind, uint8_t Types);
     void MarkstOP();
     void PushthisOP();
     void IncOP();
@@ -184,31 +252,68 @@ private:
     void BnotOP();
     void PincOP();
     void PdecOP();
+    void CallFastNative(grok::obj::Function *function, size_t count);
     void CallNative(std::shared_ptr<grok::obj::Handle> function,
             PassedArguments &Args);
-    bool CallPrologue();
+    bool CallPrologue(bool Tail = false);
+    bool CanTailCall();
     void MarkCallOP();
     bool IsMemberCall();
     void EndMemberCall();
 
+    void RunSwitch();
+#ifdef GROK_THREADED_DISPATCH
+    void RunThreaded();
+#endif
+
+#ifdef GROK_BASELINE_JIT
+    /// compiled code recurses on the C++ stack for every call, deeper calls
+    /// are interpreted
+    static constexpr size_t MaxJitDepth = 256;
+
+    template <void (VM::*Handler)()>
+    static int JitStep(VM *vm, Bytecode *instr);
+    static int JitCall(VM *vm, Bytecode *instr);
+    void RunCompiled(const JitCode &code);
+
+    std::exception_ptr jit_error_; // thrown by an instruction of a stub
+    size_t jit_depth_ = 0;
+#endif
+
     bool debug_execution_;
+    bool threaded_; // dispatch with computed goto
+    size_t jit_threshold_; // calls before a function is compiled
     VMContext *Context;
     Value AC;  // accumulator
     std::shared_ptr<grok::obj::Handle> js_this_;
+    std::shared_ptr<grok::obj::Handle> global_this_;
     std::shared_ptr<grok::obj::Handle> member_;
     Counter Current;  // current instruction being executed
     Counter Start;
     Counter End;  // end of the block
-    ThisStack TStack; // `this` of javascript
-    ThisStackHelper this_helper;
-    VMStackHelper HelperStack;
-    std::shared_ptr<Instruction> I; // current instruction
+    Bytecode *I; // current instruction
 
     int32_t Flags;  // flags for storing the VM state
     int32_t stack_level_;
     VMStack Stack;  // program stack
-    CallStack CStack;
-    FlagStack FStack;
+
+    // Frames ::= one record for each call which hasn't returned, reserved
+    // up front so that calls don't allocate until the recursion is deep
+    static constexpr size_t InitialFrames = 1024;
+    FrameStack Frames;
+
+    // Locals ::= slots of the variables resolved at code generation, each
+    // function call gets a frame at the end of it starting from frame_base_
+    LocalSlots Locals;
+    LocalSlots::size_type frame_base_;
+
+    // Loops ::= height of the stack when each running loop was entered,
+    // the loops of a call start at LoopsBase of its frame
+    std::vector<VMStack::size_type> Loops;
+
+    // env_ ::= environment of the running call, where the variables
+    // captured by closures live, nullptr if it has none
+    std::shared_ptr<grok::obj::Handle> env_;
 
     // RQ ::= runqueue
     IRQueue RQ;
@@ -7,7 +7,11 @@
 #include "lexer/lexer.h"
 #include "object/jsbasicobject.h"
 #include "object/argument.h"
+#include "object/atom.h"
 #include "object/function.h"
+#include "object/gc.h"
+#include "object/jsnumber.h"
+#include "object/pool.h"
 #include "parser/parser.h"
 #include "vm/codegen.h"
 #include "vm/context.h"
@@ -93,6 +97,27 @@ std::shared_ptr<grok::obj::Handle>
     return grok::obj::CreateUndefinedObject();
 }
 
+std::shared_ptr<grok::obj::Handle>
+    GCFreed(std::shared_ptr<grok::obj::Argument> args)
+{
+    return grok::obj::CreateJSNumber(
+        static_cast<double>(grok::obj::Heap::Freed()));
+}
+
+std::shared_ptr<grok::obj::Handle>
+    PoolChunks(std::shared_ptr<grok::obj::Argument> args)
+{
+    return grok::obj::CreateJSNumber(
+        static_cast<double>(grok::obj::ObjectPool::Chunks()));
+}
+
+std::shared_ptr<grok::obj::Handle>
+    AtomCount(std::shared_ptr<grok::obj::Argument> args)
+{
+    return grok::obj::CreateJSNumber(
+        static_cast<double>(grok::obj::AtomTable::Size()));
+}
+
 Test &Test::Prepare(std::string file)
 {
     file_ = file;
@@ -109,6 +134,15 @@ Test &Test::Prepare(std::string file)
     func = grok::obj::CreateFunction(AssertNotEqual);
     func->as<grok::obj::Function>()->SetParams({ "lhs", "rhs" });
     v->StoreValue("assert_not_equal", func);
+
+    func = grok::obj::CreateFunction(GCFreed);
+    v->StoreValue("gc_freed", func);
+
+    func = grok::obj::CreateFunction(PoolChunks);
+    v->StoreValue("pool_chunks", func);
+
+    func = grok::obj::CreateFunction(AtomCount);
+    v->StoreValue("atom_count", func);
     return *this;
 }
 
@@ -165,7 +199,8 @@ bool Test::StartTest(int32_t flags)
 
     try {
         auto vm = grok::vm::CreateVM(grok::vm::GetGlobalVMContext());
-        vm->SetCounters(IR->begin(), IR->end());
+        auto code = Assemble(*IR);
+        vm->SetCounters(code->begin(), code->end());
         
         vm->Run();
 
@@ -0,0 +1,46 @@
+// numbers produced on the VM stack are not boxed until they escape,
+// they must behave the same once they end up in variables, arrays,
+// objects or function arguments
+var a = 7;
+var b = 2;
+
+assert_equal(a / b, 3.5);
+assert_equal(a - b * 3, 1);
+assert_equal(a * b + 0.25, 14.25);
+
+// modulo always gives an integer and integers divide as integers,
+// storing an integer into a variable turns it into a double
+var c = a % b;
+assert_equal(c, 1);
+assert_equal(a % b, 1 % 2);
+assert_equal((7 % 4) / (5 % 3), 3 % 2);
+assert_equal((7 % 4) / 2, 1.5);
+
+var arr = [a + b, a * b, a - b];
+assert_equal(arr[0], 9);
+assert_equal(arr[1], 14);
+assert_equal(arr[2], 5);
+
+var obj = { x: a - 0.5, y: a < b };
+assert_equal(obj.x, 6.5);
+assert_equal(obj.y, 3 > 4);
+
+function Twice(n) {
+    n = n + n;
+    return n;
+}
+
+assert_equal(Twice(a + 1), 16);
+assert_equal(Twice(Twice(b)), 8);
+
+var sum = 0;
+var i = 0;
+for (i = 0; i < 10; i++) {
+    sum = sum + i;
+}
+assert_equal(sum, 45);
+assert_equal(i, 10);
+
+assert_equal(~5, -6);
+assert_equal(!0, 1);
+assert_equal(!a, 0);
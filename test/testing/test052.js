@@ -0,0 +1,67 @@
+// params and variables declared with var are read from frame slots, they
+// must still be visible by name to the functions called from there
+function Inner() {
+    return shared + 1;
+}
+
+function Outer(p) {
+    var shared = p * 2;
+    return Inner();
+}
+
+assert_equal(Outer(4), 9);
+
+function SetIt() {
+    counter = counter + 1;
+}
+
+function Count() {
+    var counter = 0;
+    SetIt();
+    SetIt();
+    return counter;
+}
+
+assert_equal(Count(), 2);
+
+// a name refers to the outer variable until its var statement runs
+var v = 5;
+function Shadow() {
+    var before = v;
+    var v = 1;
+    return before + v;
+}
+
+assert_equal(Shadow(), 6);
+assert_equal(v, 5);
+
+// every call gets its own frame
+function Fib(n) {
+    var a;
+    if (n < 2)
+        return n;
+    a = Fib(n - 1);
+    return a + Fib(n - 2);
+}
+
+assert_equal(Fib(10), 55);
+
+function Loop(n) {
+    var arr = [];
+    var i = 0;
+    for (i = 0; i < n; i++) {
+        var x = i * 2;
+        arr.push(x);
+    }
+    return arr;
+}
+
+var r = Loop(3);
+assert_equal(r.length, 3);
+assert_equal(r[2], 4);
+
+function Dup(a, a) {
+    return a;
+}
+
+assert_equal(Dup(1, 2), 2);
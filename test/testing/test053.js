@@ -0,0 +1,37 @@
+// objects built the same way share their layout, properties added to
+// one of them later must not show up in the others
+function Point(x, y) {
+    var p = { x: x, y: y };
+    return p;
+}
+
+var p = Point(1, 2);
+var q = Point(3, 4);
+p.z = 5;
+q.w = 6;
+assert_equal(p.x + p.y + p.z, 8);
+assert_equal(q.x + q.y + q.w, 13);
+assert_equal(p.hasOwnProperty("w"), 0);
+assert_equal(q.hasOwnProperty("z"), 0);
+
+// overwriting keeps the property in place
+p.x = 10;
+p.x = p.x + 1;
+assert_equal(p.x, 11);
+assert_equal(q.x, 3);
+
+// large objects leave the shared layouts
+var big = {};
+var i = 0;
+var sum = 0;
+while (i < 40) {
+    big["k" + i] = i;
+    i = i + 1;
+}
+i = 0;
+while (i < 40) {
+    sum = sum + big["k" + i];
+    i = i + 1;
+}
+assert_equal(sum, 780);
+assert_equal(big.k39, 39);
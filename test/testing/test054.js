@@ -0,0 +1,37 @@
+// one property access site seeing objects of many different layouts,
+// first a few (polymorphic) and then more than it caches (megamorphic)
+var objs = [{ x: 1 }, { a: 0, x: 2 }, { b: 0, x: 3 }, { c: 0, x: 4 },
+    { d: 0, x: 5 }, { e: 0, x: 6 }];
+var round = 0;
+var sum = 0;
+var i = 0;
+while (round < 3) {
+    i = 0;
+    while (i < 6) {
+        sum = sum + objs[i].x;
+        i = i + 1;
+    }
+    round = round + 1;
+}
+assert_equal(sum, 63);
+
+// a cached slot must give the current value of the property
+var o = { x: 1, y: 2 };
+var seen = 0;
+i = 0;
+while (i < 5) {
+    seen = seen + o.y;
+    o.y = o.y + 1;
+    i = i + 1;
+}
+assert_equal(seen, 20);
+
+// index sites see different names with the same layout
+var names = ["x", "y", "x", "y"];
+var total = 0;
+i = 0;
+while (i < 4) {
+    total = total + o[names[i]];
+    i = i + 1;
+}
+assert_equal(total, 16);
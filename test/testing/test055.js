@@ -0,0 +1,45 @@
+// cycles which become garbage are collected while the program runs,
+// objects still in use must survive every collection
+function Ring(n) {
+    var first = { value: 0 };
+    var last = first;
+    var k = 1;
+    while (k < n) {
+        var node = { value: k + 0, prev: last };
+        last.next = node;
+        last = node;
+        k = k + 1;
+    }
+    last.next = first;
+    first.prev = last;
+    first.self = first;
+    return first;
+}
+
+function Drop() {
+    var tmp = Ring(20);
+    return 0;
+}
+
+function Churn(rounds) {
+    var round = 0;
+    while (round < rounds) {
+        round = round + Drop() + 1;
+    }
+    return round;
+}
+
+var keep = Ring(10);
+assert_equal(Churn(400), 400);
+
+var sum = 0;
+var cur = keep;
+var i = 0;
+while (i < 10) {
+    sum = sum + cur.value;
+    cur = cur.next;
+    i = i + 1;
+}
+assert_equal(sum, 45);
+assert_equal(keep.prev.value, 9);
+assert_equal(keep.self.next.next.value, 2);
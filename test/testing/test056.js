@@ -0,0 +1,68 @@
+// arithmetic on params and locals of a function uses frame slots as
+// registers, both as operands and as the target of the assignment
+function Sum(n) {
+    var i = 0;
+    var s = 0;
+    while (i < n) {
+        s = s + i;
+        i = i + 1;
+    }
+    return s;
+}
+assert_equal(Sum(10), 45);
+assert_equal(Sum(0), 0);
+
+// numbers on either side and every kind of operator
+function Mix(a, b) {
+    var r = 0;
+    r = a * b;
+    r = r - 1;
+    r = 100 - r;
+    r = r % 7;
+    r = r << 2;
+    r = r | 1;
+    r = r ^ b;
+    r = r & 255;
+    return r + (a < b) + (a == a) + (b >= 4);
+}
+assert_equal(Mix(3, 4), 20);
+assert_equal(Mix(2.5, 2), 24);
+
+// value of an assignment is the assigned variable
+function Chain(a, b) {
+    var c = 0;
+    var d = (c = a + b) * 2;
+    return c + d;
+}
+assert_equal(Chain(2, 3), 15);
+
+// a variable declared in a branch may not exist yet, still works
+function Branch(x) {
+    if (x > 1) {
+        var y = 5;
+    }
+    if (x > 1) {
+        y = y + x;
+        return y;
+    }
+    return x + 1;
+}
+assert_equal(Branch(3), 8);
+assert_equal(Branch(0), 1);
+
+// redeclaring a variable starts from a new value
+function Again(n) {
+    var t = n + 1;
+    var u = t;
+    var t = n + 10;
+    return t + u;
+}
+assert_equal(Again(1), 13);
+
+// strings go through the same operators
+function Concat(a, b) {
+    var s = "";
+    s = a + b;
+    return s + a;
+}
+assert_equal(Concat("x", "y"), "xyx");
@@ -0,0 +1,44 @@
+// fused instructions must keep every jump landing where it did before
+var o = { n: 4, m: 3 };
+var total = 0;
+var i = 0;
+while (i < o.n) {
+    var j = 0;
+    while (j - o.m) {
+        total = total + (i > j ? i : j);
+        j = j + 1;
+    }
+    i = i + 1;
+}
+assert_equal(total, 22);
+
+// a jump may land right before the operator of a fused sequence
+var k = 0;
+var evens = 0;
+for (k = 0; k < 10; k = k + 1) {
+    if (k % 2 == 0)
+        evens = evens + 1;
+    else
+        evens = evens + 0;
+}
+assert_equal(evens, 5);
+
+var d = 0;
+do {
+    d = d + 3;
+} while (d < 10);
+assert_equal(d, 12);
+
+// same inside a function where locals are registers
+function Count(obj, limit) {
+    var c = 0;
+    var x = 0;
+    while (x < limit) {
+        if (x < obj.n)
+            c = c + obj.m;
+        x = x + 1;
+    }
+    return c;
+}
+assert_equal(Count(o, 10), 12);
+assert_equal(Count({ n: 0, m: 5 }, 3), 0);
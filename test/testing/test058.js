@@ -0,0 +1,49 @@
+// functions called often enough are compiled to machine code, results
+// must stay the same as those of the interpreter
+function fib(n) {
+    if (n < 2)
+        return n;
+    return fib(n - 1) + fib(n - 2);
+}
+assert_equal(fib(15), 610);
+
+// compiled loops, branches and property reads
+function Weigh(obj, n) {
+    var w = 0;
+    var i = 0;
+    while (i < n) {
+        if (i % 3 == 0)
+            w = w + obj.a;
+        else
+            w = w + obj.b;
+        i = i + 1;
+    }
+    return w;
+}
+var total = 0;
+var k = 0;
+while (k < 150) {
+    total = total + Weigh({ a: 2, b: 1 }, 6);
+    k = k + 1;
+}
+assert_equal(total, 1200);
+
+// compiled code calling a function which is still interpreted, and
+// native functions
+function Rare(x) {
+    return x * 10;
+}
+var seen = [];
+function Often(x) {
+    if (x == 149)
+        return Rare(x);
+    seen.push(x);
+    return seen.length;
+}
+var sum = 0;
+k = 0;
+while (k < 150) {
+    sum = sum + Often(k);
+    k = k + 1;
+}
+assert_equal(sum, 12665);
@@ -0,0 +1,42 @@
+// operators quickened for the types they have seen must give the same
+// results as the generic ones, also after the types change
+function Add(a, b) {
+    return a + b;
+}
+var n = 0;
+var i = 0;
+while (i < 20) {
+    n = Add(n, 0.5);
+    i = i + 1;
+}
+assert_equal(n, 10);
+assert_equal(Add("ab", "cd"), "abcd");
+assert_equal(Add(n, "x"), "10x");
+assert_equal(Add(1, 2), 3);
+
+// strings first, numbers after
+function Join(a, b) {
+    return a + b;
+}
+var s = "";
+i = 0;
+while (i < 5) {
+    s = Join(s, "z");
+    i = i + 1;
+}
+assert_equal(s, "zzzzz");
+assert_equal(Join(2.5, 2.5), 5);
+
+// quickened subtraction and comparison in a loop, then other operands
+function Down(x, limit) {
+    var c = 0;
+    while (limit < x) {
+        x = x - 1.5;
+        c = c + 1;
+    }
+    return c;
+}
+assert_equal(Down(9, 0), 6);
+// `%` gives an int, it misses the quickened comparison
+assert_equal(Down(9, 7 % 4), 4);
+assert_equal(Down(9, 3), 4);
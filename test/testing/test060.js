@@ -0,0 +1,44 @@
+// undefined and null are shared objects, every variable, element and
+// property holding them must still be assigned on its own
+var a = new Array(3);
+a[0] = 1;
+a[2] = "z";
+assert_equal(a[0], 1);
+assert_equal("" + a[1], "undefined");
+assert_equal(a[2], "z");
+
+var u;
+var v;
+u = 4;
+assert_equal(u, 4);
+assert_equal("" + v, "undefined");
+
+function Nothing(x) {
+    return x;
+}
+var r = Nothing();
+var q = Nothing();
+r = 5;
+assert_equal(r, 5);
+assert_equal("" + q, "undefined");
+
+// missing parameters are undefined, each in its own variable
+function Missing(x, y) {
+    x = 7;
+    return y;
+}
+assert_equal("" + Missing(), "undefined");
+
+var n = null;
+var m = null;
+n = 3;
+assert_equal(n, 3);
+assert_equal("" + m, "null");
+
+var w;
+var o = { p: null, q: w };
+o.p = 1;
+assert_equal(o.p, 1);
+assert_equal("" + o.q, "undefined");
+var o2 = { p: null };
+assert_equal("" + o2.p, "null");
@@ -0,0 +1,15 @@
+// strings have no own properties, toString and hasOwnProperty come from
+// the object prototype shared by every object
+var s = "ab" + "cd";
+assert_equal(s.toString(), "abcd");
+assert_equal(s.length, 4);
+assert_equal(s.hasOwnProperty("x"), 0);
+
+var parts = "x,yy,zzz".split(",");
+assert_equal(parts[1].toString(), "yy");
+assert_equal(parts[2].length, 3);
+assert_equal(parts[0] + parts[1], "xyy");
+
+var o = { a: 1 };
+assert_equal(o.hasOwnProperty("a"), 1);
+assert_equal(o.hasOwnProperty("toString"), 0);
@@ -0,0 +1,50 @@
+// names are interned, the same name must find the same property whether
+// it comes from the code, an object literal or a computed index
+var o = { alpha: 1, beta: 2 };
+assert_equal(o.alpha + o["beta"], 3);
+var key = "al" + "pha";
+assert_equal(o[key], 1);
+o["gam" + "ma"] = 3;
+assert_equal(o.gamma, 3);
+
+// a property which was never written is undefined, also for a name never
+// seen anywhere before
+assert_equal("" + o["never" + "seen"], "undefined");
+assert_equal(o.hasOwnProperty("never" + "seen"), 0);
+
+// nor is it added by reading it, also when the name has an atom already
+var p = { beta: 1 };
+assert_equal("" + p["al" + "pha"], "undefined");
+assert_equal(p.hasOwnProperty("alpha"), 0);
+
+// many properties make the object a dictionary
+var big = {};
+var i = 0;
+while (i < 40) {
+    big["p" + i] = i;
+    i = i + 1;
+}
+assert_equal(big.p0 + big.p39, 39);
+assert_equal(big["p" + 20], 20);
+
+// keys a dictionary gets at runtime aren't interned, code compiled later
+// which interns one of them still finds it
+var atoms = atom_count();
+i = 0;
+while (i < 1000) {
+    big["key" + i] = i;
+    i = i + 1;
+}
+assert_equal(atom_count(), atoms);
+assert_equal(big["key" + 999], 999);
+function Late() {
+    return big.key500;
+}
+assert_equal(Late(), 500);
+
+// parameters and variables are looked up by their atoms too
+function Shadow(alpha) {
+    var beta = alpha * 2;
+    return alpha + beta + o.beta;
+}
+assert_equal(Shadow(5), 17);
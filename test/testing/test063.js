@@ -0,0 +1,41 @@
+// long strings built by concatenation are ropes, they must behave like
+// flat strings wherever they are read
+var s = "";
+var i = 0;
+while (i < 2000) {
+    s = s + "ab" + i + ";";
+    i = i + 1;
+}
+assert_equal(s.length, 12890);
+assert_equal(s[0], "a");
+assert_equal(s[12889], ";");
+assert_equal(s.substr(0, 7), "ab0;ab1;");
+assert_equal(s.split(";").length, 2001);
+
+// a copy keeps its value when the original grows
+var r = s;
+s = s + "tail";
+assert_equal(r.length, 12890);
+assert_equal(s.length, 12894);
+assert_equal(s.substr(12890), "tail");
+
+// numbers on either side and strings compared after concatenation
+var t = "";
+i = 0;
+while (i < 300) {
+    t = 1 + t + 2;
+    i = i + 1;
+}
+assert_equal(t.length, 600);
+assert_equal(t.substr(298, 301), "1122");
+assert_equal(t == r, false);
+assert_equal(s.substr(0, 12889) == r, true);
+
+// joining many pieces
+var parts = [];
+i = 0;
+while (i < 500) {
+    parts.push("x");
+    i = i + 1;
+}
+assert_equal(parts.join("-").length, 999);
@@ -0,0 +1,58 @@
+// arrays of numbers keep raw doubles until something else is stored
+var a = [1, 2, 3];
+a[1] = 2.5;
+assert_equal(a.join("-"), "1-2.5-3");
+a[2] = "x";
+assert_equal(a.join("-"), "1-2.5-x");
+assert_equal(a.length, 3);
+
+// holes of `new Array(n)` read as undefined until they are filled
+var b = new Array(4);
+assert_equal("" + b[2], "undefined");
+var i = 0;
+while (i < 4) {
+    b[i] = i * i;
+    i = i + 1;
+}
+assert_equal(b.join(","), "0,1,4,9");
+var c = new Array(3);
+c[1] = 7;
+assert_equal(c.join(","), "undefined,7,undefined");
+
+// natives working on the raw doubles
+var d = [5, 1, 4, 2, 3];
+d.sort();
+assert_equal(d.join(""), "12345");
+d.sort(function(x, y) { return y - x; });
+assert_equal(d.join(""), "54321");
+d.reverse();
+d.push(9);
+d.push(0.5);
+assert_equal(d.join(" "), "1 2 3 4 5 9 0.5");
+assert_equal(d.pop(), 0.5);
+var e = d.map(function(x) { return x * 2; });
+assert_equal(e.join(" "), "2 4 6 8 10 18");
+
+// elements modified in place and stores out of range
+d[0]++;
+++d[1];
+assert_equal(d[0] + d[1], 5);
+d[10] = 3;
+assert_equal(d.length, 6);
+
+// numbers are copied into the array, not shared with the variable
+var x = 3;
+var m = [x, x];
+m[0] = 9;
+assert_equal(x, 3);
+assert_equal(m[1], 3);
+
+var f = [[1, 2], [3, 4]];
+f[1][0] = 8;
+assert_equal(f[1][0] + f[0][1], 10);
+var t = [1, 2, 3];
+var u = t[1] = 9;
+assert_equal(u, 9);
+t["2"] = 4;
+assert_equal(t[2], 4);
+assert_equal("" + [0.1, 1000000, -0], "0.1,1e+06,-0");
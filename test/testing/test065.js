@@ -0,0 +1,27 @@
+// numeric keys index arrays directly, strings of digits too, and other
+// strings are names of properties
+var a = ["a", "b", "c"];
+var i = 1;
+assert_equal(a[i], "b");
+assert_equal(a["2"], "c");
+assert_equal(a[2.5 - 0.5], "c");
+a[i] = "x";
+assert_equal(a.join(""), "axc");
+a["0"] = "y";
+assert_equal(a[0], "y");
+
+// elements out of range are properties, they don't change the length
+a[5] = "z";
+assert_equal(a[5], "z");
+assert_equal(a.length, 3);
+
+// names and static properties of arrays
+a["name"] = "list";
+assert_equal(a["name"], "list");
+assert_equal(a["join"]("-"), "y-x-c");
+assert_equal(a.length, 3);
+
+// objects are indexed by the string of the number
+var o = {};
+o[1] = "one";
+assert_equal(o["1"], "one");
@@ -0,0 +1,70 @@
+// typed arrays keep their elements in an ArrayBuffer, stores convert
+// numbers to the element type
+var f = new Float64Array(4);
+assert_equal(f.length, 4);
+assert_equal(f.byteLength, 32);
+assert_equal(f[3], 0);
+f[1] = 2.5;
+f[2] = "3";
+assert_equal(f.join(","), "0,2.5,3,0");
+
+var b = new Uint8Array(3);
+b[0] = 257;
+b[1] = -1;
+b[2] = 1.9;
+assert_equal(b.join(","), "1,255,1");
+
+var n = new Int32Array([1, 2, 4294967297]);
+assert_equal(n[2], 1);
+n[2] = 2147483648;
+assert_equal(n[2] + 2147483648, 0);
+n[2] = 3;
+assert_equal(n.BYTES_PER_ELEMENT, 4);
+
+// out of range reads are undefined and stores are dropped
+n[7] = 5;
+assert_equal("" + n[7], "undefined");
+assert_equal(n.length, 3);
+
+// elements are updated in place
+var i = 0;
+while (i < 3) {
+    b[i]++;
+    i = i + 1;
+}
+assert_equal(b.join(","), "2,0,2");
+assert_equal(++n[0], 2);
+assert_equal(n[1]--, 2);
+assert_equal(n.join(","), "2,1,3");
+
+// views of one buffer share the elements
+var buf = new ArrayBuffer(16);
+var whole = new Uint8Array(buf);
+var part = new Int32Array(buf, 4, 2);
+part[0] = 258;
+assert_equal(whole[4] + whole[5], 3);
+assert_equal(buf.byteLength, 16);
+var sub = whole.subarray(4, 6);
+sub[1] = 0;
+assert_equal(part[0], 2);
+assert_equal(part.buffer.byteLength, 16);
+
+// the buffer of a view can't be replaced
+var g = new Float64Array(4);
+g.buffer = 5;
+assert_equal(g.buffer.byteLength, 32);
+assert_equal(g.subarray(1).length, 3);
+
+// fill and set
+f.fill(1.5);
+f.set([7, 8], 2);
+assert_equal(f.join(","), "1.5,1.5,7,8");
+var copy = new Float64Array(f);
+f[0] = 0;
+assert_equal(copy[0], 1.5);
+
+// `++` on elements of plain arrays of numbers
+var a = [1, 2.5, 3];
+a[1]++;
+--a[2];
+assert_equal(a.join(","), "1,3.5,2");
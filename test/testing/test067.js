@@ -0,0 +1,64 @@
+// numeric methods of arrays and typed arrays run on the raw doubles,
+// lengths which aren't a multiple of the vector width need the tail too
+var a = [1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11];
+assert_equal(a.sum(), 66);
+assert_equal(a.min(), 1);
+assert_equal(a.max(), 11);
+assert_equal(a.dot(a), 506);
+assert_equal([].sum(), 0);
+assert_equal([].max() < 0, 1);
+
+// a NaN anywhere makes min and max NaN
+var m = [3, 1, 2, 5, 4];
+m[3] = "x";
+var lo = m.min();
+var hi = m.max();
+assert_equal(lo == lo, 0);
+assert_equal(hi == hi, 0);
+
+// scale and add work in place and return the array
+a.scale(0.5);
+assert_equal(a[10], 5.5);
+assert_equal(a.add(a).sum(), 66);
+assert_equal(a.join(","), "1,2,3,4,5,6,7,8,9,10,11");
+
+// holes stay holes when scaled
+var holey = new Array(3);
+holey[0] = 1;
+holey.scale(2);
+assert_equal(holey.join(","), "2,undefined,undefined");
+
+// fill stores numbers and other values
+var f = new Array(5);
+f.fill(2.5);
+assert_equal(f.sum(), 12.5);
+f.fill("s");
+f[0] = "t";
+assert_equal(f.join(""), "tssss");
+var b = [1, "x", 3];
+b.fill(3);
+b[0]++;
+assert_equal(b.join(","), "4,3,3");
+
+// arrays of other values are converted
+var g = ["1", 2, "3"];
+assert_equal(g.sum(), 6);
+g.scale(2);
+assert_equal(g.join(","), "2,4,6");
+
+// typed arrays, the integer ones convert what is stored
+var t = new Float64Array([0.5, 1.5, 2.5, 3.5, 4.5]);
+assert_equal(t.sum(), 12.5);
+assert_equal(t.dot([2, 2, 2, 2, 2]), 25);
+var u = new Uint8Array([250, 1, 2]);
+u.add([10, 10, 10]);
+assert_equal(u.join(","), "4,11,12");
+assert_equal(u.max(), 12);
+u.scale(3);
+assert_equal(u.sum(), 81);
+
+// overlapping views of one buffer
+var w = new Float64Array([1, 2, 3, 4, 5, 6]);
+var head = w.subarray(0, 5);
+w.subarray(1, 6).add(head);
+assert_equal(w.join(","), "1,3,5,7,9,11");
@@ -0,0 +1,43 @@
+// natives of the fast calling convention read their arguments from the
+// stack, the ones they keep must still be copies
+var a = [1, 2];
+assert_equal(a.push(3, 4.5), 4);
+assert_equal(a.join(","), "1,2,3,4.5");
+var x = "s";
+var o = { k: 1 };
+a.push(x, o);
+x = "t";
+assert_equal(a[4], "s");
+o.k = 2;
+assert_equal(a[5].k, 2);
+assert_equal(a.length, 6);
+
+// pop gives numbers back without a handle and undefined when empty
+var b = [7, 8.5];
+assert_equal(b.pop(), 8.5);
+assert_equal(b.pop() + 1, 8);
+assert_equal("" + b.pop(), "undefined");
+assert_equal(b.length, 0);
+
+// the pushed values are copies, the variable keeps its value
+var n = 5;
+b.push(n);
+b[0] = 6;
+assert_equal(n, 5);
+
+// string methods read `this` in place
+var s = "hello";
+assert_equal(s.charAt(1), "e");
+assert_equal(s.charAt(7), "");
+assert_equal(s.charAt(0 - 1), "");
+assert_equal(s.charCodeAt(4), 111);
+var i = 0;
+var t = "";
+while (i < 5) {
+    t = t + s.charAt(4 - i);
+    i = i + 1;
+}
+assert_equal(t, "olleh");
+
+// natives of the old convention still work next to them
+assert_equal([3, 1, 2].sort().join("-"), "1-2-3");
@@ -0,0 +1,54 @@
+// every call gets one frame, the arguments are taken from the stack in
+// place and `this` and the flags of the caller come back when it returns
+function Fib(n) {
+    if (n < 2)
+        return n;
+    return Fib(n - 1) + Fib(n - 2);
+}
+assert_equal(Fib(15), 610);
+
+// recursion deeper than the frames reserved up front
+function Depth(n) {
+    if (n == 0)
+        return 0;
+    return Depth(n - 1) + 1;
+}
+assert_equal(Depth(3000), 3000);
+
+// arguments are copies, missing ones are undefined and extra ones are
+// dropped with the callee
+function Bump(a, b) {
+    a = a + 1;
+    return "" + b;
+}
+var x = 1;
+assert_equal(Bump(x), "undefined");
+assert_equal(x, 1);
+assert_equal(Bump(x, 2, 3, 4), "2");
+
+// variables of the callers are still found by name
+function Callee() {
+    return p + q;
+}
+function Caller(p) {
+    var q = 10;
+    return Callee();
+}
+assert_equal(Caller(5), 15);
+
+// `this` of member calls and constructors is restored after nested calls
+var o = { v: 3 };
+o.get = function() { return this.v; };
+o.twice = function() {
+    var t = this.get();
+    return t + this.v;
+};
+assert_equal(o.twice(), 6);
+
+function Point(x, y) {
+    this.x = x;
+    this.y = Fib(y);
+}
+var pt = new Point(1, 10);
+assert_equal(pt.x + pt.y, 56);
+assert_equal(o.get(), 3);
@@ -0,0 +1,92 @@
+// variables captured by nested functions live in an environment of the
+// call, each closure keeps the one of the call which created it
+function Counter() {
+    var c = 0;
+    return function() {
+        c = c + 1;
+        return c;
+    };
+}
+var f = Counter();
+var g = Counter();
+assert_equal(f(), 1);
+assert_equal(f(), 2);
+assert_equal(g(), 1);
+assert_equal(f(), 3);
+
+// captured params, and variables captured two functions out
+function Adder(a) {
+    var b = 10;
+    return function(c) {
+        return function(d) {
+            return a + b + c + d;
+        };
+    };
+}
+assert_equal(Adder(1)(2)(3), 16);
+var add5 = Adder(5)(0);
+assert_equal(add5(1), 16);
+assert_equal(add5(2), 17);
+
+// a captured param is shared with the closure which updates it
+function Account(balance) {
+    function deposit(amount) {
+        balance = balance + amount;
+        return balance;
+    }
+    deposit(5);
+    return deposit;
+}
+var deposit = Account(100);
+assert_equal(deposit(10), 115);
+assert_equal(deposit(1), 116);
+
+// a nested function declaration calling itself through the environment
+function Factorial(n) {
+    function fact(k) {
+        if (k < 2)
+            return 1;
+        return k * fact(k - 1);
+    }
+    return fact(n);
+}
+assert_equal(Factorial(10), 3628800);
+
+// `var` is per function, the closures of a loop share the variable
+function Last() {
+    var fs = [];
+    var i;
+    for (i = 0; i < 3; i++) {
+        fs.push(function() { return i; });
+    }
+    return fs[0]() + fs[1]() + fs[2]();
+}
+assert_equal(Last(), 9);
+
+// closures of different calls don't share their variables, the one
+// declared by an inner function hides the one of the outer function
+function Pair(x) {
+    var get = function() { return x; };
+    var shadow = function() {
+        var x = "inner";
+        return x;
+    };
+    x = x * 2;
+    return get() + shadow();
+}
+assert_equal(Pair(2), "4inner");
+assert_equal(Pair(3), "6inner");
+
+// a nested function declaration is bound in its own call, the one made
+// by a recursive call doesn't replace the one of the caller
+function Outer(n) {
+    var k = n;
+    function get() {
+        return k;
+    }
+    if (n > 0) {
+        Outer(n - 1);
+    }
+    return get();
+}
+assert_equal(Outer(2), 2);
@@ -0,0 +1,66 @@
+// `return f(...)` leaves the frame of the running function to the callee,
+// recursion in tail position doesn't grow the stacks
+function Sum(n, acc) {
+    if (n == 0)
+        return acc;
+    return Sum(n - 1, acc + n);
+}
+assert_equal(Sum(100000, 0), 5000050000);
+
+// mutual recursion and callees taking a different number of arguments
+function IsEven(n) {
+    if (n == 0)
+        return 1;
+    return IsOdd(n - 1, "unused");
+}
+function IsOdd(n) {
+    if (n == 0)
+        return 0;
+    return IsEven(n - 1);
+}
+assert_equal(IsEven(100001), 0);
+assert_equal(IsOdd(100001), 1);
+
+// the result of a tail call to a native or a constructor is returned as
+// it would be by a call
+function Second(s) {
+    return s.charAt(1);
+}
+assert_equal(Second("abc"), "b");
+
+function Point(x) {
+    this.x = x;
+}
+function MakePoint(x) {
+    return new Point(x);
+}
+assert_equal(MakePoint(4).x, 4);
+
+// a constructor returns its object even if it ends with a tail call
+function Wrapper(x) {
+    this.x = x;
+    return Sum(x, 0);
+}
+var w = new Wrapper(3);
+assert_equal(w.x, 3);
+
+// the caller of a tail call gets `this` and its variables back
+function Outer() {
+    var before = 5;
+    var result = Sum(10, 0);
+    return before + result;
+}
+assert_equal(Outer(), 60);
+
+// closures can be tail called and call themselves in tail position
+function Loop(limit) {
+    var count = 0;
+    function step(i) {
+        count = count + 1;
+        if (i == limit)
+            return count;
+        return step(i + 1);
+    }
+    return step(1);
+}
+assert_equal(Loop(50000), 50000);
@@ -0,0 +1,61 @@
+// operators on literals are evaluated by the parser, the results are the
+// ones the operators would have produced when run
+var day = 24 * 60 * 60 * 1000;
+assert_equal(day, 86400000);
+assert_equal(7 / 2, 3.5);
+assert_equal(-(3 + 4), -7);
+assert_equal(2 + 3 * 4 - 10 / 5, 12);
+assert_equal("con" + "cat" + "enated", "concatenated");
+assert_equal(!0, 1);
+assert_equal(!"", 1);
+assert_equal(!"text", 0);
+assert_equal(~5, -6);
+
+// comparisons and bitwise operators give int32's, they are only folded
+// into the operators and the conditions using them
+assert_equal(1 < 2, 1);
+assert_equal("a" == "a", 1);
+assert_equal(7 % 3, 1);
+assert_equal(1 << 4, 16);
+assert_equal(6 & 3 | 8, 10);
+assert_equal((1 < 2) / ((1 < 2) + (1 < 2)), 0);
+assert_equal((2 >= 2) + 0.5, 1.5);
+
+// identities drop the operator only when the operand is a double
+function Negate(a) {
+    return !a * 1 - 0;
+}
+assert_equal(Negate(0), 1);
+assert_equal(Negate(4), 0);
+var n = 5;
+assert_equal(n * 1 - 0, 5);
+
+// branches a constant condition never takes are dropped
+var x = 2;
+if (1 < 2)
+    x = x + 1;
+else
+    x = 100;
+assert_equal(x, 3);
+
+if (0)
+    x = 50;
+while (1 > 2)
+    x = 7;
+var i;
+for (i = 3; 0; i++)
+    x = 9;
+assert_equal(x, 3);
+assert_equal(i, 3);
+assert_equal(1 ? "yes" : "no", "yes");
+assert_equal("" ? "yes" : "no", "no");
+
+// a branch declaring a variable is kept even if it never runs
+function Declares() {
+    var y = 1;
+    if (0) {
+        var z = 2;
+    }
+    return y;
+}
+assert_equal(Declares(), 1);
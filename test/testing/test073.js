@@ -0,0 +1,30 @@
+// objects referring to each other are freed by the collector once nothing
+// else refers to them, the pairs are created by a call so that no statement
+// value of the loop keeps them
+function Pair() {
+    var a = {};
+    var b = {};
+    a.y = b;
+    b.x = a;
+    return 0;
+}
+
+var before = gc_freed();
+var i = 0;
+for (i = 0; i < 50000; i++) {
+    Pair();
+}
+assert_equal(gc_freed() - before >= 50000, 1);
+
+// a loop at the top level drops the values its statements leave on the
+// stack, so the cycles it creates are freed too
+var a = 0;
+var b = 0;
+before = gc_freed();
+for (i = 0; i < 50000; i++) {
+    a = {};
+    b = {};
+    a.y = b;
+    b.x = a;
+}
+assert_equal(gc_freed() - before >= 50000, 1);
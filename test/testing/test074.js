@@ -0,0 +1,56 @@
+// loops drop the values their statements leave on the stack after every
+// iteration, values from before the loop and the results of calls made
+// inside it are kept
+var total = 0;
+var i = 0;
+var j = 0;
+for (i = 0; i < 10; i++) {
+    for (j = 0; j < 10; j++) {
+        total = total + 1;
+        if (j > 4)
+            total = total + 1;
+    }
+}
+assert_equal(total, 150);
+
+var n = 0;
+while (n < 5) {
+    var twice = n * 2;
+    n = n + 1;
+}
+assert_equal(twice, 8);
+
+var m = 0;
+do {
+    m = m + 3;
+    total = total - 1;
+} while (m < 9);
+assert_equal(m, 9);
+assert_equal(total, 147);
+
+// a function leaving its loops through return, also in tail position
+function Find(arr, x) {
+    var k = 0;
+    while (k < arr.length) {
+        if (arr[k] == x)
+            return k;
+        k = k + 1;
+    }
+    return -1;
+}
+
+function FindFrom(arr, x, from) {
+    var k = 0;
+    for (k = from; k < arr.length; k++) {
+        if (arr[k] == x)
+            return Find(arr, x);
+    }
+    return -1;
+}
+
+var found = 0;
+for (i = 0; i < 100; i++) {
+    found = found + Find([5, 6, 7], 7) + FindFrom([1, 2, 3], 2, 0);
+}
+assert_equal(found, 300);
+assert_equal(FindFrom([1, 2, 3], 9, 0), -1);
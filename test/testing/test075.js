@@ -0,0 +1,22 @@
+// small objects come from the chunks of the pool, a chunk is given back
+// once none of its blocks is in use anymore
+var before = pool_chunks();
+var keep = [];
+var i = 0;
+for (i = 0; i < 100000; i++) {
+    keep.push({ n: i, s: "x" + i });
+}
+var grown = pool_chunks();
+assert_equal(grown > before + 100, 1);
+assert_equal(keep[99999].s, "x99999");
+
+keep = 0;
+assert_equal(pool_chunks() < before + 20, 1);
+
+// freed blocks are reused by the next objects
+keep = [];
+for (i = 0; i < 100000; i++) {
+    keep.push({ n: i, s: "y" + i });
+}
+assert_equal(pool_chunks() <= grown, 1);
+assert_equal(keep[5].s, "y5");